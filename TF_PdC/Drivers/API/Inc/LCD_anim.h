@@ -0,0 +1,80 @@
+/*******************************************************************************
+* @file    LCD_anim.h
+* @author  Guillermo Caporaletti
+* @brief   Animaciones guardadas en flash, con cuadros por diferencias.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_ANIM_H
+#define LCD_ANIM_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+// Fila de un glifo de CGRAM que cambia (dirección = lugar * 8 + fila)
+typedef struct {
+	uint8_t address;
+	uint8_t bits;
+} LCDanimRow;
+
+// Posición de pantalla que cambia de caracter
+typedef struct {
+	uint8_t col;
+	uint8_t row;
+	uint8_t code;
+} LCDanimCell;
+
+// Cuadro: sólo lo que cambia respecto del cuadro anterior
+typedef struct {
+	uint16_t ms;					// Tiempo en pantalla
+	const LCDanimRow * rows;		// Filas de CGRAM (se envían primero)
+	uint8_t row_count;
+	const LCDanimCell * cells;		// Caracteres
+	uint8_t cell_count;
+} LCDanimFrame;
+
+typedef struct {
+	const LCDanimFrame * frames;
+	uint16_t frame_count;
+	uint16_t loop_from;				// Cuadro desde el que se repite, o LCD_ANIM_ONCE
+} LCDanimation;
+
+// Estado de una animación en curso (una variable por animación simultánea)
+typedef struct {
+	const LCDanimation * anim;
+	uint16_t frame;			// Cuadro en pantalla (o enviándose)
+	uint16_t next;			// Próximo cambio a enviar del cuadro
+	uint32_t start;			// Tick (ms) en que empezó el cuadro
+	bool sending;			// Quedan cambios del cuadro por enviar
+	bool playing;
+} LCDanimPlayer;
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_ANIM_ONCE		0xFFFF	// loop_from: no se repite
+#define LCD_ANIM_BUDGET		8		// Cambios enviados, a lo sumo, por llamada
+
+// Tiempo de una transferencia por el bus, sin la ejecución del controlador
+// (como en LCD_service). Sólo decide si entra un cambio más en el presupuesto.
+#define LCD_ANIM_TRANSFER_US	5
+
+// Cantidad de elementos de un arreglo de filas o de caracteres
+#define LCD_ANIM_COUNT(Arreglo)		((uint8_t) (sizeof(Arreglo) / sizeof((Arreglo)[0])))
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_animStart(LCDanimPlayer *, const LCDanimation *);
+bool LCD_animUpdate(LCDanimPlayer *);
+bool LCD_animUpdateBudget(LCDanimPlayer *, uint32_t);
+void LCD_animStop(LCDanimPlayer *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_ANIM_H */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,61 @@
+/*******************************************************************************
+* @file    LCD_bank.h
+* @author  Guillermo Caporaletti
+* @brief   Juegos de caracteres propios (bancos de CGRAM) empaquetados en flash.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_BANK_H
+#define LCD_BANK_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Un glifo de 8 filas de 5 puntos ocupa 40 bits: 5 bytes en lugar de 8
+#define LCD_GLYPH_BYTES		5
+
+// Empaqueta las 8 filas de un glifo (como las de LCD_createChar) al compilar
+#define LCD_GLYPH(a, b, c, d, e, f, g, h) { \
+	(uint8_t) ((((a) & 0x1F) << 3) | (((b) & 0x1F) >> 2)), \
+	(uint8_t) ((((b) & 0x1F) << 6) | (((c) & 0x1F) << 1) | (((d) & 0x1F) >> 4)), \
+	(uint8_t) ((((d) & 0x1F) << 4) | (((e) & 0x1F) >> 1)), \
+	(uint8_t) ((((e) & 0x1F) << 7) | (((f) & 0x1F) << 2) | (((g) & 0x1F) >> 3)), \
+	(uint8_t) ((((g) & 0x1F) << 5) | ((h) & 0x1F)) }
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef uint8_t LCDglyph[LCD_GLYPH_BYTES];
+
+// Banco: glifos que ocupan los lugares first a first + count - 1 de CGRAM
+typedef struct {
+	const LCDglyph * glyphs;
+	uint8_t first;
+	uint8_t count;
+} LCDglyphBank;
+
+typedef struct {
+	uint32_t loads;				// Cambios de banco
+	uint32_t rows_sent;			// Filas de CGRAM enviadas
+	uint32_t rows_skipped;		// Filas que ya estaban en CGRAM
+	uint32_t transfers;			// Transferencias del bus (filas y direcciones)
+	uint32_t transfers_full;	// Las que hubiera hecho LCD_createChar() con cada glifo
+} LCDbankStats;
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_bankLoad(const LCDglyphBank *);
+uint8_t LCD_bankCode(const LCDglyphBank *, uint8_t);
+void LCD_glyphUnpack(const LCDglyph, uint8_t[8]);
+uint16_t LCD_bankFlashSaved(const LCDglyphBank *);
+const LCDbankStats * LCD_bankStats(void);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_BANK_H */
+
+/***************************************************************END OF FILE****/
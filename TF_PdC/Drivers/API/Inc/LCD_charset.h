@@ -0,0 +1,43 @@
+/*******************************************************************************
+* @file    LCD_charset.h
+* @author  Guillermo Caporaletti
+* @brief   Traducción de texto UTF-8 a la ROM de caracteres del HD44780.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_CHARSET_H
+#define LCD_CHARSET_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+// ROM de caracteres de fábrica del HD44780 (ver pp. 17-18 de la hoja de datos)
+typedef enum {LCD_ROM_A00, LCD_ROM_A02} LCD_rom;
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Lugares de CGRAM que puede ocupar la traducción con glifos propios.
+// El lugar 0 queda libre para LCD_createChar() desde la aplicación.
+#define LCD_GLYPH_FIRST_SLOT	1
+#define LCD_GLYPH_LAST_SLOT		7
+
+// Caracter a mostrar cuando el código no existe ni en ROM ni como glifo
+#define LCD_CHARSET_UNKNOWN		'?'
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_charset(LCD_rom);
+void LCD_charsetReset(void);
+uint8_t LCD_translate(uint32_t);
+void LCD_printUTF8(const char *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_CHARSET_H */
+
+/***************************************************************END OF FILE****/
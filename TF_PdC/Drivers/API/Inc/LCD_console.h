@@ -0,0 +1,39 @@
+/*******************************************************************************
+* @file    LCD_console.h
+* @author  Guillermo Caporaletti
+* @brief   Consola de texto (estilo terminal) con salto de línea y scroll.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_CONSOLE_H
+#define LCD_CONSOLE_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Tamaño máximo de la consola (LCD_consoleInit falla si el display no entra)
+#ifndef LCD_CONSOLE_COLS
+#define LCD_CONSOLE_COLS	40
+#endif
+#ifndef LCD_CONSOLE_ROWS
+#define LCD_CONSOLE_ROWS	LCD_MAX_LINES
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+bool LCD_consoleInit(uint8_t, uint8_t);
+void LCD_consolePut(char);
+void LCD_consoleFlush(void);
+void LCD_consolePrint(const char *);
+void LCD_consoleClear(void);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_CONSOLE_H */
+
+/***************************************************************END OF FILE****/
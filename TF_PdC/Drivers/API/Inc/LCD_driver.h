@@ -1,171 +1,406 @@
-/*******************************************************************************
-* @file    API_LCD.h
-* @author  Guillermo Caporaletti
-* @brief   Controlador de LCD alimentado por HD44780.
-* ********************************************************************************
-*/
-
-/* Define to prevent recursive inclusion -------------------------------------*/
-
-#ifndef LCD_DRIVER_H
-#define LCD_DRIVER_H
-
-/* Includes ------------------------------------------------------------------*/
-
-#include <stdio.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include <string.h>
-#include "stm32f4xx_hal.h"  		/* <- HAL include */
-#include "stm32f4xx_nucleo_144.h" 	/* <- BSP include */
-#include "errorHandler.h"
-
-/* Types ---------------------------------------------------------------------*/
-
-typedef enum {WRITE_MODE, READ_MODE} io_mode;
-
-typedef struct {
-	uint32_t rs_pin;
-	uint32_t rw_pin;
-	uint32_t enable_pin;
-	uint16_t data_pins[8];
-
-	GPIO_TypeDef* rs_port;
-	GPIO_TypeDef* rw_port;
-	GPIO_TypeDef* enable_port;
-	GPIO_TypeDef* data_ports[8];
-
-	uint8_t displayfunction;
-	uint8_t displaycontrol;
-	uint8_t displaymode;
-
-	bool initialized;
-	bool fourbitmode;
-	io_mode rw_config;
-
-	uint8_t numlines;
-	uint8_t row_offsets[4];
-} LCDconfig;
-
-/* Exported macro ------------------------------------------------------------*/
-
-// commands
-#define LCD_CLEARDISPLAY 0x01
-#define LCD_RETURNHOME 0x02
-#define LCD_ENTRYMODESET 0x04
-#define LCD_DISPLAYCONTROL 0x08
-#define LCD_CURSORSHIFT 0x10
-#define LCD_FUNCTIONSET 0x20
-#define LCD_SETCGRAMADDR 0x40
-#define LCD_SETDDRAMADDR 0x80
-
-// flags for display entry mode
-#define LCD_ENTRYRIGHT 0x00
-#define LCD_ENTRYLEFT 0x02
-#define LCD_ENTRYSHIFTINCREMENT 0x01
-#define LCD_ENTRYSHIFTDECREMENT 0x00
-
-// flags for display on/off control
-#define LCD_DISPLAYON 0x04
-#define LCD_DISPLAYOFF 0x00
-#define LCD_CURSORON 0x02
-#define LCD_CURSOROFF 0x00
-#define LCD_BLINKON 0x01
-#define LCD_BLINKOFF 0x00
-
-// flags for display/cursor shift
-#define LCD_DISPLAYMOVE 0x08
-#define LCD_CURSORMOVE 0x00
-#define LCD_MOVERIGHT 0x04
-#define LCD_MOVELEFT 0x00
-
-// flags for function set
-#define LCD_8BITMODE 0x10
-#define LCD_4BITMODE 0x00
-#define LCD_2LINE 0x08
-#define LCD_1LINE 0x00
-#define LCD_5x10DOTS 0x04
-#define LCD_5x8DOTS 0x00
-
-// Modos de lectura/escritura de los pines
-#define LCD_WRITE GPIO_MODE_OUTPUT_OD	// Modo para escritura en LCD
-										// "Open drain" para compatibilidad con TTL 5V
-#define LCD_READ GPIO_MODE_INPUT		// Modo para lectura del LCD
-
-// Traducción de pines Arduino
-
-// Puertos de los pines
-#define ARDUINO_D0_port		GPIOG
-#define ARDUINO_D1_port		GPIOG
-#define ARDUINO_D2_port		GPIOF
-#define ARDUINO_D3_port		GPIOE
-#define ARDUINO_D4_port		GPIOF
-#define ARDUINO_D5_port		GPIOE
-#define ARDUINO_D6_port		GPIOE
-#define ARDUINO_D7_port		GPIOF
-#define ARDUINO_D8_port		GPIOF
-#define ARDUINO_D9_port		GPIOD
-#define ARDUINO_D10_port	GPIOD
-
-// Pines dentro de cada puerto
-#define ARDUINO_D0_pin		GPIO_PIN_9
-#define ARDUINO_D1_pin		GPIO_PIN_14
-#define ARDUINO_D2_pin		GPIO_PIN_15
-#define ARDUINO_D3_pin		GPIO_PIN_13
-#define ARDUINO_D4_pin		GPIO_PIN_14
-#define ARDUINO_D5_pin		GPIO_PIN_11
-#define ARDUINO_D6_pin		GPIO_PIN_9
-#define ARDUINO_D7_pin		GPIO_PIN_13
-#define ARDUINO_D8_pin		GPIO_PIN_12
-#define ARDUINO_D9_pin		GPIO_PIN_15
-#define ARDUINO_D10_pin		GPIO_PIN_14
-
-// Macros varios
-#define DISCONNECTED_PIN	NULL
-#define MAX_COUNT			0xFFFF
-#define LOW_COUNT			0x01FF
-
-/* Exported functions --------------------------------------------------------*/
-
-// Comandos de alto nivel
-void LCD_init();
-void LCD_clear();
-void LCD_home();
-void LCD_setCursor(uint8_t, uint8_t);
-void LCD_noDisplay();
-void LCD_display();
-void LCD_noCursor();
-void LCD_cursor();
-void LCD_noBlink();
-void LCD_blink();
-void LCD_scrollDisplayLeft();
-void LCD_scrollDisplayRight();
-void LCD_leftToRight();
-void LCD_rightToLeft();
-void LCD_autoscroll();
-void LCD_noAutoscroll();
-void LCD_createChar(uint8_t, uint8_t[]);
-void LCD_print(char *);
-
-// Funciones de nivel medio
-void LCD_write(uint8_t);
-void LCD_command(uint8_t);
-uint8_t LCD_data_read(void);
-uint8_t LCD_address_read(void);
-bool LCD_busy_flag(void);
-
-// Funciones de bajo nivel (llamadas a funciones HAL)
-void LCD_init_stm32f4xx(LCDconfig * LCD_a_configurar);
-void LCD_write_mode(LCDconfig * LCD_a_escribir);
-void LCD_read_mode(LCDconfig * LCD_a_leer);
-void pinMode(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint32_t Pin_Mode);
-void digitalWrite(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
-GPIO_PinState digitalRead(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
-void delayMilliseconds(uint32_t delay);
-void delayMicro(uint8_t Sticks);
-
-/* ---------------------------------------------------------------------------*/
-
-#endif /* LCD_DRIVER_H */
-
-/***************************************************************END OF FILE****/
+/*******************************************************************************
+* @file    API_LCD.h
+* @author  Guillermo Caporaletti
+* @brief   Controlador de LCD alimentado por HD44780.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_DRIVER_H
+#define LCD_DRIVER_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "stm32f4xx_hal.h"  		/* <- HAL include */
+#include "stm32f4xx_nucleo_144.h" 	/* <- BSP include */
+#include "errorHandler.h"
+
+/* Types ---------------------------------------------------------------------*/
+
+#define LCD_DDRAM_SIZE	0x68	// Direcciones 0x00 a 0x67
+#define LCD_CGRAM_SIZE	0x40	// Direcciones 0x00 a 0x3F
+#define LCD_DDRAM_CELLS	80		// Celdas de DDRAM (2 líneas de 40 o 1 de 80)
+#define LCD_GLYPH_ROWS	8		// Filas de CGRAM de cada caracter
+#define LCD_CONTROL_GROUPS	2	// Envíos de displaycontrol: sin el cursor y con él (ver LCD_send_pending)
+#ifndef LCD_PRINT_MAX
+#define LCD_PRINT_MAX	LCD_DDRAM_CELLS	// Caracteres de LCD_print: más se pisarían en DDRAM
+#endif
+#define LCD_MAX_DISPLAYS	4		// Displays en el mismo bus, cada uno con su ENABLE
+#define LCD_MAX_LINES		4		// Filas de pantalla (ver row_offsets)
+
+typedef enum {WRITE_MODE, READ_MODE} io_mode;
+
+// Perfil de tiempos del controlador (cada clon del HD44780 tiene los suyos)
+typedef struct {
+	uint16_t as_ns;			// RS y RW estables antes de subir E (tAS)
+	uint16_t pweh_ns;		// Ancho del pulso de E (PWEH)
+	uint16_t ddr_ns;		// Demora de los datos leídos (tDDR)
+	uint16_t h_ns;			// Datos estables luego de bajar E (tH)
+	uint16_t cycle_ns;		// Período de E (tcycE)
+	uint16_t exec_us;		// Ejecución de comandos y datos
+	uint16_t clear_us;		// Ejecución de clear y home
+	uint16_t seal;			// Verificación para guardarlo (ver LCD_timingSeal)
+} LCDtiming;
+
+typedef struct {
+	uint32_t rs_pin;
+	uint32_t rw_pin;
+	uint32_t enable_pin;
+	uint16_t data_pins[8];
+
+	GPIO_TypeDef* rs_port;
+	GPIO_TypeDef* rw_port;
+	GPIO_TypeDef* enable_port;
+	GPIO_TypeDef* data_ports[8];
+
+	// Displays que comparten datos, RS y RW, cada uno con su ENABLE
+	// (el display 0 es enable_port/enable_pin)
+	uint8_t displays;
+	GPIO_TypeDef* enable_ports[LCD_MAX_DISPLAYS];
+	uint16_t enable_pins[LCD_MAX_DISPLAYS];
+	uint8_t selected;						// Displays que reciben los pulsos (un bit por display)
+	uint8_t primary;						// El primero de ellos: del que se lee
+	GPIO_TypeDef* strobe_ports[LCD_MAX_DISPLAYS];	// ENABLE seleccionados, agrupados por puerto
+	uint16_t strobe_pins[LCD_MAX_DISPLAYS];
+	uint8_t strobe_groups;
+
+	uint8_t displayfunction;
+	uint8_t displaycontrol;
+	uint8_t displaymode;
+
+	bool initialized;
+	bool fourbitmode;
+	io_mode rw_config;
+
+	uint8_t numlines;
+	uint8_t numcols;
+	uint8_t row_offsets[LCD_MAX_LINES];
+
+	// Displays de dos controladores (40x4): cada fila va a un display (E1 o E2)
+	bool split;
+	uint8_t row_display[4];
+	uint8_t focus;			// Controlador con el cursor
+
+	uint8_t address[LCD_MAX_DISPLAYS];			// Contador de direcciones (AC) según lo que enviamos
+	bool cgram_selected[LCD_MAX_DISPLAYS];		// AC apunta a CGRAM (true) o DDRAM (false)
+
+	uint8_t ddram[LCD_MAX_DISPLAYS][LCD_DDRAM_SIZE];	// Copia en sombra de lo escrito en DDRAM
+	uint8_t cgram[LCD_MAX_DISPLAYS][LCD_CGRAM_SIZE];	// y en CGRAM
+	uint64_t cgram_known[LCD_MAX_DISPLAYS];		// Filas de CGRAM escritas (un bit por dirección)
+	uint8_t shift[LCD_MAX_DISPLAYS];			// Desplazamiento del display (posiciones a la izquierda)
+	uint8_t control_sent[LCD_MAX_DISPLAYS];		// displaycontrol y modo de escritura que tiene
+	uint8_t mode_sent[LCD_MAX_DISPLAYS];		// cada controlador
+
+	bool deferred;			// displaycontrol y modo se envían recién antes de otra cosa
+	bool control_pending;	// (ver LCD_deferControl)
+	bool mode_pending;
+
+	volatile uint32_t * rs_bb;		// Alias de bit-band de ODR de RS, RW y ENABLE
+	volatile uint32_t * rw_bb;		// y de IDR del pin de busy flag
+	volatile uint32_t * enable_bb;	// (ver LCD_bitbandInit)
+	volatile uint32_t * busy_bb;
+
+	volatile uint8_t * fmc;	// Banco del FMC con el display (ver LCD_FMC), o NULL: pines GPIO
+
+	LCDtiming timing;		// Tiempos en uso (ver LCD_setTiming)
+	uint32_t ready_at[LCD_MAX_DISPLAYS];	// Ciclo (DWT) a partir del cual cada uno acepta otro comando
+	uint32_t enable_rise;	// Ciclo del último flanco ascendente de E
+	uint32_t enable_fall;	// Ciclo del último flanco descendente de E
+
+	bool busy_event;				// clear y home terminan por interrupción (ver LCD_busyEvent)
+	volatile bool busy_armed;		// Esperando el flanco del busy flag, con E arriba
+	uint8_t busy_display;			// Display que se está esperando
+	void (*on_ready)(void);			// Aviso al terminar (desde la interrupción)
+} LCDconfig;
+
+// Ciclos por escritura de pin según el camino (ver LCD_strobeBenchmark)
+typedef struct {
+	uint32_t hal;			// HAL_GPIO_WritePin
+	uint32_t bsrr;			// Escritura directa de BSRR
+	uint32_t bitband;		// Alias de bit-band de ODR
+	uint32_t busy_flag;		// Un LCD_busy_flag() completo, con el camino compilado
+} LCDstrobeBench;
+
+// Velocidad del bus compilado, por GPIO o por FMC (ver LCD_busBenchmark)
+typedef struct {
+	uint32_t write_cycles;	// Ciclos de un LCD_write(), sin la espera de ejecución
+	uint32_t bytes_per_s;	// Bytes por segundo que podría enviar la CPU (sin esperas)
+	uint32_t text_bytes_per_s;	// Bytes por segundo de texto, con las esperas del display
+} LCDbusBench;
+
+/* Exported macro ------------------------------------------------------------*/
+
+// commands
+#define LCD_CLEARDISPLAY 0x01
+#define LCD_RETURNHOME 0x02
+#define LCD_ENTRYMODESET 0x04
+#define LCD_DISPLAYCONTROL 0x08
+#define LCD_CURSORSHIFT 0x10
+#define LCD_FUNCTIONSET 0x20
+#define LCD_SETCGRAMADDR 0x40
+#define LCD_SETDDRAMADDR 0x80
+
+// flags for display entry mode
+#define LCD_ENTRYRIGHT 0x00
+#define LCD_ENTRYLEFT 0x02
+#define LCD_ENTRYSHIFTINCREMENT 0x01
+#define LCD_ENTRYSHIFTDECREMENT 0x00
+
+// flags for display on/off control
+#define LCD_DISPLAYON 0x04
+#define LCD_DISPLAYOFF 0x00
+#define LCD_CURSORON 0x02
+#define LCD_CURSOROFF 0x00
+#define LCD_BLINKON 0x01
+#define LCD_BLINKOFF 0x00
+
+// flags for display/cursor shift
+#define LCD_DISPLAYMOVE 0x08
+#define LCD_CURSORMOVE 0x00
+#define LCD_MOVERIGHT 0x04
+#define LCD_MOVELEFT 0x00
+
+// flags for function set
+#define LCD_8BITMODE 0x10
+#define LCD_4BITMODE 0x00
+#define LCD_2LINE 0x08
+#define LCD_1LINE 0x00
+#define LCD_5x10DOTS 0x04
+#define LCD_5x8DOTS 0x00
+
+// Modos de lectura/escritura de los pines
+#define LCD_WRITE GPIO_MODE_OUTPUT_OD	// Modo para escritura en LCD
+										// "Open drain" para compatibilidad con TTL 5V
+#define LCD_READ GPIO_MODE_INPUT		// Modo para lectura del LCD
+
+// Traducción de pines Arduino
+
+// Puertos de los pines
+#define ARDUINO_D0_port		GPIOG
+#define ARDUINO_D1_port		GPIOG
+#define ARDUINO_D2_port		GPIOF
+#define ARDUINO_D3_port		GPIOE
+#define ARDUINO_D4_port		GPIOF
+#define ARDUINO_D5_port		GPIOE
+#define ARDUINO_D6_port		GPIOE
+#define ARDUINO_D7_port		GPIOF
+#define ARDUINO_D8_port		GPIOF
+#define ARDUINO_D9_port		GPIOD
+#define ARDUINO_D10_port	GPIOD
+#define ARDUINO_D11_port	GPIOA
+#define ARDUINO_D12_port	GPIOA
+#define ARDUINO_D13_port	GPIOA
+
+// Pines dentro de cada puerto
+#define ARDUINO_D0_pin		GPIO_PIN_9
+#define ARDUINO_D1_pin		GPIO_PIN_14
+#define ARDUINO_D2_pin		GPIO_PIN_15
+#define ARDUINO_D3_pin		GPIO_PIN_13
+#define ARDUINO_D4_pin		GPIO_PIN_14
+#define ARDUINO_D5_pin		GPIO_PIN_11
+#define ARDUINO_D6_pin		GPIO_PIN_9
+#define ARDUINO_D7_pin		GPIO_PIN_13
+#define ARDUINO_D8_pin		GPIO_PIN_12
+#define ARDUINO_D9_pin		GPIO_PIN_15
+#define ARDUINO_D10_pin		GPIO_PIN_14
+#define ARDUINO_D11_pin		GPIO_PIN_7
+#define ARDUINO_D12_pin		GPIO_PIN_6
+#define ARDUINO_D13_pin		GPIO_PIN_5
+
+// Macros varios
+#define DISCONNECTED_PIN	NULL
+
+// Alias de un bit de un registro de periférico en la región de bit-band
+// (Cortex-M4, ver PM0214): leer o escribir la palabra es leer o
+// escribir sólo ese bit, en un único acceso.
+#define LCD_BITBAND_ALIAS(reg, bit)	((volatile uint32_t *) (PERIPH_BB_BASE + ((((uint32_t) &(reg)) - PERIPH_BASE) * 32U) + ((bit) * 4U)))
+
+// Reloj del núcleo (el que fija SystemClock_Config) y conversión a ciclos
+#define LCD_CORE_CLOCK_HZ		180000000UL
+#define LCD_CYCLES_PER_US		(LCD_CORE_CLOCK_HZ / 1000000UL)
+#define LCD_NS_TO_CYCLES(ns)	((((uint32_t) (ns)) * LCD_CYCLES_PER_US + 999UL) / 1000UL)
+
+// Tiempos mínimos del HD44780 (columna de VCC = 2,7 a 4,5V de la hoja de datos,
+// que deja margen para los flancos lentos de la conexión open drain).
+// Forman el perfil LCD_timing_HD44780; otros clones tienen el suyo.
+#define LCD_T_AS_NS			60		// RS y RW estables antes de subir E
+#define LCD_T_PWEH_NS		450		// Ancho del pulso de E
+#define LCD_T_DSW_NS		195		// Datos estables antes de bajar E
+#define LCD_T_DDR_NS		360		// Demora de los datos leídos luego de subir E
+#define LCD_T_H_NS			20		// Datos, RS y RW estables luego de bajar E
+#define LCD_T_CYCLE_NS		1000	// Período de E
+#define LCD_T_EXEC_US		37		// Ejecución de comandos y datos
+#define LCD_T_CLEAR_US		1520	// Ejecución de clear y home
+#define LCD_T_SYNC1_US		4100	// Luego del primer function set de sincronización
+#define LCD_T_SYNC2_US		100		// Luego del segundo
+#define LCD_SYNC_WRITES		4		// Escrituras de la sincronización (3 en 8 bits, 4 en 4)
+
+// Medición de los caminos de acceso a pines (ver LCD_strobeBenchmark)
+#define LCD_BENCH_ROUNDS	64
+
+// Bus FMC (compilando con LCD_FMC): el display se ve como una SRAM de 8 bits
+// en el banco 1 (NE1). RS va en A0 y RW en A1, de modo que cada byte enviado o
+// leído es un único acceso a memoria, y el FMC arma el pulso de E.
+#ifndef LCD_FMC_BASE
+#define LCD_FMC_BASE		0x60000000UL	// (en la PC, el modelo pone memoria común)
+#endif
+#define LCD_FMC_RS			0x01	// A0: dato (1) o instrucción (0)
+#define LCD_FMC_RW			0x02	// A1: lectura (1) o escritura (0)
+#define LCD_FMC_ADDSET_MAX	15		// Límites de los campos de FMC_BTR1 (en ciclos de HCLK)
+#define LCD_FMC_DATAST_MAX	255
+#define LCD_FMC_BUSTURN_MAX	15
+
+/* Exported constants --------------------------------------------------------*/
+
+// Perfiles de tiempos conocidos
+extern const LCDtiming LCD_timing_HD44780;
+extern const LCDtiming LCD_timing_KS0066;
+extern const LCDtiming LCD_timing_ST7066U;
+extern const LCDtiming LCD_timing_SPLC780;
+
+/* Exported functions --------------------------------------------------------*/
+
+// Comandos de alto nivel
+void LCD_init();
+void LCD_clear();
+void LCD_home();
+void LCD_setCursor(uint8_t, uint8_t);
+void LCD_noDisplay();
+void LCD_display();
+void LCD_noCursor();
+void LCD_cursor();
+void LCD_noBlink();
+void LCD_blink();
+void LCD_scrollDisplayLeft();
+void LCD_scrollDisplayRight();
+void LCD_leftToRight();
+void LCD_rightToLeft();
+void LCD_autoscroll();
+void LCD_noAutoscroll();
+void LCD_deferControl(bool);
+void LCD_flush(void);
+void LCD_createChar(uint8_t, const uint8_t[]);
+void LCD_glyphRow(uint8_t, uint8_t);
+void LCD_print(const char *);
+void LCD_printn(const char *, size_t);
+void LCD_printSpan(const char *, size_t, size_t, size_t);
+void LCD_printScreen(const char * const []);
+
+// Funciones de nivel medio
+void LCD_write(uint8_t);
+void LCD_command(uint8_t);
+uint8_t LCD_data_read(void);
+uint8_t LCD_address_read(void);
+bool LCD_busy_flag(void);
+void LCD_setTiming(const LCDtiming *);
+const LCDtiming * LCD_getTiming(void);
+uint8_t LCD_entryMode(void);
+void LCD_timingSeal(LCDtiming *);
+bool LCD_timingValid(const LCDtiming *);
+uint8_t LCD_address(void);
+uint8_t LCD_cellAddress(uint8_t, uint8_t);
+uint8_t LCD_cellDisplay(uint8_t, uint8_t);
+uint8_t LCD_rowOrder(uint8_t[LCD_MAX_LINES]);
+uint8_t LCD_cellShadow(uint8_t, uint8_t);
+uint8_t LCD_cellVisible(uint8_t, uint8_t);
+uint8_t LCD_scrolledAddress(uint8_t, uint8_t, int8_t);
+bool LCD_cursorShown(uint8_t, uint8_t);
+bool LCD_cursorAt(uint8_t, uint8_t);
+bool LCD_cgramSelected(void);
+bool LCD_canRead(void);
+uint32_t LCD_readyIn(void);
+uint8_t LCD_shadow(uint8_t);
+uint8_t LCD_cgramShadow(uint8_t);
+bool LCD_cgramKnown(uint8_t);
+uint8_t LCD_nextAddress(uint8_t);
+uint8_t LCD_displays(void);
+void LCD_select(uint8_t);
+uint8_t LCD_selected(void);
+uint8_t LCD_addressOf(uint8_t);
+bool LCD_cgramSelectedOf(uint8_t);
+uint8_t LCD_shadowOf(uint8_t, uint8_t);
+uint8_t LCD_cgramShadowOf(uint8_t, uint8_t);
+uint8_t LCD_columns(void);
+uint8_t LCD_lines(void);
+void LCD_busyEvent(bool);
+bool LCD_busyPending(void);
+void LCD_onReady(void (*)(void));
+void LCD_busyIrq(void);
+bool LCD_lost(void);
+void LCD_restore(void);
+bool LCD_recover(void);
+void LCD_resync(void);
+
+// Funciones de bajo nivel (llamadas a funciones HAL)
+void LCD_init_stm32f4xx(LCDconfig * LCD_a_configurar);
+void LCD_write_mode(LCDconfig * LCD_a_escribir);
+void LCD_read_mode(LCDconfig * LCD_a_leer);
+void pinMode(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint32_t Pin_Mode);
+void digitalWrite(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState digitalRead(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void LCD_bitbandInit(LCDconfig * LCD_a_configurar);
+void LCD_busyIrqInit(LCDconfig * LCD_a_esperar);
+void LCD_busyIrqArm(LCDconfig * LCD_a_esperar);
+void LCD_busyIrqDisarm(LCDconfig * LCD_a_esperar);
+void LCD_strobeBenchmark(LCDstrobeBench * Resultado);
+void LCD_busBenchmark(LCDbusBench * Resultado);
+void LCD_fmcInit(LCDconfig * LCD_a_configurar);
+void LCD_fmcTiming(const LCDtiming * Perfil);
+void fmcWrite(volatile uint8_t * Banco, uint8_t Direccion, uint8_t Valor);
+uint8_t fmcRead(volatile uint8_t * Banco, uint8_t Direccion);
+void delayMilliseconds(uint32_t delay);
+void delayMicro(uint8_t Sticks);
+void delayMicroseconds(uint32_t us);
+void delayNanoseconds(uint32_t ns);
+void delayCycles(uint32_t Ciclos);
+void LCD_cycleCounterInit(void);
+uint32_t LCD_cycles(void);
+
+/*******************************************************************************
+* @brief  Escribe un pin suelto (ENABLE, RS o RW)
+* @param  Alias de bit-band, Puerto, Pin del puerto y Estado de salida
+* @retval None
+* @note   Compilando con LCD_BITBAND es una sola escritura en la región de
+*         bit-band; si no (o con LCD_TRACE, para que quede registrado), es
+*         digitalWrite().
+*/
+static inline void strobeWrite(volatile uint32_t * Alias, GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+#if defined(LCD_BITBAND) && !defined(LCD_TRACE)
+	(void) GPIOx;
+	(void) GPIO_Pin;
+	*Alias = (uint32_t) PinState;
+#else
+	(void) Alias;
+	digitalWrite(GPIOx, GPIO_Pin, PinState);
+#endif
+}
+
+/*******************************************************************************
+* @brief  Lee un pin suelto (busy flag)
+* @param  Alias de bit-band, Puerto y Pin del puerto
+* @retval Estado del pin
+* @note   Igual que strobeWrite(), con digitalRead().
+*/
+static inline GPIO_PinState strobeRead(volatile uint32_t * Alias, GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+#if defined(LCD_BITBAND) && !defined(LCD_TRACE)
+	(void) GPIOx;
+	(void) GPIO_Pin;
+	return (GPIO_PinState) *Alias;
+#else
+	(void) Alias;
+	return digitalRead(GPIOx, GPIO_Pin);
+#endif
+}
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_DRIVER_H */
+
+/***************************************************************END OF FILE****/
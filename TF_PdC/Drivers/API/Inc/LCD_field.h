@@ -0,0 +1,45 @@
+/*******************************************************************************
+* @file    LCD_field.h
+* @author  Guillermo Caporaletti
+* @brief   Campos de pantalla (valor, unidad, estado) con detección de cambios.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_FIELD_H
+#define LCD_FIELD_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef enum {LCD_ALIGN_LEFT, LCD_ALIGN_RIGHT, LCD_ALIGN_CENTER} LCD_align;
+
+// Escribe Valor como texto en Texto (de a lo sumo Largo-1 caracteres)
+typedef void (*LCD_formatter)(char * Texto, size_t Largo, int32_t Valor);
+
+typedef int8_t LCD_field;
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_FIELD_MAX		16		// Campos registrados a la vez
+#define LCD_FIELD_WIDTH		20		// Ancho máximo de un campo
+#define LCD_FIELD_NONE		(-1)	// Campo inválido (registro lleno)
+
+/* Exported functions --------------------------------------------------------*/
+
+LCD_field LCD_fieldAdd(uint8_t, uint8_t, uint8_t, LCD_align, LCD_formatter);
+void LCD_fieldLabel(uint8_t, uint8_t, const char *);
+void LCD_fieldText(LCD_field, const char *);
+void LCD_fieldValue(LCD_field, int32_t);
+void LCD_fieldUpdate(void);
+void LCD_fieldReset(void);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_FIELD_H */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,31 @@
+/*******************************************************************************
+* @file    LCD_mirror.h
+* @author  Guillermo Caporaletti
+* @brief   Misma pantalla en varios displays que comparten el bus.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_MIRROR_H
+#define LCD_MIRROR_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_MIRROR_ALL	0xFF	// Todos los displays conectados
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_mirrorPrint(uint8_t, uint8_t, uint8_t, const char *);
+void LCD_mirrorWrite(uint8_t, uint8_t, uint8_t, uint8_t);
+void LCD_mirrorCopy(uint8_t, uint8_t);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_MIRROR_H */
+
+/***************************************************************END OF FILE****/
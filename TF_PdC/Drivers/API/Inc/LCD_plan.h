@@ -0,0 +1,65 @@
+/*******************************************************************************
+* @file    LCD_plan.h
+* @author  Guillermo Caporaletti
+* @brief   Actualización de pantalla por el camino más barato según el bus.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_PLAN_H
+#define LCD_PLAN_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Desplazamientos del display que se prueban hacia cada lado
+#define LCD_PLAN_MAX_SCROLL		8
+
+/* Types ---------------------------------------------------------------------*/
+
+// Costo de cada operación del bus, en nanosegundos
+typedef struct {
+	uint32_t bus_ns;		// Transferencia de un byte (comando o dato)
+	uint32_t exec_ns;		// Ejecución de un comando o dato
+	uint32_t clear_ns;		// Ejecución de clear y home
+	uint32_t poll_ns;		// Lectura del busy flag por instrucción (0 con tiempos fijos)
+} LCDplanCost;
+
+typedef enum {
+	LCD_PLAN_DIFF,			// Sólo lo distinto, sobre lo que ya está
+	LCD_PLAN_SCROLL,		// Desplazar el display y luego lo distinto
+	LCD_PLAN_HOME,			// Volver el desplazamiento con home y luego lo distinto
+	LCD_PLAN_CLEAR			// Borrar y luego lo que no es espacio
+} LCDplanKind;
+
+typedef struct {
+	LCDplanKind kind;
+	int8_t scroll;			// Desplazamientos (LCD_PLAN_SCROLL): positivos a la izquierda
+	uint16_t writes;		// Datos a enviar, incluidos los iguales que evitan una dirección
+	uint16_t jumps;			// Direcciones a enviar
+	uint32_t cost_ns;		// Tiempo estimado
+} LCDplan;
+
+/* Exported constants --------------------------------------------------------*/
+
+extern const LCDplanCost LCD_plan_4bit;			// Bus de 4 bits con tiempos fijos
+extern const LCDplanCost LCD_plan_8bit;			// Bus de 8 bits con tiempos fijos
+extern const LCDplanCost LCD_plan_4bit_busy;	// Bus de 4 bits esperando el busy flag
+extern const LCDplanCost LCD_plan_i2c_100k;		// Expansor PCF8574 por I2C a 100 kHz
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_planCostInit(LCDplanCost *, uint32_t, uint32_t);
+void LCD_planMake(const char * const [], const LCDplanCost *, LCDplan *);
+void LCD_planRun(const char * const [], const LCDplan *);
+uint32_t LCD_planUpdate(const char * const [], const LCDplanCost *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_PLAN_H */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,63 @@
+/*******************************************************************************
+* @file    LCD_queue.h
+* @author  Guillermo Caporaletti
+* @brief   Acceso al LCD desde varias tareas (RTOS): cola de operaciones sin
+*          bloqueo y cuadro compartido, consumidos por una única tarea.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_QUEUE_H
+#define LCD_QUEUE_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_QUEUE_SIZE		32		// Operaciones en espera (potencia de 2)
+#define LCD_QUEUE_TEXT		20		// Caracteres por operación de texto
+
+// Tamaño máximo del cuadro compartido: se usa la geometría del display
+// (LCD_queueInit falla si no entra)
+#ifndef LCD_FRAME_COLS
+#define LCD_FRAME_COLS		40
+#endif
+#ifndef LCD_FRAME_ROWS
+#define LCD_FRAME_ROWS		LCD_MAX_LINES
+#endif
+
+// Aviso a la tarea del display luego de encolar (por ejemplo, con FreeRTOS:
+// #define LCD_QUEUE_SIGNAL() xTaskNotifyGive(tarea_lcd)). No debe bloquear.
+#ifndef LCD_QUEUE_SIGNAL
+#define LCD_QUEUE_SIGNAL()
+#endif
+
+// Aviso desde la interrupción cuando termina un clear o home esperado por
+// interrupción (ver LCD_busyEvent), por ejemplo vTaskNotifyGiveFromISR().
+#ifndef LCD_QUEUE_SIGNAL_FROM_ISR
+#define LCD_QUEUE_SIGNAL_FROM_ISR()
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+// Desde cualquier tarea (nunca esperan al bus)
+bool LCD_queueCommand(uint8_t);
+bool LCD_queuePrint(uint8_t, uint8_t, const char *);
+bool LCD_queueChar(uint8_t, const uint8_t[8]);
+uint32_t LCD_queueDropped(void);
+void LCD_frameSet(uint8_t, uint8_t, uint8_t);
+void LCD_framePrint(uint8_t, uint8_t, const char *);
+void LCD_frameRelease(void);
+
+// Sólo desde la tarea del display
+bool LCD_queueInit(void);
+uint16_t LCD_queueService(uint16_t);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_QUEUE_H */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,49 @@
+/*******************************************************************************
+* @file    LCD_scrub.h
+* @author  Guillermo Caporaletti
+* @brief   Verificación de DDRAM contra la copia en sombra, en segundo plano.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_SCRUB_H
+#define LCD_SCRUB_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef struct {
+	uint32_t checked;	// Celdas leídas
+	uint32_t errors;	// Celdas distintas a la sombra
+	uint32_t repaired;	// Celdas corregidas (verificadas con una nueva lectura)
+	uint32_t failed;	// Celdas que siguieron mal luego de corregirlas
+	uint32_t passes;	// Recorridos completos de DDRAM
+} LCDscrubStats;
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Cada transferencia cuesta la ejecución del perfil en uso (LCD_getTiming)
+// más este tiempo de bus. Verificar una celda es una transferencia (una
+// lectura de RAM), corregirla son cuatro (dirección, escritura, dirección y
+// relectura), y cada llamada tiene dos de costo fijo (la dirección de la
+// tanda y la vuelta del AC). El tiempo gastado se mide con el contador de
+// ciclos; esto sólo decide si entra una celda más.
+#define LCD_SCRUB_TRANSFER_US			5
+#define LCD_SCRUB_REPAIR_TRANSFERS		4
+#define LCD_SCRUB_OVERHEAD_TRANSFERS	2
+
+/* Exported functions --------------------------------------------------------*/
+
+uint16_t LCD_scrub(uint32_t);
+const LCDscrubStats * LCD_scrubStats(void);
+void LCD_scrubStatsReset(void);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_SCRUB_H */
+
+/***************************************************************END OF FILE****/
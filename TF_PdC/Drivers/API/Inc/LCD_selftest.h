@@ -0,0 +1,49 @@
+/*******************************************************************************
+* @file    LCD_selftest.h
+* @author  Guillermo Caporaletti
+* @brief   Prueba aleatoria del driver contra un modelo de referencia del HD44780.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_SELFTEST_H
+#define LCD_SELFTEST_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+// Operaciones que se sortean
+typedef enum {
+	LCD_TEST_PRINT, LCD_TEST_WRITE, LCD_TEST_SETCURSOR, LCD_TEST_CURSORMOVE,
+	LCD_TEST_SCROLL, LCD_TEST_ENTRYMODE, LCD_TEST_AUTOSCROLL, LCD_TEST_CREATECHAR,
+	LCD_TEST_HOME, LCD_TEST_CLEAR, LCD_TEST_OPS
+} LCD_test_op;
+
+typedef struct {
+	uint32_t seed;			// Semilla usada (repetirla reproduce la secuencia)
+	uint32_t steps;			// Pasos ejecutados
+	uint32_t failed_step;	// Paso donde el driver o el display difirieron del modelo (0: ninguno)
+	LCD_test_op failed_op;	// Operación de ese paso
+	uint32_t hw_reads;		// Lecturas del display comparadas con el modelo
+	uint32_t api_cycles;	// Ciclos dentro de las funciones del driver
+	uint32_t ops_per_second;
+} LCDselftestReport;
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_SELFTEST_TEXT		8		// Largo máximo de cada LCD_print
+#define LCD_SELFTEST_FULL_EVERY	64		// Cada cuántos pasos se relee toda la RAM
+
+/* Exported functions --------------------------------------------------------*/
+
+bool LCD_selftest(uint32_t, uint32_t, LCDselftestReport *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_SELFTEST_H */
+
+/***************************************************************END OF FILE****/
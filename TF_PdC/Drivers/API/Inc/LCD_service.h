@@ -0,0 +1,45 @@
+/*******************************************************************************
+* @file    LCD_service.h
+* @author  Guillermo Caporaletti
+* @brief   Escritura diferida en pantalla, enviada de a poco desde el lazo
+*          principal con un presupuesto de tiempo.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_SERVICE_H
+#define LCD_SERVICE_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Tamaño máximo de la pantalla (hasta 64 columnas): se usa la geometría del
+// display, y lo que quede fuera de este tamaño se descarta
+#ifndef LCD_SERVICE_COLS
+#define LCD_SERVICE_COLS		40
+#endif
+#ifndef LCD_SERVICE_ROWS
+#define LCD_SERVICE_ROWS		LCD_MAX_LINES
+#endif
+
+// Tiempo de una transferencia por el bus, sin la ejecución del controlador
+// (que se toma del perfil de tiempos en uso). Sólo decide si entra un paso más.
+#define LCD_SERVICE_TRANSFER_US	5
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_servicePrint(uint8_t, uint8_t, const char *);
+void LCD_serviceWrite(uint8_t, uint8_t, uint8_t);
+void LCD_serviceClear(void);
+uint16_t LCD_service(uint32_t);
+uint16_t LCD_servicePending(void);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_SERVICE_H */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,56 @@
+/*******************************************************************************
+* @file    LCD_snapshot.h
+* @author  Guillermo Caporaletti
+* @brief   Imagen de la pantalla (PGM, texto o hash) a partir de la sombra.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_SNAPSHOT_H
+#define LCD_SNAPSHOT_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+// Origen de la imagen: la sombra del driver (NULL) u otro modelo del display
+// (por ejemplo, un simulador del HD44780 que corre en la PC)
+typedef struct {
+	uint8_t cols;
+	uint8_t rows;
+	uint8_t (*cell)(uint8_t col, uint8_t row);		// Caracter visible en la posición
+	uint8_t (*cgram)(uint8_t address);				// Fila de un glifo de CGRAM
+	bool (*cursor)(uint8_t col, uint8_t row);		// Cursor visible (puede ser NULL)
+} LCDsnapshotSource;
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_SNAPSHOT_MAX_COLS	40
+
+// Cada caracter es de 5x8 puntos, con un punto de separación entre caracteres
+#define LCD_SNAPSHOT_WIDTH(cols)	((cols) * 6 - 1)
+#define LCD_SNAPSHOT_HEIGHT(rows)	((rows) * 9 - 1)
+
+// Bytes necesarios para LCD_snapshotPGM() y LCD_snapshotText()
+#define LCD_SNAPSHOT_PGM_SIZE(cols, rows)	(16 + LCD_SNAPSHOT_WIDTH(cols) * LCD_SNAPSHOT_HEIGHT(rows))
+#define LCD_SNAPSHOT_TEXT_SIZE(cols, rows)	((LCD_SNAPSHOT_WIDTH(cols) + 1) * LCD_SNAPSHOT_HEIGHT(rows) + 1)
+
+// Tonos de gris del PGM
+#define LCD_SNAPSHOT_DOT_ON		0x10	// Punto encendido
+#define LCD_SNAPSHOT_DOT_OFF	0xB0	// Punto apagado
+#define LCD_SNAPSHOT_GAP		0xFF	// Separación entre caracteres
+
+/* Exported functions --------------------------------------------------------*/
+
+size_t LCD_snapshotPGM(const LCDsnapshotSource *, uint8_t *, size_t);
+size_t LCD_snapshotText(const LCDsnapshotSource *, char *, size_t);
+uint32_t LCD_snapshotHash(const LCDsnapshotSource *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_SNAPSHOT_H */
+
+/***************************************************************END OF FILE****/
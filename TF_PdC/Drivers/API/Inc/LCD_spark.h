@@ -0,0 +1,51 @@
+/*******************************************************************************
+* @file    LCD_spark.h
+* @author  Guillermo Caporaletti
+* @brief   Gráfico de tendencia (sparkline) con caracteres propios rotativos.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_SPARK_H
+#define LCD_SPARK_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_SPARK_MAX_WIDTH		8		// Caracteres (los 8 lugares de CGRAM)
+#define LCD_SPARK_GLYPH_COLS	5		// Columnas de puntos por caracter
+#define LCD_SPARK_GLYPH_ROWS	8		// Filas de puntos por caracter
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef struct {
+	uint8_t col, row;		// Posición en pantalla del caracter de la izquierda
+	uint8_t first;			// Primer lugar de CGRAM usado
+	uint8_t width;			// Caracteres (lugares de CGRAM) del gráfico
+	int16_t min, max;		// Valores de la fila de abajo y de la de arriba
+	bool bars;				// Barras (true) o puntos (false)
+
+	uint8_t oldest;			// Lugar (desde first) que se ve a la izquierda
+	uint8_t fill;			// Columnas ya usadas del lugar de la derecha
+	uint8_t pixels[LCD_SPARK_MAX_WIDTH * LCD_SPARK_GLYPH_COLS];	// Una columna de puntos por byte (bit 0 arriba)
+
+	uint32_t samples;		// Muestras agregadas
+	uint32_t rows_sent;		// Filas de CGRAM enviadas
+	uint32_t cells_sent;	// Caracteres de DDRAM enviados (al rotar)
+} LCDspark;
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_sparkInit(LCDspark *, uint8_t, uint8_t, uint8_t, uint8_t, int16_t, int16_t, bool);
+void LCD_sparkAdd(LCDspark *, int16_t);
+void LCD_sparkDraw(LCDspark *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_SPARK_H */
+
+/***************************************************************END OF FILE****/
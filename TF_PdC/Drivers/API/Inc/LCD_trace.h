@@ -0,0 +1,64 @@
+/*******************************************************************************
+* @file    LCD_trace.h
+* @author  Guillermo Caporaletti
+* @brief   Registro de flancos de los pines del LCD, exportable como VCD.
+*          Se compila sólo si está definido LCD_TRACE.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_TRACE_H
+#define LCD_TRACE_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef enum {LCD_TRACE_WRITE, LCD_TRACE_READ, LCD_TRACE_MODE} LCD_trace_event;
+
+typedef enum {
+	LCD_TRACE_SETUP,		// tAS: RS/RW estables antes del flanco ascendente de E
+	LCD_TRACE_PULSE,		// PWEH: ancho del pulso de E
+	LCD_TRACE_DATA_SETUP,	// tDSW: datos estables antes del flanco descendente de E
+	LCD_TRACE_HOLD,			// tH / tAH: datos, RS y RW estables luego de bajar E
+	LCD_TRACE_CYCLE,		// tcycE: período de E
+	LCD_TRACE_CHECKS
+} LCD_trace_check;
+
+typedef struct {
+	uint32_t cycles;		// Momento del flanco (DWT->CYCCNT)
+	uint8_t event;			// LCD_trace_event
+	uint8_t signal;			// Índice de señal (ver LCD_trace.c)
+	uint8_t value;			// Nivel, o 1 = entrada en LCD_TRACE_MODE
+} LCDtraceEntry;
+
+typedef struct {
+	uint32_t violations[LCD_TRACE_CHECKS];	// Cantidad de violaciones
+	uint32_t worst_ns[LCD_TRACE_CHECKS];	// Peor valor medido (el menor)
+} LCDtraceReport;
+
+// Salida de texto para el volcado (por ejemplo, hacia la UART)
+typedef void (*LCD_output)(const char *, size_t);
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_TRACE_SIZE	512		// Eventos en el buffer circular
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_traceInit(const LCDconfig *);
+void LCD_traceRecord(LCD_trace_event, GPIO_TypeDef *, uint16_t, uint8_t);
+void LCD_traceClear(void);
+uint16_t LCD_traceCount(void);
+const LCDtraceEntry * LCD_traceEntry(uint16_t);
+void LCD_traceDumpVCD(LCD_output);
+uint32_t LCD_traceCheck(LCDtraceReport *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_TRACE_H */
+
+/***************************************************************END OF FILE****/
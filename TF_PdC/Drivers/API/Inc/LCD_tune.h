@@ -0,0 +1,38 @@
+/*******************************************************************************
+* @file    LCD_tune.h
+* @author  Guillermo Caporaletti
+* @brief   Ajuste automático de los tiempos del bus para el display conectado.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_TUNE_H
+#define LCD_TUNE_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Celdas seguidas de DDRAM donde se escriben los patrones de prueba: las
+// primeras que no se ven con la geometría y el desplazamiento en uso (luego
+// se restauran desde la sombra)
+#define LCD_TUNE_LENGTH		8
+
+#define LCD_TUNE_STEP_PCT	10		// Cada paso baja los tiempos un 10% del perfil
+#define LCD_TUNE_MIN_PCT	10		// Nunca por debajo del 10% del perfil
+#define LCD_TUNE_MARGIN_PCT	25		// Margen sobre el tiempo más corto que anduvo
+#define LCD_TUNE_ROUNDS		4		// Repeticiones de cada patrón por paso
+#define LCD_TUNE_STEPS		((100 - LCD_TUNE_MIN_PCT) / LCD_TUNE_STEP_PCT + 1)	// Pasos, a lo sumo
+
+/* Exported functions --------------------------------------------------------*/
+
+bool LCD_autotune(LCDtiming *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_TUNE_H */
+
+/***************************************************************END OF FILE****/
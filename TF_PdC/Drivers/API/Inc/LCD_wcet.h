@@ -0,0 +1,211 @@
+/*******************************************************************************
+* @file    LCD_wcet.h
+* @author  Guillermo Caporaletti
+* @brief   Cotas del tiempo que puede bloquear cada función del driver.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_WCET_H
+#define LCD_WCET_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+#include <LCD_tune.h>
+#include <LCD_charset.h>
+#include <LCD_field.h>
+#include <LCD_spark.h>
+#include <LCD_anim.h>
+#include <LCD_scrub.h>
+#include <LCD_plan.h>
+#include <LCD_queue.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+// Perfil más lento que deben cubrir las cotas al compilar (por omisión, el
+// SPLC780 con el oscilador en su mínimo; ver LCD_wcetCovers)
+#ifndef LCD_WCET_EXEC_US
+#define LCD_WCET_EXEC_US		43
+#endif
+#ifndef LCD_WCET_CLEAR_US
+#define LCD_WCET_CLEAR_US		1640
+#endif
+#ifndef LCD_WCET_CYCLE_NS
+#define LCD_WCET_CYCLE_NS		LCD_T_CYCLE_NS
+#endif
+
+// Tiempo de CPU por transferencia, aparte de los tiempos del bus (escritura
+// de los pines por HAL, unos 14 accesos por byte)
+#define LCD_WCET_CPU_NS			2000
+
+// Comandos diferidos que pueden salir antes de lo pedido (ver LCD_deferControl):
+// displaycontrol en dos grupos (pantalla dividida) y modo de escritura
+#define LCD_WCET_PENDING		(LCD_CONTROL_GROUPS + 1)
+
+// Con LCD_busyEvent, lo primero puede esperar el fin de un clear por
+// interrupción: termina hasta una ejecución después de lo previsto, y en 4
+// bits completa la lectura con un pulso (ver LCD_busy_sleep). Una operación.
+#define LCD_WCET_BUSY_EVENT		1
+
+// Lo que se supone para las cotas que se verifican al compilar
+#define LCD_WCET_LINES			4		// Pantalla de LCD_printScreen y de la consola
+#define LCD_WCET_COLUMNS		40
+#define LCD_WCET_DISPLAYS		2		// Displays de LCD_restore y LCD_lost
+#ifndef LCD_WCET_BUDGET_US
+#define LCD_WCET_BUDGET_US		200		// Presupuesto de LCD_service (como en "main.c")
+#endif
+#ifndef LCD_WCET_SCRUB_US
+#define LCD_WCET_SCRUB_US		500		// Presupuesto de LCD_scrub
+#endif
+#ifndef LCD_WCET_QUEUE_OPS
+#define LCD_WCET_QUEUE_OPS		4		// Máximo de operaciones de LCD_queueService
+#endif
+
+// Cotas máximas aceptadas: si alguna se pasa, no compila
+#ifndef LCD_WCET_LIMIT_US
+#define LCD_WCET_LIMIT_US			5000	// Funciones de una operación (print, clear, createChar...)
+#endif
+#ifndef LCD_WCET_LIMIT_SCREEN_US
+#define LCD_WCET_LIMIT_SCREEN_US	10000	// LCD_printScreen
+#endif
+#ifndef LCD_WCET_LIMIT_RESTORE_US
+#define LCD_WCET_LIMIT_RESTORE_US	40000	// LCD_restore, LCD_lost, LCD_recover y LCD_resync
+#endif
+#ifndef LCD_WCET_LIMIT_REDRAW_US
+#define LCD_WCET_LIMIT_REDRAW_US	25000	// Más que una pantalla: campos, plan y cola
+#endif
+#ifndef LCD_WCET_LIMIT_TUNE_US
+#define LCD_WCET_LIMIT_TUNE_US		100000	// LCD_autotune (en el arranque)
+#endif
+
+// Una transferencia (uno o dos períodos de E) y una operación (transferencia
+// y ejecución), en ns, para un perfil (ejecución en us y período de E en ns)
+#define LCD_WCET_XFER_NS(ciclo, cuatro)			(((cuatro) ? 2UL : 1UL) * (uint32_t) (ciclo) + LCD_WCET_CPU_NS)
+#define LCD_WCET_OP_NS(exec, ciclo, cuatro)		((uint32_t) (exec) * 1000UL + LCD_WCET_XFER_NS(ciclo, cuatro))
+
+// Cota en us de una llamada con k transferencias y esperas fijas (us): lo
+// diferido sale antes, y lo primero espera una instrucción anterior de hasta
+// un clear (la última de la llamada no se espera: la espera la siguiente)
+#define LCD_WCET_US(exec, clear, ciclo, cuatro, k, espera) \
+	((uint32_t) (clear) + (uint32_t) (espera) + \
+	 ((LCD_WCET_PENDING + LCD_WCET_BUSY_EVENT + (uint32_t) (k)) * LCD_WCET_OP_NS(exec, ciclo, cuatro) + 999UL) / 1000UL)
+
+// Transferencias de cada función (n caracteres, f filas, c columnas, d
+// displays), con los mismos límites que usa el código
+#define LCD_WCET_K_WRITE			1		// LCD_write, LCD_command, LCD_setCursor, desplazamientos
+#define LCD_WCET_K_READ				1		// LCD_data_read, LCD_address_read, LCD_busy_flag
+#define LCD_WCET_K_PRINT(n)			(n)		// LCD_print (n = LCD_PRINT_MAX), LCD_printn, LCD_printSpan
+#define LCD_WCET_K_CLEAR			2		// Comando y una lectura del busy flag
+#define LCD_WCET_K_CONTROL			LCD_CONTROL_GROUPS	// LCD_display, LCD_cursor, LCD_blink
+#define LCD_WCET_K_MODE				0		// Modo de escritura y LCD_flush: sólo lo diferido
+#define LCD_WCET_K_CREATECHAR		(1 + LCD_GLYPH_ROWS)	// Dirección y filas
+#define LCD_WCET_K_GLYPHROW			2
+#define LCD_WCET_K_PRINTSCREEN(f, c)	((f) * ((c) + 1))	// Una dirección por fila
+// Por display, LCD_replay_display: la CGRAM (una dirección cada dos filas a
+// lo sumo) y la DDRAM (igual), y luego el desplazamiento por el lado más
+// corto y el AC
+#define LCD_WCET_K_REPLAY			(LCD_CGRAM_SIZE + LCD_CGRAM_SIZE / 2 + LCD_DDRAM_CELLS + LCD_DDRAM_CELLS / 2 + LCD_DDRAM_CELLS / 2 + 1)
+// Sincronización, function set, apagado, borrado y modo de escritura; cada
+// display; y lo diferido al prender
+#define LCD_WCET_K_RESTORE(d)		(LCD_SYNC_WRITES + 4 + (d) * LCD_WCET_K_REPLAY + LCD_WCET_PENDING)
+#define LCD_WCET_K_LOST(d)			((d) * 4)	// Registro, dirección, celda y dirección
+#define LCD_WCET_K_RESYNC			(LCD_SYNC_WRITES + 1 + LCD_WCET_PENDING)
+// Los patrones de cada paso (dirección, escritura, dirección y relectura),
+// el modo de escritura antes y después, la reposición del área y el AC, y
+// si un paso falló, LCD_resync, LCD_lost y LCD_restore
+#define LCD_WCET_K_AUTOTUNE(d) \
+	(LCD_TUNE_STEPS * LCD_TUNE_ROUNDS * 2 * (1 + LCD_TUNE_LENGTH) + 4 + LCD_TUNE_LENGTH + 2 + \
+	 LCD_WCET_K_RESYNC + LCD_WCET_K_LOST(d) + LCD_WCET_K_RESTORE(d))
+#define LCD_WCET_K_SERVICE			2		// Más allá del presupuesto: un paso estimado de menos
+#define LCD_WCET_K_CONSOLE(f, c)	((f) * ((c) + 1))	// Como LCD_printScreen, en la región
+#define LCD_WCET_K_MIRROR(n)		(2 * (n))	// Dirección y dato por celda
+#define LCD_WCET_K_RECOVER(d)		(LCD_WCET_K_LOST(d) + LCD_WCET_K_RESTORE(d))
+// Un glifo que no estaba: LCD_createChar y la vuelta del AC. En una cadena
+// se cargan a lo sumo los lugares de la traducción (no se pisan los suyos)
+#define LCD_WCET_GLYPH_SLOTS		(LCD_GLYPH_LAST_SLOT - LCD_GLYPH_FIRST_SLOT + 1)
+#define LCD_WCET_K_TRANSLATE		(LCD_WCET_K_CREATECHAR + 1)
+#define LCD_WCET_K_UTF8(n)			((n) + LCD_WCET_GLYPH_SLOTS * LCD_WCET_K_TRANSLATE)
+// De izquierda a derecha, en cada tramo de caracteres distintos va una
+// dirección y los tramos están separados por iguales: a lo sumo el ancho
+// más uno por campo (n campos de w caracteres)
+#define LCD_WCET_K_FIELD(n, w)		((n) * ((w) + 1))
+// La sombra cuenta como distinta toda fila de la CGRAM (una dirección y la
+// fila, como LCD_glyphRow) y, al rotar, los códigos en pantalla (una dirección)
+#define LCD_WCET_K_SPARK_ADD		(LCD_SPARK_GLYPH_ROWS * LCD_WCET_K_GLYPHROW + LCD_SPARK_MAX_WIDTH + 1)
+#define LCD_WCET_K_SPARK_DRAW		(LCD_SPARK_MAX_WIDTH * LCD_SPARK_GLYPH_ROWS * LCD_WCET_K_GLYPHROW + LCD_SPARK_MAX_WIDTH + 1)
+#define LCD_WCET_K_BANK(n)			((n) * LCD_GLYPH_ROWS * LCD_WCET_K_GLYPHROW)	// n glifos
+#define LCD_WCET_K_ANIM				(LCD_ANIM_BUDGET * 2)	// Dirección y dato por cambio
+// Las lecturas que entran en el presupuesto p (cada una espera la ejecución
+// de la anterior) y una celda corregida de más
+#define LCD_WCET_K_SCRUB(p, exec)	((p) / (exec) + 1 + LCD_SCRUB_REPAIR_TRANSFERS)
+// El desplazamiento más largo (clear y home son menos) y, por fila, lo
+// distinto con sus direcciones: con dos controladores ubicar el AC puede
+// llevar dos comandos, pero un hueco de un caracter se reescribe
+#define LCD_WCET_K_PLAN(f, c)		(LCD_PLAN_MAX_SCROLL + (f) * ((c) + 2))
+// m operaciones (la más larga, un texto con su dirección; se cuenta además
+// la espera de un clear por cada una) y luego el cuadro, fila por fila
+#define LCD_WCET_K_QUEUE(m, f, c)	((m) * (1 + LCD_QUEUE_TEXT) + (f) * ((c) + 1))
+
+// Esperas fijas, en us
+#define LCD_WCET_WAIT_CLEAR(clear)		(clear)			// clear y home esperan su ejecución
+#define LCD_WCET_WAIT_SYNC				(LCD_T_SYNC1_US + LCD_T_SYNC2_US)
+#define LCD_WCET_WAIT_RESTORE(clear)	(LCD_WCET_WAIT_SYNC + (clear))
+#define LCD_WCET_WAIT_LOST(clear, d)	(2 * (d) * (uint32_t) (clear))	// Espera y busy flag, por display
+#define LCD_WCET_WAIT_AUTOTUNE(clear, d)	(LCD_WCET_WAIT_SYNC + LCD_WCET_WAIT_LOST(clear, d) + LCD_WCET_WAIT_RESTORE(clear))
+#define LCD_WCET_WAIT_RECOVER(clear, d)		(LCD_WCET_WAIT_LOST(clear, d) + LCD_WCET_WAIT_RESTORE(clear))
+#define LCD_WCET_WAIT_QUEUE(clear, m)		((m) * (uint32_t) (clear))
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef enum {
+	LCD_WCET_WRITE,
+	LCD_WCET_READ,
+	LCD_WCET_PRINT,
+	LCD_WCET_CLEAR,
+	LCD_WCET_CONTROL,
+	LCD_WCET_MODE,
+	LCD_WCET_CREATECHAR,
+	LCD_WCET_GLYPHROW,
+	LCD_WCET_PRINTSCREEN,
+	LCD_WCET_RESTORE,
+	LCD_WCET_LOST,
+	LCD_WCET_AUTOTUNE,
+	LCD_WCET_SERVICE,
+	LCD_WCET_CONSOLE,
+	LCD_WCET_MIRROR_WRITE,
+	LCD_WCET_MIRROR_PRINT,
+	LCD_WCET_MIRROR_COPY,
+	LCD_WCET_RECOVER,
+	LCD_WCET_RESYNC,
+	LCD_WCET_UTF8,
+	LCD_WCET_TRANSLATE,
+	LCD_WCET_FIELD,
+	LCD_WCET_SCRUB,
+	LCD_WCET_SPARK_ADD,
+	LCD_WCET_SPARK_DRAW,
+	LCD_WCET_BANK,
+	LCD_WCET_ANIM,
+	LCD_WCET_PLAN,
+	LCD_WCET_QUEUE,
+	LCD_WCET_ROWS
+} LCDwcetApi;
+
+typedef struct {
+	const char * name;		// Funciones
+	uint16_t transfers;		// Transferencias del bus, incluidas las diferidas
+	uint32_t bound_us;		// Tiempo máximo bloqueado
+} LCDwcetRow;
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_wcetTable(const LCDtiming *, bool, LCDwcetRow[LCD_WCET_ROWS]);
+uint32_t LCD_wcetPrint(const LCDtiming *, bool, size_t);
+bool LCD_wcetCovers(const LCDtiming *);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_WCET_H */
+
+/***************************************************************END OF FILE****/
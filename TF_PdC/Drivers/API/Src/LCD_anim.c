@@ -0,0 +1,145 @@
+/*******************************************************************************
+* @file    LCD_anim.c
+* @author  Guillermo Caporaletti
+* @brief   Animaciones guardadas en flash, con cuadros por diferencias.
+*          Cada cuadro tiene sólo las filas de CGRAM y los caracteres que
+*          cambian respecto del anterior (el primero, todo lo que se usa).
+*          LCD_animUpdate() se llama desde el lazo principal: no espera
+*          nunca, y envía a lo sumo LCD_ANIM_BUDGET cambios por llamada, así
+*          que un cuadro grande se reparte en varias vueltas del lazo.
+*          LCD_animUpdateBudget() además no se pasa de un tiempo dado, como
+*          LCD_service(), para compartir con éste el presupuesto de la vuelta.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_anim.h>
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_anim_send(LCDanimPlayer * Jugador, uint32_t Presupuesto_us);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Comienza una animación desde el primer cuadro
+* @param  Estado de la animación y animación (puede estar en flash)
+* @retval None
+*/
+void LCD_animStart(LCDanimPlayer * Jugador, const LCDanimation * Animacion) {
+	Jugador->anim = Animacion;
+	Jugador->frame = 0;
+	Jugador->next = 0;
+	Jugador->start = HAL_GetTick();
+	Jugador->sending = true;
+	Jugador->playing = (Animacion->frame_count > 0);
+}
+
+/*******************************************************************************
+* @brief  Avanza la animación (no bloqueante)
+* @param  Estado de la animación
+* @retval true mientras la animación siga
+* @note   Si todavía no es hora del cuadro siguiente, sólo compara el tick.
+*         Si el lazo se atrasa más de un cuadro, la animación sigue desde
+*         ahora en lugar de enviar varios cuadros seguidos.
+*/
+bool LCD_animUpdate(LCDanimPlayer * Jugador) {
+	return LCD_animUpdateBudget(Jugador, UINT32_MAX);
+}
+
+/*******************************************************************************
+* @brief  Avanza la animación sin pasarse de un presupuesto de tiempo
+* @param  Estado de la animación y presupuesto en microsegundos
+* @retval true mientras la animación siga
+* @note   Como LCD_animUpdate(), pero antes de cada cambio estima lo que
+*         tardaría (lo que falta de la instrucción anterior, la dirección si
+*         hace falta y el dato) y, si no entra, deja el resto para la próxima
+*         llamada. Con un presupuesto menor que un cambio no envía nada.
+*/
+bool LCD_animUpdateBudget(LCDanimPlayer * Jugador, uint32_t Presupuesto_us) {
+	if (!Jugador->playing) return false;
+
+	if (!Jugador->sending) {
+		const LCDanimation * Animacion = Jugador->anim;
+		uint16_t Duracion = Animacion->frames[Jugador->frame].ms;
+		if (HAL_GetTick() - Jugador->start < Duracion) return true;
+
+		// Paso al cuadro siguiente
+		if (++Jugador->frame >= Animacion->frame_count) {
+			if (Animacion->loop_from >= Animacion->frame_count) {
+				Jugador->playing = false;
+				return false;
+			}
+			Jugador->frame = Animacion->loop_from;
+		}
+		Jugador->start += Duracion;
+		if (HAL_GetTick() - Jugador->start >= Animacion->frames[Jugador->frame].ms) Jugador->start = HAL_GetTick();
+		Jugador->next = 0;
+		Jugador->sending = true;
+	}
+
+	LCD_anim_send(Jugador, Presupuesto_us);
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Detiene la animación (lo que está en pantalla queda)
+* @param  Estado de la animación
+* @retval None
+*/
+void LCD_animStop(LCDanimPlayer * Jugador) {
+	Jugador->playing = false;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Envía los cambios pendientes del cuadro, hasta LCD_ANIM_BUDGET
+* @param  Estado de la animación y presupuesto en microsegundos
+* @retval None
+* @note   Las filas de CGRAM van primero, para que los caracteres nuevos ya
+*         aparezcan con su dibujo. Los caracteres que la sombra ya tiene no
+*         se reenvían (por ejemplo, al repetir desde el primer cuadro).
+*/
+static void LCD_anim_send(LCDanimPlayer * Jugador, uint32_t Presupuesto_us) {
+	const LCDanimFrame * Cuadro = &Jugador->anim->frames[Jugador->frame];
+	uint16_t Total = (uint16_t) Cuadro->row_count + Cuadro->cell_count;
+	uint32_t Inicio = LCD_cycles();
+	uint32_t Direccion_us = LCD_getTiming()->exec_us + LCD_ANIM_TRANSFER_US;
+	uint8_t Siguiente = 0xFF;		// Dirección de CGRAM que dejó la última fila
+
+	for (uint8_t Enviados=0; Enviados < LCD_ANIM_BUDGET && Jugador->next < Total; Jugador->next++) {
+		const LCDanimRow * Fila = NULL;
+		const LCDanimCell * Celda = NULL;
+		bool Ubicado;
+
+		if (Jugador->next < Cuadro->row_count) {
+			Fila = &Cuadro->rows[Jugador->next];
+			Ubicado = ((Fila->address & 0x3F) == Siguiente);
+		} else {
+			Celda = &Cuadro->cells[Jugador->next - Cuadro->row_count];
+			if (LCD_cellShadow(Celda->col, Celda->row) == Celda->code) continue;
+			Ubicado = LCD_cursorAt(Celda->col, Celda->row);
+		}
+
+		// Lo que tardaría este cambio: espera, dirección (si hace falta) y dato
+		uint32_t Paso_us = LCD_readyIn() + LCD_ANIM_TRANSFER_US + (Ubicado ? 0 : Direccion_us);
+		uint32_t Gastado_us = (LCD_cycles() - Inicio) / LCD_CYCLES_PER_US;
+		if (Gastado_us + Paso_us > Presupuesto_us) return;
+
+		if (Fila != NULL) {
+			LCD_glyphRow(Fila->address, Fila->bits);
+			Siguiente = (uint8_t) ((Fila->address + 1) & 0x3F);
+		} else {
+			if (!Ubicado) LCD_setCursor(Celda->col, Celda->row);
+			LCD_write(Celda->code);
+			Siguiente = 0xFF;
+		}
+		Enviados++;
+	}
+
+	if (Jugador->next >= Total) Jugador->sending = false;
+}
+
+/***************************************************************END OF FILE****/
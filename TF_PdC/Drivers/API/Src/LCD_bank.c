@@ -0,0 +1,114 @@
+/*******************************************************************************
+* @file    LCD_bank.c
+* @author  Guillermo Caporaletti
+* @brief   Juegos de caracteres propios (bancos de CGRAM) empaquetados en flash.
+*          Cada pantalla tiene su banco de glifos, guardado con 5 bits por
+*          fila. Al cambiar de banco sólo se envían las filas que difieren de
+*          lo que ya tiene la CGRAM (según la sombra del driver): los glifos
+*          comunes a dos pantallas, o las filas en blanco que comparten, no
+*          viajan otra vez por el bus.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_bank.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCDbankStats Estadisticas;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t LCD_bank_row(const LCDglyph Glifo, uint8_t Fila);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Carga un banco de glifos en CGRAM
+* @param  Banco
+* @retval None
+* @note   Sólo envía las filas distintas a la sombra de CGRAM, y la dirección
+*         sólo cuando el AC no quedó ya en la fila. Deja el AC en CGRAM: lo
+*         siguiente a escribir en pantalla debe ubicar el cursor.
+*/
+void LCD_bankLoad(const LCDglyphBank * Banco) {
+	Estadisticas.loads++;
+	Estadisticas.transfers_full += (uint32_t) Banco->count * 9;		// Dirección y 8 filas por glifo
+
+	for (uint8_t i=0; i<Banco->count; i++) {
+		uint8_t Lugar = (uint8_t) ((Banco->first + i) & 0x07);
+
+		for (uint8_t Fila=0; Fila<8; Fila++) {
+			uint8_t Direccion = (uint8_t) ((Lugar << 3) | Fila);
+			uint8_t Puntos = LCD_bank_row(Banco->glyphs[i], Fila);
+
+			if (LCD_cgramKnown(Direccion) && (LCD_cgramShadow(Direccion) & 0x1F) == Puntos) {
+				Estadisticas.rows_skipped++;
+				continue;
+			}
+
+			if (!LCD_cgramSelected() || LCD_address() != Direccion) Estadisticas.transfers++;
+			LCD_glyphRow(Direccion, Puntos);
+			Estadisticas.rows_sent++;
+			Estadisticas.transfers++;
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Código de caracter de un glifo del banco (para LCD_write o textos)
+* @param  Banco e índice del glifo
+* @retval Código (lugar de CGRAM)
+*/
+uint8_t LCD_bankCode(const LCDglyphBank * Banco, uint8_t Indice) {
+	return (uint8_t) ((Banco->first + Indice) & 0x07);
+}
+
+/*******************************************************************************
+* @brief  Desempaqueta un glifo en 8 filas (como las de LCD_createChar)
+* @param  Glifo empaquetado y filas
+* @retval None
+*/
+void LCD_glyphUnpack(const LCDglyph Glifo, uint8_t Filas[8]) {
+	for (uint8_t Fila=0; Fila<8; Fila++) {
+		Filas[Fila] = LCD_bank_row(Glifo, Fila);
+	}
+}
+
+/*******************************************************************************
+* @brief  Bytes de flash que ahorra el banco respecto de arreglos de 8 bytes
+* @param  Banco
+* @retval Bytes
+*/
+uint16_t LCD_bankFlashSaved(const LCDglyphBank * Banco) {
+	return (uint16_t) Banco->count * (8 - LCD_GLYPH_BYTES);
+}
+
+/*******************************************************************************
+* @brief  Estadísticas de los cambios de banco
+* @param  None
+* @retval Estadísticas (transfers_full - transfers es lo ahorrado en el bus)
+*/
+const LCDbankStats * LCD_bankStats(void) {
+	return &Estadisticas;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Fila de un glifo empaquetado
+* @param  Glifo y fila (0 a 7)
+* @retval Puntos de la fila (bit 4 a la izquierda)
+* @note   Las filas están seguidas de a 5 bits, la primera en los bits más
+*         altos del primer byte (ver LCD_GLYPH).
+*/
+static uint8_t LCD_bank_row(const LCDglyph Glifo, uint8_t Fila) {
+	uint8_t Bit = (uint8_t) (Fila * 5);
+	uint8_t Byte = Bit >> 3;
+	uint16_t Par = (uint16_t) (Glifo[Byte] << 8);
+	if (Byte + 1 < LCD_GLYPH_BYTES) Par |= Glifo[Byte + 1];
+	return (uint8_t) ((Par >> (11 - (Bit & 7))) & 0x1F);
+}
+
+/***************************************************************END OF FILE****/
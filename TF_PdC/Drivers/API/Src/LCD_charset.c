@@ -0,0 +1,334 @@
+/*******************************************************************************
+* @file    LCD_charset.c
+* @author  Guillermo Caporaletti
+* @brief   Traducción de texto UTF-8 a la ROM de caracteres del HD44780.
+*          Los caracteres que no están en ROM se dibujan con glifos propios
+*          que se cargan en CGRAM a demanda (con caché, sin memoria dinámica).
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_charset.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+// En las tablas, los valores 0x01 a 0x1F no son códigos de ROM sino
+// referencias a un glifo propio (índice + 1). 0x00 indica "no disponible".
+#define GLYPH(n)		((uint8_t) ((n) + 1))
+#define IS_GLYPH(c)		((c) != 0 && (c) < 0x20)
+#define GLYPH_INDEX(c)	((c) - 1)
+
+// Páginas de 128 códigos Unicode con traducción (índice = código >> 7)
+#define PAGE_NONE		0
+#define PAGE_LATIN1		1		// U+0080 a U+00FF
+#define PAGE_GREEK		2		// U+0380 a U+03FF
+#define PAGE_ARROWS		3		// U+2180 a U+21FF
+#define PAGE_MATH		4		// U+2200 a U+227F
+#define PAGES			4
+#define PAGE_LIMIT		0x2280
+
+#define GLYPH_SLOTS		(LCD_GLYPH_LAST_SLOT - LCD_GLYPH_FIRST_SLOT + 1)
+
+/* Private types -------------------------------------------------------------*/
+
+enum {
+	G_a_ACUTE, G_e_ACUTE, G_i_ACUTE, G_o_ACUTE, G_u_ACUTE,
+	G_A_ACUTE, G_E_ACUTE, G_I_ACUTE, G_O_ACUTE, G_U_ACUTE,
+	G_N_TILDE, G_U_DIAERESIS, G_INV_QUESTION, G_INV_EXCLAMATION,
+	G_BACKSLASH, G_TILDE,
+	GLYPHS
+};
+
+/* Private constants ---------------------------------------------------------*/
+
+// Glifos 5x8 para lo que falta en ROM (una fila por byte, como en LCD_createChar)
+static const uint8_t Glifos[GLYPHS][8] = {
+	[G_a_ACUTE]         = {0x02, 0x04, 0x0E, 0x01, 0x0F, 0x11, 0x0F, 0x00},
+	[G_e_ACUTE]         = {0x02, 0x04, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00},
+	[G_i_ACUTE]         = {0x02, 0x04, 0x00, 0x0C, 0x04, 0x04, 0x0E, 0x00},
+	[G_o_ACUTE]         = {0x02, 0x04, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00},
+	[G_u_ACUTE]         = {0x02, 0x04, 0x11, 0x11, 0x11, 0x13, 0x0D, 0x00},
+	[G_A_ACUTE]         = {0x02, 0x04, 0x0E, 0x11, 0x1F, 0x11, 0x11, 0x00},
+	[G_E_ACUTE]         = {0x02, 0x04, 0x1F, 0x10, 0x1E, 0x10, 0x1F, 0x00},
+	[G_I_ACUTE]         = {0x02, 0x04, 0x0E, 0x04, 0x04, 0x04, 0x0E, 0x00},
+	[G_O_ACUTE]         = {0x02, 0x0E, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},
+	[G_U_ACUTE]         = {0x02, 0x04, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},
+	[G_N_TILDE]         = {0x0D, 0x12, 0x11, 0x19, 0x15, 0x13, 0x11, 0x00},
+	[G_U_DIAERESIS]     = {0x0A, 0x00, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},
+	[G_INV_QUESTION]    = {0x04, 0x00, 0x04, 0x08, 0x10, 0x11, 0x0E, 0x00},
+	[G_INV_EXCLAMATION] = {0x04, 0x00, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00},
+	[G_BACKSLASH]       = {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00},
+	[G_TILDE]           = {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00},
+};
+
+// Página de cada bloque de 128 códigos Unicode
+static const uint8_t Paginas[PAGE_LIMIT >> 7] = {
+	[0x0080 >> 7] = PAGE_LATIN1,
+	[0x0380 >> 7] = PAGE_GREEK,
+	[0x2180 >> 7] = PAGE_ARROWS,
+	[0x2200 >> 7] = PAGE_MATH,
+};
+
+// ROM A00 (japonesa): códigos de ROM para cada página (índice = código & 0x7F)
+static const uint8_t Tabla_A00[PAGES][128] = {
+	[PAGE_LATIN1 - 1] = {
+		[0xA1 & 0x7F] = GLYPH(G_INV_EXCLAMATION),
+		[0xA2 & 0x7F] = 0xEC,	// ¢
+		[0xA5 & 0x7F] = 0x5C,	// ¥
+		[0xB0 & 0x7F] = 0xDF,	// °
+		[0xB5 & 0x7F] = 0xE4,	// µ
+		[0xB7 & 0x7F] = 0xA5,	// ·
+		[0xBF & 0x7F] = GLYPH(G_INV_QUESTION),
+		[0xC1 & 0x7F] = GLYPH(G_A_ACUTE),
+		[0xC9 & 0x7F] = GLYPH(G_E_ACUTE),
+		[0xCD & 0x7F] = GLYPH(G_I_ACUTE),
+		[0xD1 & 0x7F] = GLYPH(G_N_TILDE),
+		[0xD3 & 0x7F] = GLYPH(G_O_ACUTE),
+		[0xDA & 0x7F] = GLYPH(G_U_ACUTE),
+		[0xDC & 0x7F] = GLYPH(G_U_DIAERESIS),
+		[0xDF & 0x7F] = 0xE2,	// ß
+		[0xE1 & 0x7F] = GLYPH(G_a_ACUTE),
+		[0xE4 & 0x7F] = 0xE1,	// ä
+		[0xE9 & 0x7F] = GLYPH(G_e_ACUTE),
+		[0xED & 0x7F] = GLYPH(G_i_ACUTE),
+		[0xF1 & 0x7F] = 0xEE,	// ñ
+		[0xF3 & 0x7F] = GLYPH(G_o_ACUTE),
+		[0xF6 & 0x7F] = 0xEF,	// ö
+		[0xF7 & 0x7F] = 0xFD,	// ÷
+		[0xFA & 0x7F] = GLYPH(G_u_ACUTE),
+		[0xFC & 0x7F] = 0xF5,	// ü
+	},
+	[PAGE_GREEK - 1] = {
+		[0x3A3 & 0x7F] = 0xF6,	// Σ
+		[0x3A9 & 0x7F] = 0xF4,	// Ω
+		[0x3B1 & 0x7F] = 0xE0,	// α
+		[0x3B2 & 0x7F] = 0xE2,	// β
+		[0x3B5 & 0x7F] = 0xE3,	// ε
+		[0x3B8 & 0x7F] = 0xF2,	// θ
+		[0x3BC & 0x7F] = 0xE4,	// μ
+		[0x3C0 & 0x7F] = 0xF7,	// π
+		[0x3C1 & 0x7F] = 0xE6,	// ρ
+		[0x3C3 & 0x7F] = 0xE5,	// σ
+	},
+	[PAGE_ARROWS - 1] = {
+		[0x2190 & 0x7F] = 0x7F,	// ←
+		[0x2192 & 0x7F] = 0x7E,	// →
+	},
+	[PAGE_MATH - 1] = {
+		[0x221A & 0x7F] = 0xE8,	// √
+		[0x221E & 0x7F] = 0xF3,	// ∞
+	},
+};
+
+// ROM A02 (europea): Latin-1 casi completo en 0xA0-0xFF
+static const uint8_t Tabla_A02[PAGES][128] = {
+	[PAGE_LATIN1 - 1] = {
+		[0xA1 & 0x7F] = 0xA1, [0xA2 & 0x7F] = 0xA2, [0xA3 & 0x7F] = 0xA3,
+		[0xA5 & 0x7F] = 0xA5, [0xA7 & 0x7F] = 0xA7, [0xB0 & 0x7F] = 0xB0,
+		[0xB1 & 0x7F] = 0xB1, [0xB2 & 0x7F] = 0xB2, [0xB3 & 0x7F] = 0xB3,
+		[0xB5 & 0x7F] = 0xB5, [0xB7 & 0x7F] = 0xB7, [0xBF & 0x7F] = 0xBF,
+		[0xC0 & 0x7F] = 0xC0, [0xC1 & 0x7F] = 0xC1, [0xC2 & 0x7F] = 0xC2,
+		[0xC3 & 0x7F] = 0xC3, [0xC4 & 0x7F] = 0xC4, [0xC5 & 0x7F] = 0xC5,
+		[0xC6 & 0x7F] = 0xC6, [0xC7 & 0x7F] = 0xC7, [0xC8 & 0x7F] = 0xC8,
+		[0xC9 & 0x7F] = 0xC9, [0xCA & 0x7F] = 0xCA, [0xCB & 0x7F] = 0xCB,
+		[0xCC & 0x7F] = 0xCC, [0xCD & 0x7F] = 0xCD, [0xCE & 0x7F] = 0xCE,
+		[0xCF & 0x7F] = 0xCF, [0xD1 & 0x7F] = 0xD1, [0xD2 & 0x7F] = 0xD2,
+		[0xD3 & 0x7F] = 0xD3, [0xD4 & 0x7F] = 0xD4, [0xD5 & 0x7F] = 0xD5,
+		[0xD6 & 0x7F] = 0xD6, [0xD7 & 0x7F] = 0xD7, [0xD9 & 0x7F] = 0xD9,
+		[0xDA & 0x7F] = 0xDA, [0xDB & 0x7F] = 0xDB, [0xDC & 0x7F] = 0xDC,
+		[0xDD & 0x7F] = 0xDD, [0xDF & 0x7F] = 0xDF, [0xE0 & 0x7F] = 0xE0,
+		[0xE1 & 0x7F] = 0xE1, [0xE2 & 0x7F] = 0xE2, [0xE3 & 0x7F] = 0xE3,
+		[0xE4 & 0x7F] = 0xE4, [0xE5 & 0x7F] = 0xE5, [0xE6 & 0x7F] = 0xE6,
+		[0xE7 & 0x7F] = 0xE7, [0xE8 & 0x7F] = 0xE8, [0xE9 & 0x7F] = 0xE9,
+		[0xEA & 0x7F] = 0xEA, [0xEB & 0x7F] = 0xEB, [0xEC & 0x7F] = 0xEC,
+		[0xED & 0x7F] = 0xED, [0xEE & 0x7F] = 0xEE, [0xEF & 0x7F] = 0xEF,
+		[0xF1 & 0x7F] = 0xF1, [0xF2 & 0x7F] = 0xF2, [0xF3 & 0x7F] = 0xF3,
+		[0xF4 & 0x7F] = 0xF4, [0xF5 & 0x7F] = 0xF5, [0xF6 & 0x7F] = 0xF6,
+		[0xF7 & 0x7F] = 0xF7, [0xF9 & 0x7F] = 0xF9, [0xFA & 0x7F] = 0xFA,
+		[0xFB & 0x7F] = 0xFB, [0xFC & 0x7F] = 0xFC, [0xFD & 0x7F] = 0xFD,
+		[0xFF & 0x7F] = 0xFF,
+	},
+};
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCD_rom ROM_actual = LCD_ROM_A00;
+static uint8_t Glifo_en_lugar[GLYPH_SLOTS];		// GLYPH(n) cargado, 0 si libre
+static uint32_t Uso_de_lugar[GLYPH_SLOTS];		// Marca de último uso (LRU)
+static uint32_t Reloj_de_uso = 0;
+static uint32_t Inicio_de_texto = 0;			// Lugares usados desde aquí no se pisan
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t LCD_glyph_slot(uint8_t Glifo);
+static const char * LCD_utf8_decode(const char * Texto, uint32_t * Codigo);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Selecciona la ROM de caracteres del display y vacía la caché de glifos
+* @param  LCD_ROM_A00 o LCD_ROM_A02
+* @retval None
+*/
+void LCD_charset(LCD_rom rom) {
+	ROM_actual = rom;
+	LCD_charsetReset();
+}
+
+/*******************************************************************************
+* @brief  Olvida los glifos cargados (por ejemplo, si la aplicación pisó CGRAM)
+* @param  None
+* @retval None
+*/
+void LCD_charsetReset(void) {
+	memset(Glifo_en_lugar, 0, sizeof(Glifo_en_lugar));
+	memset(Uso_de_lugar, 0, sizeof(Uso_de_lugar));
+}
+
+/*******************************************************************************
+* @brief  Traduce un código Unicode al código a escribir en el HD44780
+* @param  Código Unicode
+* @retval Código de ROM, lugar de CGRAM o LCD_CHARSET_UNKNOWN
+* @note   Tiempo acotado: dos accesos a tabla y, si hace falta un glifo,
+*         una búsqueda entre los (a lo sumo 8) lugares de CGRAM; si no
+*         estaba cargado, un recorrido de la sombra de DDRAM para no pisar
+*         uno que se ve (LCD_DDRAM_CELLS celdas).
+*/
+uint8_t LCD_translate(uint32_t Codigo) {
+	uint8_t Traducido = 0;
+
+	if (Codigo < 0x80) {
+		// ASCII: igual en ambas ROM, salvo '\' y '~' en la A00 (¥ y →)
+		if (Codigo < 0x20) return LCD_CHARSET_UNKNOWN;
+		if (ROM_actual == LCD_ROM_A00 && Codigo == '\\') Traducido = GLYPH(G_BACKSLASH);
+		else if (ROM_actual == LCD_ROM_A00 && Codigo == '~') Traducido = GLYPH(G_TILDE);
+		else return (uint8_t) Codigo;
+	} else if (Codigo < PAGE_LIMIT && Paginas[Codigo >> 7] != PAGE_NONE) {
+		const uint8_t (*Tabla)[128] = (ROM_actual == LCD_ROM_A00) ? Tabla_A00 : Tabla_A02;
+		Traducido = Tabla[Paginas[Codigo >> 7] - 1][Codigo & 0x7F];
+	}
+
+	// En la A02 casi todo está en ROM; lo que falte lo buscamos entre los glifos
+	if (Traducido == 0 && ROM_actual == LCD_ROM_A02 && Codigo < 0x100) {
+		Traducido = Tabla_A00[PAGE_LATIN1 - 1][Codigo & 0x7F];
+		if (!IS_GLYPH(Traducido)) Traducido = 0;
+	}
+
+	if (Traducido == 0) return LCD_CHARSET_UNKNOWN;
+	if (IS_GLYPH(Traducido)) return LCD_glyph_slot(Traducido);
+	return Traducido;
+}
+
+/*******************************************************************************
+* @brief  Envía una cadena UTF-8, traducida a la ROM del display
+* @param  Cadena UTF-8 terminada en 0
+* @retval None
+* @note   Como LCD_print(), envía a lo sumo LCD_PRINT_MAX caracteres, así su
+*         tiempo tiene cota (ver LCD_wcet.h).
+*/
+void LCD_printUTF8(const char * Cadena) {
+	uint32_t Codigo;
+
+	// Los glifos que use esta cadena no se pueden reemplazar hasta terminarla
+	Inicio_de_texto = ++Reloj_de_uso;
+
+	for (size_t n=0; n<LCD_PRINT_MAX && *Cadena != '\0'; n++) {
+		Cadena = LCD_utf8_decode(Cadena, &Codigo);
+		LCD_write(LCD_translate(Codigo));
+	}
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Devuelve el lugar de CGRAM con el glifo, cargándolo si no estaba
+* @param  Referencia a glifo (GLYPH(n))
+* @retval Lugar de CGRAM o LCD_CHARSET_UNKNOWN si no hay lugar libre
+* @note   No pisa un lugar que está en la DDRAM (según la sombra): el glifo
+*         que ya se ve cambiaría en pantalla. Revisarlo es recorrer a lo
+*         sumo LCD_DDRAM_CELLS celdas, sólo cuando hay que cargar un glifo.
+*/
+static uint8_t LCD_glyph_slot(uint8_t Glifo) {
+	uint8_t Lugar = GLYPH_SLOTS;
+	uint32_t Mas_viejo = UINT32_MAX;
+
+	// ¿Ya está cargado?
+	for (uint8_t i=0; i<GLYPH_SLOTS; i++) {
+		if (Glifo_en_lugar[i] == Glifo) {
+			Uso_de_lugar[i] = ++Reloj_de_uso;
+			return LCD_GLYPH_FIRST_SLOT + i;
+		}
+	}
+
+	// Lugares que se ven: códigos de CGRAM (0 a 7, y sus copias 8 a 15) en la DDRAM
+	uint8_t En_pantalla = 0;
+	uint8_t a = 0;
+	for (uint8_t n=0; n<LCD_DDRAM_CELLS; n++, a=LCD_nextAddress(a)) {
+		uint8_t Codigo = LCD_shadow(a);
+		if (Codigo < 0x10) En_pantalla |= (uint8_t) (1U << (Codigo & 0x07));
+	}
+
+	// Elijo, entre los que no se ven ni usa esta cadena, el usado hace más tiempo
+	for (uint8_t i=0; i<GLYPH_SLOTS; i++) {
+		if (En_pantalla & (1U << (LCD_GLYPH_FIRST_SLOT + i))) continue;
+		if (Uso_de_lugar[i] < Mas_viejo && Uso_de_lugar[i] < Inicio_de_texto) {
+			Mas_viejo = Uso_de_lugar[i];
+			Lugar = i;
+		}
+	}
+	if (Lugar == GLYPH_SLOTS) return LCD_CHARSET_UNKNOWN;	// <-- Todos a la vista o en esta cadena
+
+	// Cargo el glifo y vuelvo a donde estaba el AC (en DDRAM o en CGRAM)
+	uint8_t Direccion = LCD_address();
+	bool En_CGRAM = LCD_cgramSelected();
+	LCD_createChar(LCD_GLYPH_FIRST_SLOT + Lugar, Glifos[GLYPH_INDEX(Glifo)]);
+	LCD_command((En_CGRAM ? LCD_SETCGRAMADDR : LCD_SETDDRAMADDR) | Direccion);
+
+	Glifo_en_lugar[Lugar] = Glifo;
+	Uso_de_lugar[Lugar] = ++Reloj_de_uso;
+	return LCD_GLYPH_FIRST_SLOT + Lugar;
+}
+
+/*******************************************************************************
+* @brief  Decodifica un código UTF-8
+* @param  Texto y dónde dejar el código Unicode
+* @retval Puntero al siguiente código
+* @note   Una secuencia inválida da U+FFFD y avanza sólo lo que tenía de
+*         válido (un byte si empieza mal; si se corta, hasta el byte que la
+*         cortó, que se decodifica después). Las formas largas de más
+*         (C0, C1, E0 80-9F, F0 80-8F), las mitades de UTF-16 (ED A0-BF) y
+*         lo que pasa de U+10FFFF (F4 90-BF, F5-FF) son inválidas.
+*/
+static const char * LCD_utf8_decode(const char * Texto, uint32_t * Codigo) {
+	const uint8_t * t = (const uint8_t *) Texto;
+	uint8_t Largo;
+	uint8_t Minimo = 0x80, Maximo = 0xBF;	// <-- Rango del segundo byte
+
+	if (t[0] < 0x80)      { *Codigo = t[0];        Largo = 1; }
+	else if (t[0] < 0xC2) { *Codigo = 0xFFFD;      return Texto + 1; }
+	else if (t[0] < 0xE0) { *Codigo = t[0] & 0x1F; Largo = 2; }
+	else if (t[0] < 0xF0) { *Codigo = t[0] & 0x0F; Largo = 3; }
+	else if (t[0] < 0xF5) { *Codigo = t[0] & 0x07; Largo = 4; }
+	else                  { *Codigo = 0xFFFD;      return Texto + 1; }
+
+	if (t[0] == 0xE0) Minimo = 0xA0;
+	else if (t[0] == 0xED) Maximo = 0x9F;
+	else if (t[0] == 0xF0) Minimo = 0x90;
+	else if (t[0] == 0xF4) Maximo = 0x8F;
+	if (Largo > 1 && (t[1] < Minimo || t[1] > Maximo)) {
+		*Codigo = 0xFFFD;
+		return Texto + 1;
+	}
+
+	for (uint8_t i=1; i<Largo; i++) {
+		if ((t[i] & 0xC0) != 0x80) {
+			*Codigo = 0xFFFD;
+			return Texto + i;	// <-- Incluye el caso de un 0 final cortando la secuencia
+		}
+		*Codigo = (*Codigo << 6) | (t[i] & 0x3F);
+	}
+	return Texto + Largo;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,175 @@
+/*******************************************************************************
+* @file    LCD_console.c
+* @author  Guillermo Caporaletti
+* @brief   Consola de texto (estilo terminal) con salto de línea y scroll.
+*          El texto se arma en una copia de la ventana en RAM: los saltos de
+*          línea, el corte de renglones largos y el scroll hacia arriba sólo
+*          mueven esa copia. Al enviar, cada celda se compara con la sombra de
+*          la DDRAM y sólo se escriben las que cambian de caracter, de modo que
+*          subir un renglón no reescribe lo que ya coincide y varias líneas
+*          seguidas se envían de una vez.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_console.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static char Pantalla[LCD_CONSOLE_ROWS][LCD_CONSOLE_COLS];	// Lo que debería verse
+static uint8_t Primera = 0;			// Fila del display donde empieza la consola
+static uint8_t Filas = 0;			// 0 hasta un LCD_consoleInit válido
+static uint8_t Columnas = 0;		// Las del display
+static uint8_t Fila = 0;			// Posición de escritura dentro de la consola
+static uint8_t Columna = 0;
+static bool Pendiente = false;		// Salto de línea recibido y aún no aplicado
+static uint8_t Sucias = 0;			// Un bit por fila de la consola a revisar
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_console_newline(void);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Ubica la consola y la deja en blanco
+* @param  Primera fila del display y cantidad de filas (0: hasta la última)
+* @retval true si la región entra en el display (y en LCD_CONSOLE_COLS x
+*         LCD_CONSOLE_ROWS); si no, la consola queda desactivada
+* @note   Llamar luego de LCD_init. La consola ocupa todo el ancho del
+*         display. El resto de las filas queda libre para otros usos (por
+*         ejemplo, una fila de estado con LCD_field).
+*/
+bool LCD_consoleInit(uint8_t row, uint8_t rows) {
+	uint8_t Lineas = LCD_lines();
+
+	if (row < Lineas && rows == 0) rows = Lineas - row;
+	if (row >= Lineas || rows > Lineas - row || rows > LCD_CONSOLE_ROWS || LCD_columns() > LCD_CONSOLE_COLS) {
+		Filas = 0;
+		return false;
+	}
+	Primera = row;
+	Filas = rows;
+	Columnas = LCD_columns();
+	LCD_consoleClear();
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Agrega un caracter a la consola (no lo envía)
+* @param  Caracter
+* @retval None
+* @note   '\n' baja a la línea siguiente (y vuelve a la columna 0), '\r' vuelve
+*         a la columna 0, '\b' retrocede una columna y '\f' borra la consola.
+*         El salto de línea y el corte de un renglón lleno se aplican recién
+*         con el caracter siguiente: la última línea queda a la vista y no una
+*         línea vacía.
+*/
+void LCD_consolePut(char Caracter) {
+	if (Filas == 0) return;
+
+	switch (Caracter) {
+	case '\n':
+		if (Pendiente) LCD_console_newline();
+		Pendiente = true;
+		break;
+
+	case '\r':
+		if (!Pendiente) Columna = 0;
+		break;
+
+	case '\b':
+		if (Columna > 0) Columna--;
+		break;
+
+	case '\f':
+		memset(Pantalla, ' ', sizeof(Pantalla));
+		Fila = 0;
+		Columna = 0;
+		Pendiente = false;
+		Sucias = (uint8_t) ((1U << Filas) - 1);
+		break;
+
+	default:
+		if (Pendiente || Columna >= Columnas) LCD_console_newline();
+		Pantalla[Fila][Columna++] = Caracter;
+		Sucias |= (uint8_t) (1U << Fila);
+		break;
+	}
+}
+
+/*******************************************************************************
+* @brief  Envía al LCD las celdas de la consola que difieren de la sombra
+* @param  None
+* @retval None
+* @note   Supone escritura de izquierda a derecha (LCD_leftToRight). Sólo
+*         manda la dirección cuando el AC no quedó ya en la celda.
+*/
+void LCD_consoleFlush(void) {
+	uint8_t Orden[LCD_MAX_LINES];
+	uint8_t Lineas = LCD_rowOrder(Orden);
+
+	// Filas en orden de DDRAM: el AC sigue solo de una fila a la siguiente
+	for (uint8_t i=0; Sucias != 0 && i<Lineas; i++) {
+		uint8_t row = Orden[i];
+		if (row < Primera || row >= Primera + Filas) continue;
+		uint8_t r = row - Primera;
+		if ((Sucias & (1U << r)) == 0) continue;
+
+		for (uint8_t col=0; col<Columnas; col++) {
+			uint8_t Caracter = (uint8_t) Pantalla[r][col];
+			if (LCD_cellShadow(col, row) == Caracter) continue;
+
+			if (!LCD_cursorAt(col, row)) LCD_setCursor(col, row);
+			LCD_write(Caracter);
+		}
+		Sucias &= (uint8_t) ~(1U << r);
+	}
+}
+
+/*******************************************************************************
+* @brief  Escribe texto en la consola y lo envía
+* @param  Texto terminado en '\0'
+* @retval None
+*/
+void LCD_consolePrint(const char * Texto) {
+	while (*Texto != '\0') LCD_consolePut(*Texto++);
+	LCD_consoleFlush();
+}
+
+/*******************************************************************************
+* @brief  Borra la consola y vuelve al comienzo
+* @param  None
+* @retval None
+*/
+void LCD_consoleClear(void) {
+	LCD_consolePut('\f');
+	LCD_consoleFlush();
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Pasa a una línea nueva, subiendo todo un renglón si no hay lugar
+* @param  None
+* @retval None
+* @note   Sólo mueve la copia en RAM: las filas que suben se envían luego,
+*         celda por celda, si difieren de lo que ya muestra el display.
+*/
+static void LCD_console_newline(void) {
+	Pendiente = false;
+	Columna = 0;
+
+	if (Fila + 1 < Filas) {
+		Fila++;
+	} else {
+		memmove(Pantalla[0], Pantalla[1], (size_t) (Filas - 1) * LCD_CONSOLE_COLS);
+		Sucias = (uint8_t) ((1U << Filas) - 1);
+	}
+
+	memset(Pantalla[Fila], ' ', LCD_CONSOLE_COLS);
+	Sucias |= (uint8_t) (1U << Fila);
+}
+
+/***************************************************************END OF FILE****/
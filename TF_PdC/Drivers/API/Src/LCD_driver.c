@@ -1,470 +1,1791 @@
-/*******************************************************************************
-* @file    API_LCD.c
-* @author  Guillermo Caporaletti
-* @brief   Controlador de LCD alimentado por HD44780.
-********************************************************************************
-*/
-
-/* Includes ------------------------------------------------------------------*/
-
-#include <LCD_driver.h>
-
-/* Types ---------------------------------------------------------------------*/
-
-/* Private variables ---------------------------------------------------------*/
-
-static LCDconfig miLCD;
-
-/* Private function prototypes -----------------------------------------------*/
-
-static void LCD_send(uint8_t value, uint8_t mode);
-static void LCD_write4bits(uint8_t value);
-static void LCD_write8bits(uint8_t value);
-static uint8_t LCD_receive(uint8_t Registro);
-static uint8_t LCD_read4bits(void);
-static uint8_t LCD_read8bits(void);
-static void LCD_pulseEnable();
-
-/* Functions -----------------------------------------------------------------*/
-
-/*******************************************************************************
-* @brief  Inicializa LCD
-* @param  None
-* @retval None
-*/
-void LCD_init() {
-	// Configuro el hardware de la conexión con el LCD:
-	LCD_init_stm32f4xx(&miLCD);
-
-	// Ver pp. 45-46 sobre las especificaciones de inicialización:
-	// Lo primero a enviar es para establecer una conexión de 4 pines o de 8 pines.
-	// Según la hoja de datos, debemos esperar más de 40ms antes de enviar comandos.
-	delayMilliseconds(50);
-
-	// Ahora reseteamos RS, RW y ENABLE para iniciar comandos
-	digitalWrite(miLCD.rs_port, miLCD.rs_pin, GPIO_PIN_RESET);
-	digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);
-	if (miLCD.rw_port != DISCONNECTED_PIN) {
-		// Quiere decir que RW está conectado a un pinout (y no GND)
-		digitalWrite(miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_RESET);
-	}
-
-	// Establecemos modo 4 bit o 8 bit del LCD
-	if ((miLCD.displayfunction & LCD_8BITMODE) == false) {
-	    // Según tengo almacenado en _displayfunction,
-		// tengo sólo 4 pines de datos conectados.
-		// Secuencia según figura 24, pg. 46:
-
-	    // Indicamos 4 bit mode (y esperamos al menos 4.1ms)
-		LCD_write4bits(0x03);
-	    delayMilliseconds(5);
-
-	    // Indicamos por segunda vez (y esperamos al menos 100us)
-	    LCD_write4bits(0x03);
-	    delayMilliseconds(1);
-
-	    // Indicamos por tercera vez!
-	    LCD_write4bits(0x03);
-	    delayMilliseconds(1);
-
-	    // Configuramos 4-bit:
-	    LCD_write4bits(0x02);
-	} else {
-	    // Tengo 8 pines de datos.
-		// Secuencia según pg. 45, figura 23:
-
-	    // Indicamos 8 bit mode (y esperamos al menos 4.1ms)
-	    LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
-	    delayMilliseconds(6);
-
-	    // Segunda vez (al meos 100us)
-	    LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
-	    delayMilliseconds(1);
-
-	    // Tercera
-	    LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
-	 }
-
-	 // Finalmente, enviamos comandos:
-	 // Establecemos número de líneas, tamaño de fuente, etc. (con display off)
-	 LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
-
-	 // turn the display on with no cursor or blinking default (ahora display on)
-	 miLCD.displaycontrol = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
-	 LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-
-	 // Borramos pantalla
-	 LCD_clear();
-
-	 // Initialize to default text direction (for romance languages)
-	 miLCD.displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
-	 LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
-
-}
-
-/*******************************************************************************
-* @brief  Borra pantalla y posiciona el cursor en 0
-* @param  None
-* @retval None
-*/
-void LCD_clear() {
-	 LCD_command(LCD_CLEARDISPLAY);
-	 for (uint16_t i=0; (i<MAX_COUNT && LCD_busy_flag()); i++) {
-		 // Just keep on walking...
-	 }
-}
-
-/*******************************************************************************
-* @brief  Posiciona el cursor en 0
-* @param  None
-* @retval None
-*/
-void LCD_home() {
-	 LCD_command(LCD_RETURNHOME);
-	 for (uint16_t i=0; (i<MAX_COUNT && LCD_busy_flag()); i++) {}
-}
-
-/*******************************************************************************
-* @brief  Ubica al cursor
-* @param  Columna y Fila
-* @retval None
-*/
-void LCD_setCursor(uint8_t col, uint8_t row)
-{
-  const size_t max_lines = sizeof(miLCD.row_offsets) / sizeof(miLCD.row_offsets[0]);
-  if ( row >= max_lines ) {
-    row = max_lines - 1;    // we count rows starting w/0
-  }
-  if ( row >= miLCD.numlines ) {
-    row = miLCD.numlines - 1;    // we count rows starting w/0
-  }
-  LCD_command(LCD_SETDDRAMADDR | (col + miLCD.row_offsets[row]));
-}
-
-/*******************************************************************************
-* @brief  Apaga y prende display
-* @param  None
-* @retval None
-*/
-void LCD_noDisplay() {
-  miLCD.displaycontrol &= ~LCD_DISPLAYON;
-  LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-}
-void LCD_display() {
-  miLCD.displaycontrol |= LCD_DISPLAYON;
-  LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-}
-
-/*******************************************************************************
-* @brief  Saca o pone cursor
-* @param  None
-* @retval None
-*/
-void LCD_noCursor() {
-	miLCD.displaycontrol &= ~LCD_CURSORON;
-	LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-}
-void LCD_cursor() {
-	miLCD.displaycontrol |= LCD_CURSORON;
-	LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-}
-
-/*******************************************************************************
-* @brief  Prende y apaga parpadeo de cursor
-* @param  None
-* @retval None
-*/
-void LCD_noBlink() {
-	miLCD.displaycontrol &= ~LCD_BLINKON;
-  LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-}
-void LCD_blink() {
-  miLCD.displaycontrol |= LCD_BLINKON;
-  LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
-}
-
-/*******************************************************************************
-* @brief  Scroll el display sin cambiar la RAM
-* @param  None
-* @retval None
-*/
-void LCD_scrollDisplayLeft(void) {
-  LCD_command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT);
-}
-void LCD_scrollDisplayRight(void) {
-  LCD_command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVERIGHT);
-}
-
-/*******************************************************************************
-* @brief  Texto de izquierda a derecha y viceversa
-* @param  None
-* @retval None
-*/
-void LCD_leftToRight(void) {
-  miLCD.displaymode |= LCD_ENTRYLEFT;
-  LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
-}
-void LCD_rightToLeft(void) {
-  miLCD.displaymode &= ~LCD_ENTRYLEFT;
-  LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
-}
-
-/*******************************************************************************
-* @brief  Activa y desactiva autoscroll
-* @param  None
-* @retval None
-*/
-void LCD_autoscroll(void) {
-  miLCD.displaymode |= LCD_ENTRYSHIFTINCREMENT;
-  LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
-}
-void LCD_noAutoscroll(void) {
-  miLCD.displaymode &= ~LCD_ENTRYSHIFTINCREMENT;
-  LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
-}
-
-/*******************************************************************************
-* @brief  Crear caracter
-* @param  direccion y mapa del caracter
-* @retval None
-*/
-void LCD_createChar(uint8_t location, uint8_t charmap[]) {
-  location &= 0x7; // we only have 8 locations 0-7
-  LCD_command(LCD_SETCGRAMADDR | (location << 3));
-  for (int i=0; i<8; i++) {
-    LCD_write(charmap[i]);
-  }
-}
-
-/*******************************************************************************
-* @brief  Envía una cadena de caracteres
-* @param  Cadena de caracteres
-* @retval None
-*/
-void LCD_print(char * Cadena) {
-	size_t Largo = strlen(Cadena);
-	for (size_t i=0; i<Largo; i++) {
-		LCD_write((uint8_t) Cadena[i]);
-	}
-}
-
-/* Funciones nivel medio -----------------------------------------------------*/
-
-/*******************************************************************************
-* @brief  Envía un dato al LCD
-* @param  Dato de 8 bits
-* @retval None
-*/
-void LCD_write(uint8_t value) {
-  LCD_send(value, GPIO_PIN_SET);
-}
-
-/*******************************************************************************
-* @brief  Envía un comando al LCD
-* @param  Comando
-* @retval None
-*/
-void LCD_command(uint8_t value) {
-	LCD_send(value, GPIO_PIN_RESET);
-}
-
-/*******************************************************************************
-* @brief  Lee el registro de dirección y Busy flag desde el LCD
-* @param  None
-* @retval Registro de instrucción
-*/
-uint8_t LCD_address_read(void) {
-	return LCD_receive(GPIO_PIN_RESET);
-}
-
-/*******************************************************************************
-* @brief  Lee el registro de dirección y Busy flag desde el LCD
-* @param  None
-* @retval Registro de instrucción
-*/
-uint8_t LCD_data_read(void) {
-	return LCD_receive(GPIO_PIN_SET);
-}
-
-/*******************************************************************************
-* @brief  Envía comando o dato, con 8 o 4 pines conectados
-* @param  Puntero a LCD, valor a enviar y modo (comando o dato)
-* @retval None
-*/
-static void LCD_send(uint8_t value, uint8_t mode) {
-  digitalWrite(miLCD.rs_port, miLCD.rs_pin, (GPIO_PinState) mode);
-
-  // Si RW está, lo bajamos para escribir
-  if (miLCD.rw_port != DISCONNECTED_PIN) {
-	digitalWrite(miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_RESET);
-  }
-
-  // Debo poner pines de datos en modo escritura...
-  if (miLCD.rw_config != WRITE_MODE) LCD_write_mode(&miLCD);
-
-  // Veo si mando de a 4 bits o de a 8 bits
-  if (miLCD.displayfunction & LCD_8BITMODE) {
-	LCD_write8bits(value);
-  } else {
-    LCD_write4bits(value>>4);
-    LCD_write4bits(value);
-  }
-}
-
-/*******************************************************************************
-* @brief  Lee registro de Instrucción o Dato
-* @param  Puntero a LCD, valor a enviar y modo (comando o dato)
-* @retval Byte leído
-*/
-static uint8_t LCD_receive(uint8_t Registro) {
-	uint8_t LecturaByte = 0;
-
-	// Primero verifico que el pin RW esté conectado:
-	if (miLCD.rw_port == NULL) Error_Handler();					// <-- No está conectado!!!
-	digitalWrite(miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_SET);	// <-- Modo lectura.
-
-	// Luego selecciono el registro Instrucción o Dato
-	digitalWrite(miLCD.rs_port, miLCD.rs_pin, (GPIO_PinState) Registro);
-
-	// Debo poner pines de datos en modo lectura...
-	if (miLCD.rw_config != READ_MODE) LCD_read_mode(&miLCD);
-
-	// Leo los pines: evalúo si leo de a 4 bits o de a 8 bits
-	if (miLCD.fourbitmode == true) {
- 	  LecturaByte =  LCD_read4bits() << 4;
-      LecturaByte |= LCD_read4bits();
-	} else {
-	  LecturaByte = LCD_read8bits();
-	}
-
-	// Listo!!!
-	return LecturaByte;
-}
-
-/*******************************************************************************
-* @brief  Lee BUSY FLAG
-* @param  NONE
-* @retval Estado de BUSY FLAG
-*/
-bool LCD_busy_flag(void) {
-	bool Lectura = true;
-
-	// Primero verifico que el pin RW esté conectado y pongo en lectura:
-	if (miLCD.rw_port == DISCONNECTED_PIN) return Lectura;	// Como no sé si está ocupado, devuelvo OCUPADO
-	digitalWrite(miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_SET);	// <-- Modo lectura.
-
-	// Luego selecciono el registro de ADDRESS y BUSY FLAG
-	digitalWrite(miLCD.rs_port, miLCD.rs_pin, GPIO_PIN_RESET);
-
-	// Debo poner pines de datos en modo lectura...
-	if (miLCD.rw_config != READ_MODE) LCD_read_mode(&miLCD);
-
-	// Activo ENABLE y leo EL PIN de busy flag:
-    digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_SET);		// <-- Flanco ascendente de ENABLE
-	if (miLCD.fourbitmode == true) {
-		// Leo en modo 4 pines
-		Lectura = (bool) digitalRead(miLCD.data_ports[3], miLCD.data_pins[3]);
-		// Mando pulso para saltear siguiente lectura
-		digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);
-	    digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_SET);
-	} else {
-		// Leo en modo 8 pines
-		Lectura = (bool) digitalRead(miLCD.data_ports[7], miLCD.data_pins[7]);
-	}
-    digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);		// <-- Flanco descendente de ENABLE
-
-	// Listo!!!
-	return Lectura;
-}
-
-/*******************************************************************************
-* @brief  Manda un pulso de lectura "enable"
-* @param  None
-* @retval None
-*/
-static void LCD_pulseEnable() {
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);
-  delayMicro(1);	// debería ser 1us
-
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_SET);
-  delayMicro(10);	// debería ser > 450ns
-
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);
-  delayMicro(1);	// debería ser > 37us
-}
-
-/*******************************************************************************
-* @brief  Escribe valor en 4 pines (en dos veces)
-* @param  Valor
-* @retval None
-*/
-static void LCD_write4bits(uint8_t value) {
-  for (int i = 0; i < 4; i++) {
-    digitalWrite(miLCD.data_ports[i], miLCD.data_pins[i], (value >> i) & 0x01);
-  }
-  LCD_pulseEnable();
-}
-
-/*******************************************************************************
-* @brief  Escribe valor en los 8 pines
-* @param  Valor
-* @retval None
-*/
-static void LCD_write8bits(uint8_t value) {
-  for (int i = 0; i < 8; i++) {
-    digitalWrite(miLCD.data_ports[i], miLCD.data_pins[i], (value >> i) & 0x01);
-  }
-  LCD_pulseEnable();
-}
-
-/*******************************************************************************
-* @brief  Lee valores en los 8 pines
-* @param  None
-* @retval Byte leído
-*/
-static uint8_t LCD_read8bits(void) {
-  // Verifico conexión 8 pines
-  if (miLCD.fourbitmode == true) Error_Handler();
-
-  // Byte a leer bit por bit
-  uint8_t LecturaByte = 0;
-  GPIO_PinState LecturaPin = GPIO_PIN_RESET;
-
-  // Envío ENABLE y leo
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_SET);		// <-- Flanco ascendente de ENABLE
-  for (int i = 0; i < 8; i++) {
-	  LecturaPin = digitalRead(miLCD.data_ports[i], miLCD.data_pins[i]);
-	  LecturaByte |= (LecturaPin << i);
-  }
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);	// <-- Flanco descendente de ENABLE
-
-  // Leído!!!
-  return LecturaByte;
-}
-
-/*******************************************************************************
-* @brief  Lee valores en 4 pines
-* @param  None
-* @retval Byte leído (entre 0 y 16)
-*/
-static uint8_t LCD_read4bits(void) {
-  // Verifico conexión 4 pines
-  if (miLCD.fourbitmode == false) Error_Handler();
-
-  // Byte a leer bit por bit
-  uint8_t LecturaByte = 0;
-  GPIO_PinState LecturaPin = GPIO_PIN_RESET;
-
-  // Envío ENABLE y leo
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_SET);		// <-- Flanco ascendente de ENABLE
-  for (int i = 0; i < 4; i++) {
-	  LecturaPin = digitalRead(miLCD.data_ports[i], miLCD.data_pins[i]);
-	  LecturaByte |= (LecturaPin << i);
-  }
-  digitalWrite(miLCD.enable_port, miLCD.enable_pin, GPIO_PIN_RESET);	// <-- Flanco descendente de ENABLE
-
-  // Leído!!!
-  return LecturaByte;
-}
-
-/***************************************************************END OF FILE****/
+/*******************************************************************************
+* @file    API_LCD.c
+* @author  Guillermo Caporaletti
+* @brief   Controlador de LCD alimentado por HD44780.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+#ifdef LCD_TRACE
+#include <LCD_trace.h>
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+
+// Tiempos del perfil en uso, ya convertidos a ciclos del núcleo
+typedef struct {
+	uint32_t as;
+	uint32_t pweh;
+	uint32_t ddr;
+	uint32_t h;
+	uint32_t cycle;
+	uint32_t exec;
+	uint32_t clear;
+} LCDtimingCycles;
+
+/* Exported constants --------------------------------------------------------*/
+
+const LCDtiming LCD_timing_HD44780 = {
+	LCD_T_AS_NS, LCD_T_PWEH_NS, LCD_T_DDR_NS, LCD_T_H_NS, LCD_T_CYCLE_NS, LCD_T_EXEC_US, LCD_T_CLEAR_US, 0
+};
+// Samsung KS0066: oscilador algo más lento (39 us / 1,53 ms)
+const LCDtiming LCD_timing_KS0066 = {
+	60, 450, 360, 20, 1000, 39, 1530, 0
+};
+// Sitronix ST7066U
+const LCDtiming LCD_timing_ST7066U = {
+	60, 460, 360, 20, 1000, 37, 1520, 0
+};
+// Sunplus SPLC780: con el oscilador en su mínimo los tiempos se estiran
+const LCDtiming LCD_timing_SPLC780 = {
+	60, 450, 360, 20, 1000, 43, 1640, 0
+};
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCDconfig miLCD;
+static LCDtimingCycles Ciclos;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_send(uint8_t value, uint8_t mode);
+static void LCD_write4bits(uint8_t value);
+static void LCD_write8bits(uint8_t value);
+static uint8_t LCD_receive(uint8_t Registro);
+static uint8_t LCD_read4bits(void);
+static uint8_t LCD_read8bits(void);
+static void LCD_pulseEnable();
+static void LCD_enable_high(void);
+static void LCD_enable_low(void);
+static void LCD_enable_write(GPIO_PinState Estado);
+static void LCD_fmc_period(void);
+static uint8_t LCD_read_select(void);
+static void LCD_command_all(uint8_t value);
+static void LCD_display_control(void);
+static void LCD_entry_mode(void);
+static void LCD_send_pending(bool Forzar);
+static void LCD_split_focus(uint8_t display);
+static uint8_t LCD_clamp_row(uint8_t row);
+static void LCD_wait_ready(void);
+static void LCD_busy_poll(void);
+static bool LCD_busy_arm(void);
+static void LCD_busy_sleep(void);
+static void LCD_busy_enable(GPIO_PinState Estado);
+static bool LCD_lost_display(uint8_t d);
+static void LCD_sync_interface(void);
+static void LCD_replay_display(uint8_t d);
+static void LCD_track_command(uint8_t value);
+static void LCD_track_move(bool Incremento);
+static uint8_t LCD_next_address(uint8_t a, bool Incremento);
+static void LCD_track_shift(uint8_t d, bool Derecha);
+static uint8_t LCD_visible_address(uint8_t d, uint8_t col, uint8_t row);
+static uint8_t LCD_shifted_address(uint8_t col, uint8_t row, uint8_t Desplazamiento);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Inicializa LCD
+* @param  None
+* @retval None
+*/
+void LCD_init() {
+	// Configuro el hardware de la conexión con el LCD:
+	LCD_init_stm32f4xx(&miLCD);
+	LCD_setTiming(&miLCD.timing);
+	LCD_select((1U << miLCD.displays) - 1);		// <-- Se inicializan todos juntos
+	memset(miLCD.cgram_known, 0, sizeof(miLCD.cgram_known));	// <-- CGRAM indefinida al encender
+	miLCD.control_pending = miLCD.mode_pending = false;
+	miLCD.busy_armed = false;
+#ifdef LCD_TRACE
+	LCD_traceInit(&miLCD);
+#endif
+
+	// Ver pp. 45-46 sobre las especificaciones de inicialización:
+	// Lo primero a enviar es para establecer una conexión de 4 pines o de 8 pines.
+	// Según la hoja de datos, debemos esperar más de 40ms antes de enviar comandos.
+	delayMilliseconds(50);
+
+	// Ahora reseteamos RS, RW y ENABLE para iniciar comandos
+	// (con el bus FMC no hace falta: los maneja el FMC en cada acceso)
+	if (miLCD.fmc == NULL) {
+		strobeWrite(miLCD.rs_bb, miLCD.rs_port, miLCD.rs_pin, GPIO_PIN_RESET);
+		LCD_enable_write(GPIO_PIN_RESET);
+		if (miLCD.rw_port != DISCONNECTED_PIN) {
+			// Quiere decir que RW está conectado a un pinout (y no GND)
+			strobeWrite(miLCD.rw_bb, miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_RESET);
+		}
+	}
+
+	// Establecemos modo 4 bit o 8 bit del LCD
+	if ((miLCD.displayfunction & LCD_8BITMODE) == false) {
+	    // Según tengo almacenado en _displayfunction,
+		// tengo sólo 4 pines de datos conectados.
+		// Secuencia según figura 24, pg. 46:
+
+	    // Indicamos 4 bit mode (y esperamos al menos 4.1ms)
+		LCD_write4bits(0x03);
+	    delayMilliseconds(5);
+
+	    // Indicamos por segunda vez (y esperamos al menos 100us)
+	    LCD_write4bits(0x03);
+	    delayMilliseconds(1);
+
+	    // Indicamos por tercera vez!
+	    LCD_write4bits(0x03);
+	    delayMilliseconds(1);
+
+	    // Configuramos 4-bit:
+	    LCD_write4bits(0x02);
+	    delayCycles(Ciclos.exec);
+	} else {
+	    // Tengo 8 pines de datos.
+		// Secuencia según pg. 45, figura 23:
+
+	    // Indicamos 8 bit mode (y esperamos al menos 4.1ms)
+	    LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
+	    delayMilliseconds(6);
+
+	    // Segunda vez (al meos 100us)
+	    LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
+	    delayMilliseconds(1);
+
+	    // Tercera
+	    LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
+	 }
+
+	 // Finalmente, enviamos comandos:
+	 // Establecemos número de líneas, tamaño de fuente, etc. (con display off)
+	 LCD_command(LCD_FUNCTIONSET | miLCD.displayfunction);
+
+	 // turn the display on with no cursor or blinking default (ahora display on)
+	 miLCD.displaycontrol = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
+	 LCD_command(LCD_DISPLAYCONTROL | miLCD.displaycontrol);
+
+	 // Borramos pantalla
+	 LCD_clear();
+
+	 // Initialize to default text direction (for romance languages)
+	 miLCD.displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
+	 LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
+
+	 // Con dos controladores, el cursor queda en la fila 0
+	 if (miLCD.split) LCD_split_focus(miLCD.row_display[0]);
+}
+
+/*******************************************************************************
+* @brief  Borra pantalla y posiciona el cursor en 0
+* @param  None
+* @retval None
+*/
+void LCD_clear() {
+	 if (miLCD.split) {
+		 // Los dos controladores borran a la vez: no espero acá, cada
+		 // uno recibirá lo siguiente cuando termine (ver LCD_wait_ready)
+		 LCD_command_all(LCD_CLEARDISPLAY);
+		 LCD_split_focus(miLCD.row_display[0]);
+		 return;
+	 }
+	 LCD_command(LCD_CLEARDISPLAY);
+	 if (LCD_busy_arm()) return;		// <-- Termina por interrupción (ver LCD_busyEvent)
+	 LCD_busy_poll();
+}
+
+/*******************************************************************************
+* @brief  Posiciona el cursor en 0
+* @param  None
+* @retval None
+*/
+void LCD_home() {
+	 if (miLCD.split) {
+		 LCD_command_all(LCD_RETURNHOME);
+		 LCD_split_focus(miLCD.row_display[0]);
+		 return;
+	 }
+	 LCD_command(LCD_RETURNHOME);
+	 if (LCD_busy_arm()) return;		// <-- Termina por interrupción (ver LCD_busyEvent)
+	 LCD_busy_poll();
+}
+
+/*******************************************************************************
+* @brief  Ubica al cursor
+* @param  Columna y Fila
+* @retval None
+*/
+void LCD_setCursor(uint8_t col, uint8_t row)
+{
+  if (miLCD.split) LCD_split_focus(LCD_cellDisplay(col, row));	// <-- Elijo el controlador de la fila
+  LCD_command(LCD_SETDDRAMADDR | LCD_cellAddress(col, row));
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM de una posición de pantalla
+* @param  Columna y Fila
+* @retval Dirección de DDRAM
+*/
+uint8_t LCD_cellAddress(uint8_t col, uint8_t row)
+{
+  return col + miLCD.row_offsets[LCD_clamp_row(row)];
+}
+
+/*******************************************************************************
+* @brief  Display (controlador) que muestra una posición de pantalla
+* @param  Columna y Fila
+* @retval Display: el de la fila con dos controladores; si no, el primero elegido
+*/
+uint8_t LCD_cellDisplay(uint8_t col, uint8_t row)
+{
+  (void) col;
+  return miLCD.split ? miLCD.row_display[LCD_clamp_row(row)] : miLCD.primary;
+}
+
+/*******************************************************************************
+* @brief  Filas en el orden de sus direcciones de DDRAM (por controlador)
+* @param  Orden (LCD_MAX_LINES lugares)
+* @retval Cantidad de filas
+* @note   En pantallas de 4 filas, la fila 2 sigue en DDRAM a la 0 y la 3 a
+*         la 1 (ver row_offsets): recorriendo las filas en este orden, el AC
+*         pasa solo del final de una fila al principio de la siguiente y un
+*         tramo de cambios que cruza de fila no necesita otra dirección.
+*/
+uint8_t LCD_rowOrder(uint8_t Orden[LCD_MAX_LINES])
+{
+  uint8_t Cantidad = (miLCD.numlines < LCD_MAX_LINES) ? miLCD.numlines : LCD_MAX_LINES;
+
+  for (uint8_t i=0; i<Cantidad; i++) {
+    uint16_t Clave = (uint16_t) (LCD_cellDisplay(0, i) << 8) | LCD_cellAddress(0, i);
+    uint8_t j = i;
+    while (j > 0 && ((uint16_t) (LCD_cellDisplay(0, Orden[j-1]) << 8) | LCD_cellAddress(0, Orden[j-1])) > Clave) {
+      Orden[j] = Orden[j-1];
+      j--;
+    }
+    Orden[j] = i;
+  }
+  return Cantidad;
+}
+
+/*******************************************************************************
+* @brief  Copia en sombra de una posición de pantalla
+* @param  Columna y Fila
+* @retval Caracter
+*/
+uint8_t LCD_cellShadow(uint8_t col, uint8_t row)
+{
+  return LCD_shadowOf(LCD_cellDisplay(col, row), LCD_cellAddress(col, row));
+}
+
+/*******************************************************************************
+* @brief  Caracter que se ve en una posición de pantalla (según la sombra)
+* @param  Columna y Fila
+* @retval Caracter, o ' ' con el display apagado
+* @note   A diferencia de LCD_cellShadow(), tiene en cuenta el desplazamiento
+*         del display (scroll y autoscroll).
+*/
+uint8_t LCD_cellVisible(uint8_t col, uint8_t row)
+{
+  if ((miLCD.displaycontrol & LCD_DISPLAYON) == 0) return ' ';
+  uint8_t d = LCD_cellDisplay(col, row);
+  return LCD_shadowOf(d, LCD_visible_address(d, col, row));
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM que se vería en una posición tras desplazar
+* @param  Columna, fila y desplazamientos a agregar (LCD_scrollDisplayLeft
+*         positivos, LCD_scrollDisplayRight negativos; 0 es lo que se ve ahora)
+* @retval Dirección de DDRAM
+*/
+uint8_t LCD_scrolledAddress(uint8_t col, uint8_t row, int8_t Desplazamientos)
+{
+  int16_t Largo = (miLCD.displayfunction & LCD_2LINE) ? LCD_DDRAM_CELLS / 2 : LCD_DDRAM_CELLS;
+  int16_t Desplazamiento = (int16_t) ((miLCD.shift[LCD_cellDisplay(col, row)] + Desplazamientos) % Largo);
+  if (Desplazamiento < 0) Desplazamiento += Largo;
+  return LCD_shifted_address(col, row, (uint8_t) Desplazamiento);
+}
+
+/*******************************************************************************
+* @brief  Indica si el cursor (subrayado) se ve en una posición de pantalla
+* @param  Columna y Fila
+* @retval true si el display y el cursor están prendidos y el AC está ahí
+* @note   Con dos controladores sólo se prende el cursor del que tiene el
+*         foco. No tiene en cuenta el parpadeo.
+*/
+bool LCD_cursorShown(uint8_t col, uint8_t row)
+{
+  if ((miLCD.displaycontrol & (LCD_DISPLAYON | LCD_CURSORON)) != (LCD_DISPLAYON | LCD_CURSORON)) return false;
+  uint8_t d = LCD_cellDisplay(col, row);
+  if (miLCD.split && d != miLCD.focus) return false;
+  return !miLCD.cgram_selected[d] && miLCD.address[d] == LCD_visible_address(d, col, row);
+}
+
+/*******************************************************************************
+* @brief  Indica si el próximo LCD_write() cae en una posición de pantalla
+* @param  Columna y Fila
+* @retval true si el controlador de la fila está elegido y su AC está ahí
+* @note   Sirve para no reenviar la dirección cuando el AC ya quedó en el lugar.
+*/
+bool LCD_cursorAt(uint8_t col, uint8_t row)
+{
+  if (miLCD.split && miLCD.selected != (1U << LCD_cellDisplay(col, row))) return false;
+  return !LCD_cgramSelected() && LCD_address() == LCD_cellAddress(col, row);
+}
+
+/*******************************************************************************
+* @brief  Apaga y prende display
+* @param  None
+* @retval None
+*/
+void LCD_noDisplay() {
+  miLCD.displaycontrol &= ~LCD_DISPLAYON;
+  LCD_display_control();
+}
+void LCD_display() {
+  miLCD.displaycontrol |= LCD_DISPLAYON;
+  LCD_display_control();
+}
+
+/*******************************************************************************
+* @brief  Saca o pone cursor
+* @param  None
+* @retval None
+*/
+void LCD_noCursor() {
+	miLCD.displaycontrol &= ~LCD_CURSORON;
+	LCD_display_control();
+}
+void LCD_cursor() {
+	miLCD.displaycontrol |= LCD_CURSORON;
+	LCD_display_control();
+}
+
+/*******************************************************************************
+* @brief  Prende y apaga parpadeo de cursor
+* @param  None
+* @retval None
+*/
+void LCD_noBlink() {
+	miLCD.displaycontrol &= ~LCD_BLINKON;
+  LCD_display_control();
+}
+void LCD_blink() {
+  miLCD.displaycontrol |= LCD_BLINKON;
+  LCD_display_control();
+}
+
+/*******************************************************************************
+* @brief  Scroll el display sin cambiar la RAM
+* @param  None
+* @retval None
+*/
+void LCD_scrollDisplayLeft(void) {
+  LCD_command_all(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT);
+}
+void LCD_scrollDisplayRight(void) {
+  LCD_command_all(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVERIGHT);
+}
+
+/*******************************************************************************
+* @brief  Texto de izquierda a derecha y viceversa
+* @param  None
+* @retval None
+*/
+void LCD_leftToRight(void) {
+  miLCD.displaymode |= LCD_ENTRYLEFT;
+  LCD_entry_mode();
+}
+void LCD_rightToLeft(void) {
+  miLCD.displaymode &= ~LCD_ENTRYLEFT;
+  LCD_entry_mode();
+}
+
+/*******************************************************************************
+* @brief  Activa y desactiva autoscroll
+* @param  None
+* @retval None
+*/
+void LCD_autoscroll(void) {
+  miLCD.displaymode |= LCD_ENTRYSHIFTINCREMENT;
+  LCD_entry_mode();
+}
+void LCD_noAutoscroll(void) {
+  miLCD.displaymode &= ~LCD_ENTRYSHIFTINCREMENT;
+  LCD_entry_mode();
+}
+
+/*******************************************************************************
+* @brief  Difiere (o no) los cambios de displaycontrol y modo de escritura
+* @param  true para diferirlos
+* @retval None
+* @note   Diferidos, LCD_cursor(), LCD_blink(), LCD_autoscroll(), etc. sólo
+*         anotan el cambio; sale un único comando (por tipo y controlador)
+*         antes del próximo envío o con LCD_flush(), y ninguno si el estado
+*         quedó como el que ya tiene el controlador. Sin pantalla dividida,
+*         va a los displays elegidos en ese momento. Al dejar de diferir se
+*         envía lo pendiente.
+*/
+void LCD_deferControl(bool Diferir) {
+  miLCD.deferred = Diferir;
+  if (!Diferir) LCD_flush();
+}
+
+/*******************************************************************************
+* @brief  Envía ya los cambios diferidos de displaycontrol y modo de escritura
+* @param  None
+* @retval None
+* @note   Hace falta sólo si no se va a enviar otra cosa (por ejemplo, antes
+*         de una espera con el cursor recién encendido).
+*/
+void LCD_flush(void) {
+  if (miLCD.control_pending || miLCD.mode_pending) LCD_send_pending(false);
+}
+
+/*******************************************************************************
+* @brief  Crear caracter
+* @param  direccion y mapa del caracter
+* @retval None
+*/
+void LCD_createChar(uint8_t location, const uint8_t charmap[]) {
+  // Con dos controladores, el caracter se carga en los dos a la vez
+  uint8_t Seleccion = miLCD.selected;
+  if (miLCD.split) LCD_select((1U << miLCD.displays) - 1);
+
+  location &= (LCD_CGRAM_SIZE / LCD_GLYPH_ROWS) - 1; // we only have 8 locations 0-7
+  LCD_command(LCD_SETCGRAMADDR | (location * LCD_GLYPH_ROWS));
+  for (int i=0; i<LCD_GLYPH_ROWS; i++) {
+    LCD_write(charmap[i]);
+  }
+  LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Cambia una sola fila de un caracter de CGRAM
+* @param  Dirección de CGRAM (lugar * 8 + fila) y puntos de la fila
+* @retval None
+* @note   Como LCD_createChar(), con dos controladores se carga en los dos.
+*         Sólo manda la dirección si el AC no quedó ya en ella (por ejemplo,
+*         al cambiar filas consecutivas).
+*/
+void LCD_glyphRow(uint8_t address, uint8_t value) {
+  uint8_t Seleccion = miLCD.selected;
+  if (miLCD.split) LCD_select((1U << miLCD.displays) - 1);
+
+  address &= 0x3F;
+  bool Ubicado = true;
+  for (uint8_t d=0; d<miLCD.displays; d++) {
+    if ((miLCD.selected & (1U << d)) == 0) continue;
+    if (!miLCD.cgram_selected[d] || miLCD.address[d] != address) Ubicado = false;
+  }
+  if (!Ubicado) LCD_command(LCD_SETCGRAMADDR | address);
+  LCD_write(value);
+  LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Envía una cadena de caracteres
+* @param  Cadena de caracteres terminada en '\0'
+* @retval None
+* @note   Recorre la cadena una sola vez, escribiendo a medida que avanza.
+*         Envía a lo sumo LCD_PRINT_MAX caracteres (toda la DDRAM), así su
+*         tiempo tiene cota (ver LCD_wcet.h); para más, LCD_printn().
+*/
+void LCD_print(const char * Cadena) {
+	for (size_t n=0; n<LCD_PRINT_MAX && *Cadena != '\0'; n++) {
+		LCD_write((uint8_t) *Cadena++);
+	}
+}
+
+/*******************************************************************************
+* @brief  Envía una cantidad fija de caracteres, sin copiarlos
+* @param  Caracteres y cantidad
+* @retval None
+* @note   No necesita '\0' al final: sirve para partes de otro buffer o de
+*         una tabla de textos en flash. El código 0 se envía como el glifo 0
+*         de CGRAM.
+*/
+void LCD_printn(const char * Caracteres, size_t Largo) {
+	const char * Fin = Caracteres + Largo;
+	while (Caracteres != Fin) {
+		LCD_write((uint8_t) *Caracteres++);
+	}
+}
+
+/*******************************************************************************
+* @brief  Envía caracteres tomados de un buffer circular, sin copiarlos
+* @param  Buffer, su tamaño, posición del primer caracter y cantidad
+* @retval None
+* @note   Si el texto da la vuelta al final del buffer se envía en dos partes
+*         (hasta el final y desde el comienzo). Por ejemplo, una línea recibida
+*         por la UART pasa directo del buffer de recepción al display.
+*/
+void LCD_printSpan(const char * Buffer, size_t Tamanio, size_t Inicio, size_t Largo) {
+	if (Tamanio == 0) return;
+	if (Largo > Tamanio) Largo = Tamanio;
+	Inicio %= Tamanio;
+
+	size_t Primera_parte = Tamanio - Inicio;
+	if (Primera_parte > Largo) Primera_parte = Largo;
+
+	LCD_printn(&Buffer[Inicio], Primera_parte);
+	LCD_printn(Buffer, Largo - Primera_parte);
+}
+
+/*******************************************************************************
+* @brief  Escribe la pantalla completa, una cadena por fila
+* @param  Filas (numlines cadenas; las cortas dejan el resto como estaba)
+* @retval None
+* @note   Con dos controladores (40x4) intercala los caracteres de las filas
+*         de cada uno: mientras uno ejecuta, el bus le escribe al otro, y la
+*         pantalla tarda la mitad que fila por fila. Sólo reenvía la
+*         dirección al cambiar de fila.
+*/
+void LCD_printScreen(const char * const Filas[]) {
+	uint8_t Controladores = miLCD.split ? 2 : 1;
+	uint8_t Por_controlador = miLCD.numlines / Controladores;
+	uint8_t Orden[LCD_MAX_LINES];
+	uint8_t Fila[2], Columna[2] = {0, 0};
+	bool Pendiente = true;
+
+	// Las filas de cada controlador, en orden de DDRAM (ver LCD_rowOrder)
+	LCD_rowOrder(Orden);
+	for (uint8_t c=0; c<Controladores; c++) Fila[c] = c * Por_controlador;
+
+	while (Pendiente) {
+		Pendiente = false;
+		for (uint8_t c=0; c<Controladores; c++) {
+			// Salteo lo que ya terminó en las filas de este controlador
+			uint8_t Fin = (c + 1) * Por_controlador;
+			while (Fila[c] < Fin && (Columna[c] >= miLCD.numcols || Filas[Orden[Fila[c]]][Columna[c]] == '\0')) {
+				Fila[c]++;
+				Columna[c] = 0;
+			}
+			if (Fila[c] >= Fin) continue;
+			uint8_t row = Orden[Fila[c]];
+
+			// Elijo el controlador sin mover el cursor (no hace falta enviar nada)
+			uint8_t Direccion = LCD_cellAddress(Columna[c], row);
+			if (miLCD.split) LCD_select(1U << miLCD.row_display[row]);
+			if (LCD_cgramSelected() || LCD_address() != Direccion) LCD_command(LCD_SETDDRAMADDR | Direccion);
+
+			LCD_write((uint8_t) Filas[row][Columna[c]++]);
+			Pendiente = true;
+		}
+	}
+	if (miLCD.split) LCD_select(1U << miLCD.focus);
+}
+
+/* Funciones nivel medio -----------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Envía un dato al LCD
+* @param  Dato de 8 bits
+* @retval None
+*/
+void LCD_write(uint8_t value) {
+  LCD_send(value, GPIO_PIN_SET);
+  for (uint8_t d=0; d<miLCD.displays; d++) {
+    if ((miLCD.selected & (1U << d)) == 0) continue;
+    if (miLCD.cgram_selected[d]) {
+      miLCD.cgram[d][miLCD.address[d] % LCD_CGRAM_SIZE] = value;
+      miLCD.cgram_known[d] |= 1ULL << (miLCD.address[d] % LCD_CGRAM_SIZE);
+    } else {
+      if (miLCD.address[d] < LCD_DDRAM_SIZE) miLCD.ddram[d][miLCD.address[d]] = value;
+      // Con autoscroll, escribir en DDRAM desplaza el display en el sentido del AC
+      if (miLCD.displaymode & LCD_ENTRYSHIFTINCREMENT) LCD_track_shift(d, (miLCD.displaymode & LCD_ENTRYLEFT) == 0);
+    }
+  }
+  LCD_track_move(miLCD.displaymode & LCD_ENTRYLEFT);
+}
+
+/*******************************************************************************
+* @brief  Envía un comando al LCD
+* @param  Comando
+* @retval None
+*/
+void LCD_command(uint8_t value) {
+	LCD_send(value, GPIO_PIN_RESET);
+	LCD_track_command(value);
+}
+
+/*******************************************************************************
+* @brief  Lee el registro de dirección y Busy flag desde el LCD
+* @param  None
+* @retval Registro de instrucción
+*/
+uint8_t LCD_address_read(void) {
+	uint8_t Seleccion = LCD_read_select();
+	uint8_t Lectura = LCD_receive(GPIO_PIN_RESET);
+	LCD_select(Seleccion);
+	return Lectura;
+}
+
+/*******************************************************************************
+* @brief  Lee el registro de dirección y Busy flag desde el LCD
+* @param  None
+* @retval Registro de instrucción
+*/
+uint8_t LCD_data_read(void) {
+	uint8_t Seleccion = LCD_read_select();
+	uint8_t Lectura = LCD_receive(GPIO_PIN_SET);
+	LCD_track_move(miLCD.displaymode & LCD_ENTRYLEFT);	// <-- La lectura también mueve el AC
+	LCD_select(Seleccion);
+	return Lectura;
+}
+
+/*******************************************************************************
+* @brief  Dirección actual del AC, según los comandos y datos enviados
+* @param  None
+* @retval Dirección de DDRAM (o de CGRAM, si se envió LCD_SETCGRAMADDR)
+* @note   No accede al bus: sirve también cuando RW no está conectado.
+*/
+uint8_t LCD_address(void) {
+	return miLCD.address[miLCD.primary];
+}
+
+/*******************************************************************************
+* @brief  Indica si el AC apunta a CGRAM (luego de LCD_createChar, por ejemplo)
+* @param  None
+* @retval true si apunta a CGRAM
+*/
+bool LCD_cgramSelected(void) {
+	return miLCD.cgram_selected[miLCD.primary];
+}
+
+/*******************************************************************************
+* @brief  Indica si se puede leer del LCD (RW conectado)
+* @param  None
+* @retval true si RW está conectado
+*/
+bool LCD_canRead(void) {
+	return miLCD.rw_port != DISCONNECTED_PIN;
+}
+
+/*******************************************************************************
+* @brief  Tiempo que falta para que los displays acepten otra instrucción
+* @param  None
+* @retval Microsegundos (0 si ya están listos)
+* @note   Es lo que esperaría el próximo envío, según el tiempo de ejecución
+*         de lo último enviado a cada display (el mayor de todos).
+*/
+uint32_t LCD_readyIn(void) {
+	uint32_t Ahora = LCD_cycles();
+	int32_t Falta = 0;
+	for (uint8_t d=0; d<miLCD.displays; d++) {
+		int32_t Resto = (int32_t) (miLCD.ready_at[d] - Ahora);
+		if (Resto > Falta) Falta = Resto;
+	}
+	// Lo diferido sale antes del próximo envío (a lo sumo dos comandos)
+	if (miLCD.control_pending || miLCD.mode_pending) Falta += (int32_t) (2 * Ciclos.exec);
+	return ((uint32_t) Falta + LCD_CYCLES_PER_US - 1) / LCD_CYCLES_PER_US;
+}
+
+/*******************************************************************************
+* @brief  Lee la copia en sombra de DDRAM (lo que el driver escribió)
+* @param  Dirección de DDRAM
+* @retval Caracter
+*/
+uint8_t LCD_shadow(uint8_t address) {
+	return miLCD.ddram[miLCD.primary][address % LCD_DDRAM_SIZE];
+}
+
+/*******************************************************************************
+* @brief  Lee la copia en sombra de CGRAM (lo que el driver escribió)
+* @param  Dirección de CGRAM (fila del caracter, de 0 a 0x3F)
+* @retval Fila de 5 puntos (bit 4 a la izquierda)
+* @note   Sólo vale para lo escrito desde LCD_init() (ver LCD_cgramKnown).
+*/
+uint8_t LCD_cgramShadow(uint8_t address) {
+	return miLCD.cgram[miLCD.primary][address % LCD_CGRAM_SIZE];
+}
+
+/*******************************************************************************
+* @brief  Indica si una fila de CGRAM se escribió desde LCD_init()
+* @param  Dirección de CGRAM
+* @retval true si LCD_cgramShadow() tiene lo que hay en el display
+* @note   Al encender, la CGRAM tiene cualquier cosa.
+*/
+bool LCD_cgramKnown(uint8_t address) {
+	return (miLCD.cgram_known[miLCD.primary] >> (address % LCD_CGRAM_SIZE)) & 1U;
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM siguiente, según el modo de 1 o 2 líneas
+* @param  Dirección de DDRAM
+* @retval Dirección siguiente (la misma que tomaría el AC al escribir)
+*/
+uint8_t LCD_nextAddress(uint8_t address) {
+	return LCD_next_address(address, true);
+}
+
+/*******************************************************************************
+* @brief  Cantidad de displays conectados al bus
+* @param  None
+* @retval Cantidad (1 a LCD_MAX_DISPLAYS)
+*/
+uint8_t LCD_displays(void) {
+	return miLCD.displays;
+}
+
+/*******************************************************************************
+* @brief  Elige a qué displays llegan los comandos y datos siguientes
+* @param  Un bit por display (0x01 el display 0, 0x03 los dos primeros...)
+* @retval None
+* @note   Con varios elegidos, se sube el ENABLE de todos a la vez: una sola
+*         transferencia escribe en todos. Las lecturas (y el busy flag) se
+*         hacen sólo del primero de ellos. LCD_address() y LCD_shadow()
+*         también se refieren al primero.
+*/
+void LCD_select(uint8_t Mascara) {
+	Mascara &= (1U << miLCD.displays) - 1;
+	if (Mascara == 0) return;
+	miLCD.selected = Mascara;
+
+	// Agrupo los ENABLE por puerto para subirlos con una sola escritura
+	miLCD.strobe_groups = 0;
+	for (uint8_t d=LCD_MAX_DISPLAYS; d-- > 0; ) {
+		if ((Mascara & (1U << d)) == 0) continue;
+		miLCD.primary = d;
+
+		uint8_t g = 0;
+		while (g < miLCD.strobe_groups && miLCD.strobe_ports[g] != miLCD.enable_ports[d]) g++;
+		if (g == miLCD.strobe_groups) {
+			miLCD.strobe_ports[g] = miLCD.enable_ports[d];
+			miLCD.strobe_pins[g] = 0;
+			miLCD.strobe_groups++;
+		}
+		miLCD.strobe_pins[g] |= miLCD.enable_pins[d];
+	}
+}
+
+/*******************************************************************************
+* @brief  Displays elegidos con LCD_select()
+* @param  None
+* @retval Un bit por display
+*/
+uint8_t LCD_selected(void) {
+	return miLCD.selected;
+}
+
+/*******************************************************************************
+* @brief  AC, selección de CGRAM y sombra de DDRAM de un display en particular
+* @param  Display (y dirección de DDRAM)
+* @retval Como LCD_address(), LCD_cgramSelected() y LCD_shadow()
+*/
+uint8_t LCD_addressOf(uint8_t display) {
+	return miLCD.address[display % LCD_MAX_DISPLAYS];
+}
+bool LCD_cgramSelectedOf(uint8_t display) {
+	return miLCD.cgram_selected[display % LCD_MAX_DISPLAYS];
+}
+uint8_t LCD_shadowOf(uint8_t display, uint8_t address) {
+	return miLCD.ddram[display % LCD_MAX_DISPLAYS][address % LCD_DDRAM_SIZE];
+}
+uint8_t LCD_cgramShadowOf(uint8_t display, uint8_t address) {
+	return miLCD.cgram[display % LCD_MAX_DISPLAYS][address % LCD_CGRAM_SIZE];
+}
+
+/*******************************************************************************
+* @brief  Tamaño de la pantalla
+* @param  None
+* @retval Columnas y filas (con dos controladores, las de ambos)
+*/
+uint8_t LCD_columns(void) {
+	return miLCD.numcols;
+}
+uint8_t LCD_lines(void) {
+	return miLCD.numlines;
+}
+
+/*******************************************************************************
+* @brief  Activa (o no) la espera de clear y home por interrupción
+* @param  true para activarla
+* @retval None
+* @note   Activada, LCD_clear() y LCD_home() dejan el bus leyendo el busy
+*         flag con E arriba (DB7 muestra BF mientras E esté arriba), arman
+*         la interrupción del pin DB7 por flanco descendente y vuelven sin
+*         esperar. Lo próximo que use el bus duerme (__WFI) hasta que la
+*         interrupción termine la lectura; el programa puede mientras tanto
+*         hacer otra cosa y consultar LCD_busyPending(). Necesita RW
+*         conectado, y un solo display elegido (con varios no se puede
+*         leer el busy flag de todos): si no, se espera como siempre.
+*         Con el bus FMC tampoco se usa: el FMC no puede dejar E arriba.
+*/
+void LCD_busyEvent(bool Activar) {
+	if (!Activar) LCD_busy_sleep();
+	miLCD.busy_event = Activar && (miLCD.rw_port != DISCONNECTED_PIN);
+}
+
+/*******************************************************************************
+* @brief  Indica si un clear o home todavía se espera por interrupción
+* @param  None
+* @retval true mientras no haya terminado
+*/
+bool LCD_busyPending(void) {
+	return miLCD.busy_armed;
+}
+
+/*******************************************************************************
+* @brief  Función a llamar cuando termina un clear o home esperado por
+*         interrupción (por ejemplo, para despertar la tarea del display)
+* @param  Función (NULL para ninguna). Se llama desde la interrupción.
+* @retval None
+*/
+void LCD_onReady(void (*Aviso)(void)) {
+	miLCD.on_ready = Aviso;
+}
+
+/*******************************************************************************
+* @brief  Termina la espera del busy flag (desde la interrupción de DB7)
+* @param  None
+* @retval None
+* @note   Baja E (en modo 4 pines, con el pulso del segundo nibble que
+*         completa la lectura), desarma la interrupción y deja el display
+*         listo para lo siguiente. La llaman la interrupción y el programa
+*         (si ya terminó al armar, o si se vence la espera): consultar y
+*         bajar busy_armed va con las interrupciones deshabilitadas, para
+*         que sólo una de las dos siga.
+*/
+void LCD_busyIrq(void) {
+	uint32_t Mascara = __get_PRIMASK();
+	__disable_irq();
+	bool Armada = miLCD.busy_armed;
+	miLCD.busy_armed = false;
+	if (Mascara == 0) __enable_irq();
+	if (!Armada) return;
+	LCD_busyIrqDisarm(&miLCD);
+
+	LCD_busy_enable(GPIO_PIN_RESET);
+	if (miLCD.fourbitmode == true) {
+		delayCycles(Ciclos.cycle);
+		LCD_busy_enable(GPIO_PIN_SET);
+		delayCycles(Ciclos.pweh);
+		LCD_busy_enable(GPIO_PIN_RESET);
+	}
+	miLCD.enable_fall = LCD_cycles();
+	miLCD.ready_at[miLCD.busy_display] = miLCD.enable_fall;
+
+	if (miLCD.on_ready != NULL) miLCD.on_ready();
+}
+
+/*******************************************************************************
+* @brief  Indica si algún display perdió su estado (por ejemplo, por un corte
+*         breve de alimentación mientras el micro seguía andando)
+* @param  None
+* @retval true si hay que restaurarlo (ver LCD_restore)
+* @note   Al volver la alimentación, el HD44780 se reinicia solo: queda en 8
+*         bits, borrado, apagado y con el AC en 0. Para cada display, lee el
+*         registro de instrucción: si el busy flag sigue arriba más que un
+*         clear, o el AC no es el que lleva el driver, se perdió. Si los dos
+*         AC son 0 (lo que deja también el reinicio), lee además la primera
+*         celda escrita que no es espacio y devuelve el AC. Sin RW no se puede
+*         saber: devuelve false (llamar a LCD_restore() luego de cada evento
+*         sospechoso, como la conmutación de un relé).
+*/
+bool LCD_lost(void) {
+	if (miLCD.rw_port == DISCONNECTED_PIN) return false;
+
+	uint8_t Seleccion = miLCD.selected;
+	bool Perdido = false;
+	for (uint8_t d=0; d<miLCD.displays && !Perdido; d++) {
+		LCD_select(1U << d);
+		Perdido = LCD_lost_display(d);
+	}
+	LCD_select(Seleccion);
+	return Perdido;
+}
+
+/*******************************************************************************
+* @brief  Vuelve a dejar los displays como los tiene la sombra
+* @param  None
+* @retval None
+* @note   Sincroniza la interfaz (sirve tanto si el display se reinició como
+*         si no), apaga la pantalla y la borra sin tocar la sombra. Luego, para
+*         cada display, envía las filas de CGRAM conocidas y las celdas de
+*         DDRAM que no son espacio (una dirección por tramo), repone el
+*         desplazamiento y el AC, y al final displaycontrol y el modo de
+*         escritura. Con un 16x2 lleno y 8 glifos tarda unos 10 ms, en lugar
+*         de esperar a que la aplicación redibuje todo.
+*/
+void LCD_restore(void) {
+	uint8_t Seleccion = miLCD.selected;
+	uint8_t Modo = miLCD.displaymode;
+	uint8_t Todos = (uint8_t) ((1U << miLCD.displays) - 1);
+	uint8_t Direccion[LCD_MAX_DISPLAYS], Desplazamiento[LCD_MAX_DISPLAYS];
+	bool En_cgram[LCD_MAX_DISPLAYS];
+
+	// Una espera por interrupción pendiente ya no tiene sentido
+	if (miLCD.busy_armed) LCD_busyIrq();
+	miLCD.control_pending = miLCD.mode_pending = false;
+
+	// Lo común a todos va junto: sincronizo, apago y borro
+	LCD_select(Todos);
+	LCD_sync_interface();
+	LCD_send(LCD_FUNCTIONSET | miLCD.displayfunction, GPIO_PIN_RESET);
+	LCD_send(LCD_DISPLAYCONTROL | LCD_DISPLAYOFF, GPIO_PIN_RESET);
+	LCD_send(LCD_CLEARDISPLAY, GPIO_PIN_RESET);		// <-- Sin LCD_command: la sombra es lo que hay que reponer
+
+	// Clear deja I/D=1 pero no toca S: si no hubo corte, el display puede
+	// seguir en autoscroll, y la reposición lo desplazaría con cada dato
+	LCD_send(LCD_ENTRYMODESET | LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT, GPIO_PIN_RESET);
+
+	// Ahora cada display está borrado, con el AC en 0, I/D=1 y S=0
+	miLCD.displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
+	for (uint8_t d=0; d<miLCD.displays; d++) {
+		Direccion[d] = miLCD.address[d];
+		En_cgram[d] = miLCD.cgram_selected[d];
+		Desplazamiento[d] = miLCD.shift[d];
+		miLCD.address[d] = 0;
+		miLCD.cgram_selected[d] = false;
+		miLCD.shift[d] = 0;
+		miLCD.control_sent[d] = LCD_DISPLAYOFF;
+		miLCD.mode_sent[d] = LCD_ENTRYLEFT;
+	}
+
+	for (uint8_t d=0; d<miLCD.displays; d++) {
+		LCD_select(1U << d);
+		LCD_replay_display(d);
+
+		// Desplazamiento, por el lado más corto
+		uint8_t Largo = (miLCD.displayfunction & LCD_2LINE) ? LCD_DDRAM_CELLS / 2 : LCD_DDRAM_CELLS;
+		if (Desplazamiento[d] <= Largo / 2) {
+			for (uint8_t i=0; i<Desplazamiento[d]; i++) LCD_command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT);
+		} else {
+			for (uint8_t i=Desplazamiento[d]; i<Largo; i++) LCD_command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVERIGHT);
+		}
+
+		// El AC donde lo dejó la aplicación
+		if (En_cgram[d]) LCD_command(LCD_SETCGRAMADDR | Direccion[d]);
+		else LCD_command(LCD_SETDDRAMADDR | Direccion[d]);
+	}
+
+	// Recién ahora se prende la pantalla, con el modo de la aplicación
+	miLCD.displaymode = Modo;
+	LCD_select(Todos);
+	miLCD.control_pending = miLCD.mode_pending = true;
+	LCD_send_pending(false);
+	LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Restaura los displays si perdieron su estado
+* @param  None
+* @retval true si hubo que restaurarlos
+* @note   Para llamar cada tanto desde el lazo principal (cuesta unas pocas
+*         lecturas del registro de instrucción).
+*/
+bool LCD_recover(void) {
+	if (!LCD_lost()) return false;
+	LCD_restore();
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Vuelve a sincronizar la interfaz con los displays elegidos
+* @param  None
+* @retval None
+* @note   Para después de transferencias dudosas (por ejemplo con tiempos
+*         demasiado cortos, ver LCD_autotune): en 4 bits un nibble perdido
+*         deja al display a medio byte. Repite la secuencia de la hoja de datos,
+*         function set, displaycontrol y el modo de escritura. No toca DDRAM,
+*         CGRAM ni el AC: los repone quien llama (o LCD_restore, si hace falta).
+*/
+void LCD_resync(void) {
+	if (miLCD.busy_armed) LCD_busyIrq();
+	LCD_sync_interface();
+	LCD_send(LCD_FUNCTIONSET | miLCD.displayfunction, GPIO_PIN_RESET);
+	miLCD.control_pending = miLCD.mode_pending = true;
+	LCD_send_pending(true);
+}
+
+/*******************************************************************************
+* @brief  Cambia el perfil de tiempos del bus
+* @param  Perfil (LCD_timing_HD44780, otro clon, o el resultado de LCD_autotune)
+* @retval None
+*/
+void LCD_setTiming(const LCDtiming * Perfil) {
+	miLCD.timing = *Perfil;
+
+	// Paso todo a ciclos una sola vez, para no dividir en cada pulso
+	Ciclos.as = LCD_NS_TO_CYCLES(Perfil->as_ns);
+	Ciclos.pweh = LCD_NS_TO_CYCLES(Perfil->pweh_ns);
+	Ciclos.ddr = LCD_NS_TO_CYCLES(Perfil->ddr_ns);
+	Ciclos.h = LCD_NS_TO_CYCLES(Perfil->h_ns);
+	Ciclos.cycle = LCD_NS_TO_CYCLES(Perfil->cycle_ns);
+	Ciclos.exec = Perfil->exec_us * LCD_CYCLES_PER_US;
+	Ciclos.clear = Perfil->clear_us * LCD_CYCLES_PER_US;
+
+	// Con el bus FMC, los tiempos del pulso los arma el FMC
+	if (miLCD.fmc != NULL) LCD_fmcTiming(Perfil);
+}
+
+/*******************************************************************************
+* @brief  Perfil de tiempos en uso
+* @param  None
+* @retval Puntero al perfil
+*/
+const LCDtiming * LCD_getTiming(void) {
+	return &miLCD.timing;
+}
+
+/*******************************************************************************
+* @brief  Modo de escritura en uso
+* @param  None
+* @retval LCD_ENTRYLEFT y LCD_ENTRYSHIFTINCREMENT, según corresponda
+*/
+uint8_t LCD_entryMode(void) {
+	return miLCD.displaymode;
+}
+
+/*******************************************************************************
+* @brief  Sella un perfil para guardarlo (por ejemplo en flash)
+* @param  Perfil
+* @retval None
+*/
+void LCD_timingSeal(LCDtiming * Perfil) {
+	const uint16_t * Campos = (const uint16_t *) Perfil;
+	uint16_t Suma = 0x4C43;		// 'LC'
+	for (size_t i=0; i<offsetof(LCDtiming, seal)/sizeof(uint16_t); i++) {
+		Suma = (uint16_t) ((Suma << 1) | (Suma >> 15)) ^ Campos[i];
+	}
+	Perfil->seal = Suma;
+}
+
+/*******************************************************************************
+* @brief  Verifica un perfil guardado antes de usarlo
+* @param  Perfil
+* @retval true si el sello coincide y los tiempos son razonables
+*/
+bool LCD_timingValid(const LCDtiming * Perfil) {
+	LCDtiming Copia = *Perfil;
+	LCD_timingSeal(&Copia);
+	return (Copia.seal == Perfil->seal) && (Perfil->pweh_ns != 0) && (Perfil->exec_us != 0);
+}
+
+/*******************************************************************************
+* @brief  Envía comando o dato, con 8 o 4 pines conectados
+* @param  Puntero a LCD, valor a enviar y modo (comando o dato)
+* @retval None
+*/
+static void LCD_send(uint8_t value, uint8_t mode) {
+  // Antes de cualquier otra cosa, lo que quedó diferido
+  if (miLCD.control_pending || miLCD.mode_pending) LCD_send_pending(false);
+
+  // Espero que termine la instrucción anterior
+  LCD_wait_ready();
+
+  if (miLCD.fmc != NULL) {
+	// Bus FMC: una escritura, con RS en A0 (el FMC arma tAS, PWEH y tH)
+	LCD_fmc_period();
+	fmcWrite(miLCD.fmc, (mode == GPIO_PIN_SET) ? LCD_FMC_RS : 0, value);
+  } else {
+	strobeWrite(miLCD.rs_bb, miLCD.rs_port, miLCD.rs_pin, (GPIO_PinState) mode);
+
+	// Si RW está, lo bajamos para escribir
+	if (miLCD.rw_port != DISCONNECTED_PIN) {
+	  strobeWrite(miLCD.rw_bb, miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_RESET);
+	}
+
+	// Debo poner pines de datos en modo escritura...
+	if (miLCD.rw_config != WRITE_MODE) LCD_write_mode(&miLCD);
+
+	// Veo si mando de a 4 bits o de a 8 bits
+	if (miLCD.displayfunction & LCD_8BITMODE) {
+	  LCD_write8bits(value);
+	} else {
+	  LCD_write4bits(value>>4);
+	  LCD_write4bits(value);
+	}
+  }
+
+  // No espero acá: el próximo envío esperará sólo lo que falte
+  bool Largo = (mode == GPIO_PIN_RESET) && (value == LCD_CLEARDISPLAY || (value & ~0x01) == LCD_RETURNHOME);
+  uint32_t Listo = LCD_cycles() + (Largo ? Ciclos.clear : Ciclos.exec);
+  for (uint8_t d=0; d<miLCD.displays; d++) {
+    if (miLCD.selected & (1U << d)) miLCD.ready_at[d] = Listo;
+  }
+}
+
+/*******************************************************************************
+* @brief  Lee registro de Instrucción o Dato
+* @param  Puntero a LCD, valor a enviar y modo (comando o dato)
+* @retval Byte leído
+*/
+static uint8_t LCD_receive(uint8_t Registro) {
+	uint8_t LecturaByte = 0;
+
+	// La lectura avanza el AC según el modo de escritura: que esté al día
+	if (miLCD.control_pending || miLCD.mode_pending) LCD_send_pending(false);
+
+	// Si el bus quedó esperando el busy flag, espero a que se libere
+	LCD_busy_sleep();
+
+	// Primero verifico que el pin RW esté conectado:
+	if (miLCD.rw_port == NULL) Error_Handler();					// <-- No está conectado!!!
+	if (miLCD.fmc == NULL) {
+		strobeWrite(miLCD.rw_bb, miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_SET);	// <-- Modo lectura.
+
+		// Luego selecciono el registro Instrucción o Dato
+		strobeWrite(miLCD.rs_bb, miLCD.rs_port, miLCD.rs_pin, (GPIO_PinState) Registro);
+
+		// Debo poner pines de datos en modo lectura...
+		if (miLCD.rw_config != READ_MODE) LCD_read_mode(&miLCD);
+	}
+
+	// Leer la RAM es una instrucción más: espero la anterior
+	if (Registro == GPIO_PIN_SET) LCD_wait_ready();
+
+	// Leo los pines: evalúo si leo de a 4 bits o de a 8 bits (o una lectura del FMC)
+	if (miLCD.fmc != NULL) {
+	  LCD_fmc_period();
+	  LecturaByte = fmcRead(miLCD.fmc, LCD_FMC_RW | ((Registro == GPIO_PIN_SET) ? LCD_FMC_RS : 0));
+	} else if (miLCD.fourbitmode == true) {
+ 	  LecturaByte =  LCD_read4bits() << 4;
+      LecturaByte |= LCD_read4bits();
+	} else {
+	  LecturaByte = LCD_read8bits();
+	}
+	if (Registro == GPIO_PIN_SET) miLCD.ready_at[miLCD.primary] = LCD_cycles() + Ciclos.exec;
+
+	// Listo!!!
+	return LecturaByte;
+}
+
+/*******************************************************************************
+* @brief  Lee BUSY FLAG
+* @param  NONE
+* @retval Estado de BUSY FLAG
+*/
+bool LCD_busy_flag(void) {
+	bool Lectura = true;
+
+	// Primero verifico que el pin RW esté conectado y pongo en lectura:
+	if (miLCD.rw_port == DISCONNECTED_PIN) return Lectura;	// Como no sé si está ocupado, devuelvo OCUPADO
+	if (miLCD.busy_armed) return Lectura;	// <-- El bus está esperando la interrupción
+	uint8_t Seleccion = LCD_read_select();
+	if (miLCD.fmc != NULL) {
+		// Bus FMC: una lectura del registro de instrucción (BF en DB7)
+		LCD_fmc_period();
+		Lectura = (fmcRead(miLCD.fmc, LCD_FMC_RW) & 0x80) != 0;
+	} else {
+		strobeWrite(miLCD.rw_bb, miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_SET);	// <-- Modo lectura.
+
+		// Luego selecciono el registro de ADDRESS y BUSY FLAG
+		strobeWrite(miLCD.rs_bb, miLCD.rs_port, miLCD.rs_pin, GPIO_PIN_RESET);
+
+		// Debo poner pines de datos en modo lectura...
+		if (miLCD.rw_config != READ_MODE) LCD_read_mode(&miLCD);
+
+		// Activo ENABLE y leo EL PIN de busy flag:
+		delayCycles(Ciclos.as);
+		LCD_enable_high();		// <-- Flanco ascendente de ENABLE
+		delayCycles(Ciclos.ddr);
+		if (miLCD.fourbitmode == true) {
+			// Leo en modo 4 pines
+			Lectura = (bool) strobeRead(miLCD.busy_bb, miLCD.data_ports[3], miLCD.data_pins[3]);
+			// Mando pulso para saltear siguiente lectura
+			LCD_enable_low();
+			LCD_enable_high();
+		} else {
+			// Leo en modo 8 pines
+			Lectura = (bool) strobeRead(miLCD.busy_bb, miLCD.data_ports[7], miLCD.data_pins[7]);
+		}
+		LCD_enable_low();		// <-- Flanco descendente de ENABLE
+	}
+
+	// Si ya terminó, no hace falta esperar el tiempo de ejecución completo
+	// (salvo que haya otros displays elegidos: por ellos no podemos preguntar)
+	if (Lectura == false && Seleccion == miLCD.selected) miLCD.ready_at[miLCD.primary] = LCD_cycles();
+	LCD_select(Seleccion);
+
+	// Listo!!!
+	return Lectura;
+}
+
+/*******************************************************************************
+* @brief  Actualiza el AC según el comando enviado
+* @param  Comando
+* @retval None
+*/
+static void LCD_track_command(uint8_t value) {
+	if (value & (LCD_SETDDRAMADDR | LCD_SETCGRAMADDR)) {
+		// Fija el AC (abajo, en cada display)
+	} else if (value & LCD_FUNCTIONSET) {
+		return;		// No modifica el AC
+	} else if (value & LCD_CURSORSHIFT) {
+		// Sólo mueve el AC si desplaza el cursor; si no, desplaza el display
+		if ((value & LCD_DISPLAYMOVE) == 0) {
+			LCD_track_move((value & LCD_MOVERIGHT) != 0);
+		} else {
+			for (uint8_t d=0; d<miLCD.displays; d++) {
+				if (miLCD.selected & (1U << d)) LCD_track_shift(d, (value & LCD_MOVERIGHT) != 0);
+			}
+		}
+		return;
+	} else if (value & (LCD_DISPLAYCONTROL | LCD_ENTRYMODESET)) {
+		// No modifica el AC: sólo anoto lo que quedó en cada controlador
+		for (uint8_t d=0; d<miLCD.displays; d++) {
+			if ((miLCD.selected & (1U << d)) == 0) continue;
+			if (value & LCD_DISPLAYCONTROL) miLCD.control_sent[d] = value & 0x07;
+			else miLCD.mode_sent[d] = value & 0x03;
+		}
+		return;
+	} else if (value == LCD_CLEARDISPLAY) {
+		miLCD.displaymode |= LCD_ENTRYLEFT;		// Clear además fija I/D=1
+	}
+
+	// Cada display elegido recibió el comando
+	for (uint8_t d=0; d<miLCD.displays; d++) {
+		if ((miLCD.selected & (1U << d)) == 0) continue;
+		if (value & LCD_SETDDRAMADDR) {
+			miLCD.address[d] = value & 0x7F;
+			miLCD.cgram_selected[d] = false;
+		} else if (value & LCD_SETCGRAMADDR) {
+			miLCD.address[d] = value & 0x3F;
+			miLCD.cgram_selected[d] = true;
+		} else if (value & (LCD_RETURNHOME | LCD_CLEARDISPLAY)) {
+			// Clear y Home llevan el AC a 0 en DDRAM
+			miLCD.address[d] = 0;
+			miLCD.cgram_selected[d] = false;
+			miLCD.shift[d] = 0;
+			if (value == LCD_CLEARDISPLAY) miLCD.mode_sent[d] |= LCD_ENTRYLEFT;
+			if (value == LCD_CLEARDISPLAY) memset(miLCD.ddram[d], ' ', LCD_DDRAM_SIZE);
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Mueve el AC una posición, como lo hace el HD44780
+* @param  true para incrementar, false para decrementar
+* @retval None
+*/
+static void LCD_track_move(bool Incremento) {
+	for (uint8_t d=0; d<miLCD.displays; d++) {
+		if ((miLCD.selected & (1U << d)) == 0) continue;
+		if (miLCD.cgram_selected[d]) {
+			miLCD.address[d] = (Incremento ? miLCD.address[d] + 1 : miLCD.address[d] - 1) & 0x3F;
+		} else {
+			miLCD.address[d] = LCD_next_address(miLCD.address[d], Incremento);
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM siguiente (o anterior) a una dada
+* @param  Dirección y sentido
+* @retval Dirección
+* @note   En DDRAM de 2 líneas saltamos 0x27 -> 0x40 y 0x67 -> 0x00.
+*/
+static uint8_t LCD_next_address(uint8_t a, bool Incremento) {
+	if (miLCD.displayfunction & LCD_2LINE) {
+		if (Incremento) return (a == 0x27) ? 0x40 : (a == 0x67) ? 0x00 : a + 1;
+		else            return (a == 0x40) ? 0x27 : (a == 0x00) ? 0x67 : a - 1;
+	} else {
+		if (Incremento) return (a >= 0x4F) ? 0x00 : a + 1;
+		else            return (a == 0x00) ? 0x4F : a - 1;
+	}
+}
+
+/*******************************************************************************
+* @brief  Desplaza el display una posición, como lo hace el HD44780
+* @param  Display y sentido (true a la derecha)
+* @retval None
+* @note   Cada línea de DDRAM gira sobre sí misma: 40 posiciones con 2 líneas,
+*         80 con 1 línea.
+*/
+static void LCD_track_shift(uint8_t d, bool Derecha) {
+	uint8_t Largo = (miLCD.displayfunction & LCD_2LINE) ? LCD_DDRAM_CELLS / 2 : LCD_DDRAM_CELLS;
+	miLCD.shift[d] = (uint8_t) ((miLCD.shift[d] + (Derecha ? Largo - 1 : 1)) % Largo);
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM que se ve en una posición, según el desplazamiento
+* @param  Display, columna y fila
+* @retval Dirección de DDRAM
+*/
+static uint8_t LCD_visible_address(uint8_t d, uint8_t col, uint8_t row) {
+	return LCD_shifted_address(col, row, miLCD.shift[d]);
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM que se vería en una posición con un desplazamiento
+* @param  Columna, fila y desplazamiento (posiciones a la izquierda)
+* @retval Dirección de DDRAM
+*/
+static uint8_t LCD_shifted_address(uint8_t col, uint8_t row, uint8_t Desplazamiento) {
+	uint8_t Direccion = LCD_cellAddress(col, row);
+	if (miLCD.displayfunction & LCD_2LINE) {
+		uint8_t Linea = Direccion & 0x40;
+		return Linea + (uint8_t) ((Direccion - Linea + Desplazamiento) % 40);
+	}
+	return (uint8_t) ((Direccion + Desplazamiento) % 80);
+}
+
+/*******************************************************************************
+* @brief  Manda un pulso de lectura "enable"
+* @param  None
+* @retval None
+*/
+static void LCD_pulseEnable() {
+  delayCycles(Ciclos.as);	// RS y RW ya fijados (tAS)
+  LCD_enable_high();				// <-- Los datos ya están (tDSW < PWEH)
+  LCD_enable_low();					// <-- Respeta PWEH
+  delayCycles(Ciclos.h);		// Mantengo datos (tH)
+}
+
+/*******************************************************************************
+* @brief  Sube ENABLE, respetando el período mínimo de E
+* @param  None
+* @retval None
+*/
+static void LCD_enable_high(void) {
+  uint32_t Transcurrido = LCD_cycles() - miLCD.enable_rise;
+  if (Transcurrido < Ciclos.cycle) {
+    delayCycles(Ciclos.cycle - Transcurrido);
+  }
+  LCD_enable_write(GPIO_PIN_SET);
+  miLCD.enable_rise = LCD_cycles();
+}
+
+/*******************************************************************************
+* @brief  Baja ENABLE, respetando el ancho mínimo del pulso
+* @param  None
+* @retval None
+*/
+static void LCD_enable_low(void) {
+  uint32_t Transcurrido = LCD_cycles() - miLCD.enable_rise;
+  if (Transcurrido < Ciclos.pweh) {
+    delayCycles(Ciclos.pweh - Transcurrido);
+  }
+  LCD_enable_write(GPIO_PIN_RESET);
+  miLCD.enable_fall = LCD_cycles();
+}
+
+/*******************************************************************************
+* @brief  Escribe el ENABLE de los displays elegidos
+* @param  Estado
+* @retval None
+* @note   Los ENABLE de un mismo puerto cambian juntos, en una escritura.
+*/
+static void LCD_enable_write(GPIO_PinState Estado) {
+  if (miLCD.selected == 0x01) {
+    strobeWrite(miLCD.enable_bb, miLCD.enable_port, miLCD.enable_pin, Estado);
+  } else {
+    for (uint8_t g=0; g<miLCD.strobe_groups; g++) {
+      digitalWrite(miLCD.strobe_ports[g], miLCD.strobe_pins[g], Estado);
+    }
+  }
+}
+
+/*******************************************************************************
+* @brief  Respeta el período mínimo de E entre dos accesos por el FMC
+* @param  None
+* @retval None
+* @note   El FMC arma cada pulso (tAS, PWEH y tH, ver LCD_fmcTiming), pero
+*         no separa dos accesos seguidos: dos lecturas del busy flag podrían
+*         quedar a menos de tcycE. Las escrituras ya esperan la ejecución.
+*/
+static void LCD_fmc_period(void) {
+  uint32_t Transcurrido = LCD_cycles() - miLCD.enable_rise;
+  if (Transcurrido < Ciclos.cycle) {
+    delayCycles(Ciclos.cycle - Transcurrido);
+  }
+  miLCD.enable_rise = LCD_cycles();
+}
+
+/*******************************************************************************
+* @brief  Deja elegido sólo al primero de los displays, para leer
+* @param  None
+* @retval Displays elegidos antes (para restaurarlos con LCD_select)
+* @note   Si dos displays manejaran el bus de datos a la vez, chocarían.
+*/
+static uint8_t LCD_read_select(void) {
+  uint8_t Seleccion = miLCD.selected;
+  if (Seleccion != (1U << miLCD.primary)) LCD_select(1U << miLCD.primary);
+  return Seleccion;
+}
+
+/*******************************************************************************
+* @brief  Envía un comando que afecta a toda la pantalla
+* @param  Comando
+* @retval None
+* @note   Con dos controladores va a los dos (en una sola transferencia);
+*         si no, a los displays elegidos, como LCD_command().
+*/
+static void LCD_command_all(uint8_t value) {
+  if (!miLCD.split) {
+    LCD_command(value);
+    return;
+  }
+  uint8_t Seleccion = miLCD.selected;
+  LCD_select((1U << miLCD.displays) - 1);
+  LCD_command(value);
+  LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Envía displaycontrol (o lo deja pendiente, ver LCD_deferControl)
+* @param  None
+* @retval None
+*/
+static void LCD_display_control(void) {
+  miLCD.control_pending = true;
+  if (!miLCD.deferred) LCD_send_pending(true);
+}
+
+/*******************************************************************************
+* @brief  Envía el modo de escritura (o lo deja pendiente, ver LCD_deferControl)
+* @param  None
+* @retval None
+*/
+static void LCD_entry_mode(void) {
+  miLCD.mode_pending = true;
+  if (!miLCD.deferred) LCD_send_pending(true);
+}
+
+/*******************************************************************************
+* @brief  Envía displaycontrol y modo de escritura pendientes
+* @param  true para enviarlos aunque el controlador ya los tenga
+* @retval None
+* @note   Con dos controladores, cursor y parpadeo se prenden sólo en el que
+*         tiene el cursor; el otro recibe displaycontrol sin ellos, y el modo
+*         de escritura va a los dos. Si no, van a los displays elegidos.
+*         Sin forzar, cada controlador recibe el comando sólo si lo que tiene
+*         es distinto (un cambio que vuelve al estado anterior no se envía).
+*/
+static void LCD_send_pending(bool Forzar) {
+  uint8_t Seleccion = miLCD.selected;
+  uint8_t Destino = miLCD.split ? (uint8_t) ((1U << miLCD.displays) - 1) : Seleccion;
+  uint8_t Enfocado = miLCD.split ? (uint8_t) (1U << miLCD.focus) : Destino;
+
+  if (miLCD.control_pending) {
+    miLCD.control_pending = false;
+    uint8_t Sin_cursor = miLCD.displaycontrol & ~(LCD_CURSORON | LCD_BLINKON);
+
+    // Primero los que no tienen el cursor, luego el que lo tiene
+    for (uint8_t Grupo=0; Grupo<LCD_CONTROL_GROUPS; Grupo++) {
+      uint8_t Valor = Grupo ? miLCD.displaycontrol : Sin_cursor;
+      uint8_t Mascara = 0;
+      for (uint8_t d=0; d<miLCD.displays; d++) {
+        if ((Destino & (1U << d)) == 0 || ((Enfocado >> d) & 1U) != Grupo) continue;
+        if (Forzar || miLCD.control_sent[d] != Valor) Mascara |= (uint8_t) (1U << d);
+      }
+      if (Mascara == 0) continue;
+      LCD_select(Mascara);
+      LCD_command(LCD_DISPLAYCONTROL | Valor);
+    }
+  }
+
+  if (miLCD.mode_pending) {
+    miLCD.mode_pending = false;
+    uint8_t Mascara = 0;
+    for (uint8_t d=0; d<miLCD.displays; d++) {
+      if ((Destino & (1U << d)) == 0) continue;
+      if (Forzar || miLCD.mode_sent[d] != miLCD.displaymode) Mascara |= (uint8_t) (1U << d);
+    }
+    if (Mascara != 0) {
+      LCD_select(Mascara);
+      LCD_command(LCD_ENTRYMODESET | miLCD.displaymode);
+    }
+  }
+
+  LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Pasa el cursor a otro controlador (displays de dos controladores)
+* @param  Display
+* @retval None
+* @note   Si el cursor o el parpadeo están prendidos, los mueve de controlador.
+*/
+static void LCD_split_focus(uint8_t display) {
+  if (display != miLCD.focus) {
+    miLCD.focus = display;
+    if (miLCD.displaycontrol & (LCD_CURSORON | LCD_BLINKON)) LCD_display_control();
+  }
+  LCD_select(1U << display);
+}
+
+/*******************************************************************************
+* @brief  Limita la fila a las que tiene el display
+* @param  Fila
+* @retval Fila válida
+*/
+static uint8_t LCD_clamp_row(uint8_t row) {
+  const size_t max_lines = sizeof(miLCD.row_offsets) / sizeof(miLCD.row_offsets[0]);
+  if ( row >= max_lines ) {
+    row = max_lines - 1;    // we count rows starting w/0
+  }
+  if ( row >= miLCD.numlines ) {
+    row = miLCD.numlines - 1;    // we count rows starting w/0
+  }
+  return row;
+}
+
+/*******************************************************************************
+* @brief  Espera a que el LCD termine la instrucción anterior
+* @param  None
+* @retval None
+* @note   Sólo espera lo que falte del tiempo de ejecución: si entre tanto el
+*         programa hizo otra cosa, no hay demora. Con varios displays espera
+*         sólo a los elegidos: mientras uno ejecuta se le puede escribir a otro.
+*/
+static void LCD_wait_ready(void) {
+  LCD_busy_sleep();
+  for (uint8_t d=0; d<miLCD.displays; d++) {
+    if ((miLCD.selected & (1U << d)) == 0) continue;
+    while ((int32_t) (LCD_cycles() - miLCD.ready_at[d]) < 0) {
+      // Just keep on walking...
+    }
+  }
+}
+
+/*******************************************************************************
+* @brief  Espera con el busy flag a que termine la instrucción enviada
+* @param  None
+* @retval None
+* @note   Nunca pasa del tiempo del perfil (ready_at): si el display no
+*         contesta, la espera es la misma que sin RW, y así tiene cota (ver
+*         LCD_wcet.h). Sin RW vuelve enseguida: el próximo envío espera.
+*/
+static void LCD_busy_poll(void) {
+  if (miLCD.rw_port == DISCONNECTED_PIN) return;
+  while ((int32_t) (LCD_cycles() - miLCD.ready_at[miLCD.primary]) < 0 && LCD_busy_flag()) {
+    // Just keep on walking...
+  }
+}
+
+/*******************************************************************************
+* @brief  Deja el bus leyendo el busy flag y arma la interrupción de DB7
+* @param  None
+* @retval true si quedó armada (false: hay que esperar como siempre)
+*/
+static bool LCD_busy_arm(void) {
+	if (!miLCD.busy_event || miLCD.fmc != NULL || miLCD.selected != (1U << miLCD.primary)) return false;
+	uint8_t Busy = miLCD.fourbitmode ? 3 : 7;
+	miLCD.busy_display = miLCD.primary;
+
+	// Leo el registro de instrucción (BF y AC) y dejo E arriba
+	strobeWrite(miLCD.rw_bb, miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_SET);
+	strobeWrite(miLCD.rs_bb, miLCD.rs_port, miLCD.rs_pin, GPIO_PIN_RESET);
+	if (miLCD.rw_config != READ_MODE) LCD_read_mode(&miLCD);
+	delayCycles(Ciclos.as);
+	LCD_enable_high();
+	delayCycles(Ciclos.ddr);
+
+	miLCD.busy_armed = true;
+	LCD_busyIrqArm(&miLCD);
+
+	// Si ya terminó antes de armar, no habrá flanco: termino acá
+	if (!strobeRead(miLCD.busy_bb, miLCD.data_ports[Busy], miLCD.data_pins[Busy])) LCD_busyIrq();
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Duerme hasta que termine la espera del busy flag por interrupción
+* @param  None
+* @retval None
+* @note   Si la interrupción no llega (display desconectado), termina sola
+*         un tiempo de ejecución después de lo previsto (ready_at): la
+*         espera no pasa del clear del perfil más ese margen. Duerme sólo
+*         si el próximo SysTick (que cuenta con HCLK) despierta antes de ese
+*         límite; si no, espera sin dormir.
+*/
+static void LCD_busy_sleep(void) {
+	while (miLCD.busy_armed) {
+		int32_t Falta = (int32_t) (miLCD.ready_at[miLCD.busy_display] + Ciclos.exec - LCD_cycles());
+		if (Falta < 0) {
+			LCD_busyIrq();
+			break;
+		}
+		if (SysTick->VAL < (uint32_t) Falta) __WFI();
+	}
+}
+
+/*******************************************************************************
+* @brief  Escribe el ENABLE del display que se está esperando
+* @param  Estado
+* @retval None
+* @note   No usa la selección: desde la interrupción puede estar cambiando.
+*/
+static void LCD_busy_enable(GPIO_PinState Estado) {
+	uint8_t d = miLCD.busy_display;
+	if (d == 0) strobeWrite(miLCD.enable_bb, miLCD.enable_port, miLCD.enable_pin, Estado);
+	else digitalWrite(miLCD.enable_ports[d], miLCD.enable_pins[d], Estado);
+}
+
+/*******************************************************************************
+* @brief  Verifica un display (ver LCD_lost)
+* @param  Display (ya elegido)
+* @retval true si perdió su estado
+*/
+static bool LCD_lost_display(uint8_t d) {
+	// Terminado lo último enviado, el busy flag no puede seguir arriba más que un clear
+	LCD_wait_ready();
+	uint32_t Inicio = LCD_cycles();
+	uint8_t Registro = LCD_receive(GPIO_PIN_RESET);
+	while (Registro & 0x80) {
+		if (LCD_cycles() - Inicio > Ciclos.clear) return true;	// <-- Reinicio interno en curso
+		Registro = LCD_receive(GPIO_PIN_RESET);
+	}
+
+	uint8_t Mascara = miLCD.cgram_selected[d] ? 0x3F : 0x7F;
+	if ((Registro & Mascara) != miLCD.address[d]) return true;
+	if (miLCD.address[d] != 0) return false;
+
+	// AC en 0: miro la primera celda escrita que no es espacio (el reinicio las borra)
+	uint8_t a = 0;
+	for (uint8_t i=0; i<LCD_DDRAM_CELLS; i++, a = LCD_next_address(a, true)) {
+		if (miLCD.ddram[d][a] == ' ') continue;
+		bool En_cgram = miLCD.cgram_selected[d];
+		LCD_command(LCD_SETDDRAMADDR | a);
+		bool Distinto = (LCD_data_read() != miLCD.ddram[d][a]);
+		LCD_command((En_cgram ? LCD_SETCGRAMADDR : LCD_SETDDRAMADDR) | 0);
+		return Distinto;
+	}
+	return false;	// <-- Pantalla en blanco: se ve igual
+}
+
+/*******************************************************************************
+* @brief  Sincroniza la interfaz de 4 u 8 bits, esté el display como esté
+* @param  None
+* @retval None
+* @note   Secuencia de las figuras 23 y 24 de la hoja de datos, con las
+*         esperas mínimas (no las de LCD_init, que incluyen el encendido).
+*/
+static void LCD_sync_interface(void) {
+	LCD_wait_ready();
+	if (miLCD.fmc != NULL) {
+		// Bus FMC (siempre de 8 bits): tres function set por la dirección de instrucción
+		fmcWrite(miLCD.fmc, 0, LCD_FUNCTIONSET | miLCD.displayfunction);
+		delayMicroseconds(LCD_T_SYNC1_US);
+		fmcWrite(miLCD.fmc, 0, LCD_FUNCTIONSET | miLCD.displayfunction);
+		delayMicroseconds(LCD_T_SYNC2_US);
+		fmcWrite(miLCD.fmc, 0, LCD_FUNCTIONSET | miLCD.displayfunction);
+		delayCycles(Ciclos.exec);
+		return;
+	}
+	strobeWrite(miLCD.rs_bb, miLCD.rs_port, miLCD.rs_pin, GPIO_PIN_RESET);
+	if (miLCD.rw_port != DISCONNECTED_PIN) {
+		strobeWrite(miLCD.rw_bb, miLCD.rw_port, miLCD.rw_pin, GPIO_PIN_RESET);
+	}
+	if (miLCD.rw_config != WRITE_MODE) LCD_write_mode(&miLCD);
+
+	if ((miLCD.displayfunction & LCD_8BITMODE) == false) {
+		LCD_write4bits(0x03);
+		delayMicroseconds(LCD_T_SYNC1_US);
+		LCD_write4bits(0x03);
+		delayMicroseconds(LCD_T_SYNC2_US);
+		LCD_write4bits(0x03);
+		delayCycles(Ciclos.exec);
+		LCD_write4bits(0x02);
+		delayCycles(Ciclos.exec);
+	} else {
+		LCD_write8bits(LCD_FUNCTIONSET | miLCD.displayfunction);
+		delayMicroseconds(LCD_T_SYNC1_US);
+		LCD_write8bits(LCD_FUNCTIONSET | miLCD.displayfunction);
+		delayMicroseconds(LCD_T_SYNC2_US);
+		LCD_write8bits(LCD_FUNCTIONSET | miLCD.displayfunction);
+		delayCycles(Ciclos.exec);
+	}
+}
+
+/*******************************************************************************
+* @brief  Envía la CGRAM conocida y la DDRAM de la sombra a un display borrado
+* @param  Display (ya elegido)
+* @retval None
+* @note   Las escrituras dejan la sombra igual. Sólo envía la dirección al
+*         empezar cada tramo; los espacios ya los puso el clear.
+*/
+static void LCD_replay_display(uint8_t d) {
+	for (uint8_t a=0; a<LCD_CGRAM_SIZE; a++) {
+		if ((miLCD.cgram_known[d] & (1ULL << a)) == 0) continue;
+		if (!miLCD.cgram_selected[d] || miLCD.address[d] != a) LCD_command(LCD_SETCGRAMADDR | a);
+		LCD_write(miLCD.cgram[d][a]);
+	}
+
+	uint8_t a = 0;
+	for (uint8_t i=0; i<LCD_DDRAM_CELLS; i++, a = LCD_next_address(a, true)) {
+		if (miLCD.ddram[d][a] == ' ') continue;
+		if (miLCD.cgram_selected[d] || miLCD.address[d] != a) LCD_command(LCD_SETDDRAMADDR | a);
+		LCD_write(miLCD.ddram[d][a]);
+	}
+}
+
+/*******************************************************************************
+* @brief  Escribe valor en 4 pines (en dos veces)
+* @param  Valor
+* @retval None
+*/
+static void LCD_write4bits(uint8_t value) {
+  for (int i = 0; i < 4; i++) {
+    digitalWrite(miLCD.data_ports[i], miLCD.data_pins[i], (value >> i) & 0x01);
+  }
+  LCD_pulseEnable();
+}
+
+/*******************************************************************************
+* @brief  Escribe valor en los 8 pines
+* @param  Valor
+* @retval None
+*/
+static void LCD_write8bits(uint8_t value) {
+  for (int i = 0; i < 8; i++) {
+    digitalWrite(miLCD.data_ports[i], miLCD.data_pins[i], (value >> i) & 0x01);
+  }
+  LCD_pulseEnable();
+}
+
+/*******************************************************************************
+* @brief  Lee valores en los 8 pines
+* @param  None
+* @retval Byte leído
+*/
+static uint8_t LCD_read8bits(void) {
+  // Verifico conexión 8 pines
+  if (miLCD.fourbitmode == true) Error_Handler();
+
+  // Byte a leer bit por bit
+  uint8_t LecturaByte = 0;
+  GPIO_PinState LecturaPin = GPIO_PIN_RESET;
+
+  // Envío ENABLE y leo
+  delayCycles(Ciclos.as);		// RS y RW ya fijados (tAS)
+  LCD_enable_high();					// <-- Flanco ascendente de ENABLE
+  delayCycles(Ciclos.ddr);		// Espero que el LCD ponga los datos (tDDR)
+  for (int i = 0; i < 8; i++) {
+	  LecturaPin = digitalRead(miLCD.data_ports[i], miLCD.data_pins[i]);
+	  LecturaByte |= (LecturaPin << i);
+  }
+  LCD_enable_low();						// <-- Flanco descendente de ENABLE
+
+  // Leído!!!
+  return LecturaByte;
+}
+
+/*******************************************************************************
+* @brief  Lee valores en 4 pines
+* @param  None
+* @retval Byte leído (entre 0 y 16)
+*/
+static uint8_t LCD_read4bits(void) {
+  // Verifico conexión 4 pines
+  if (miLCD.fourbitmode == false) Error_Handler();
+
+  // Byte a leer bit por bit
+  uint8_t LecturaByte = 0;
+  GPIO_PinState LecturaPin = GPIO_PIN_RESET;
+
+  // Envío ENABLE y leo
+  delayCycles(Ciclos.as);		// RS y RW ya fijados (tAS)
+  LCD_enable_high();					// <-- Flanco ascendente de ENABLE
+  delayCycles(Ciclos.ddr);		// Espero que el LCD ponga los datos (tDDR)
+  for (int i = 0; i < 4; i++) {
+	  LecturaPin = digitalRead(miLCD.data_ports[i], miLCD.data_pins[i]);
+	  LecturaByte |= (LecturaPin << i);
+  }
+  LCD_enable_low();						// <-- Flanco descendente de ENABLE
+
+  // Leído!!!
+  return LecturaByte;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,161 @@
+/*******************************************************************************
+* @file    LCD_field.c
+* @author  Guillermo Caporaletti
+* @brief   Campos de pantalla (valor, unidad, estado) con detección de cambios.
+*          Cada campo recuerda el último texto mostrado; al actualizar sólo se
+*          envían los caracteres que cambiaron. Las etiquetas fijas se envían
+*          una única vez.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_field.h>
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct {
+	uint8_t col;
+	uint8_t row;
+	uint8_t width;
+	LCD_align align;
+	LCD_formatter formatter;
+
+	char mostrado[LCD_FIELD_WIDTH];		// Lo que hay en pantalla
+	char nuevo[LCD_FIELD_WIDTH];		// Lo que debería haber
+	uint32_t cambios;					// Un bit por caracter distinto
+} LCDfield;
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCDfield Campos[LCD_FIELD_MAX];
+static uint8_t Cantidad = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_field_decimal(char * Texto, size_t Largo, int32_t Valor);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Registra un campo
+* @param  Columna, fila, ancho, alineación y formato (NULL para decimal)
+* @retval Identificador del campo o LCD_FIELD_NONE (también si queda fuera
+*         de la pantalla)
+* @note   El ancho se recorta al resto de la fila: si no, los últimos
+*         caracteres caerían en la DDRAM de la fila siguiente.
+*/
+LCD_field LCD_fieldAdd(uint8_t col, uint8_t row, uint8_t width, LCD_align align, LCD_formatter formatter) {
+	if (Cantidad >= LCD_FIELD_MAX || width == 0) return LCD_FIELD_NONE;
+	if (col >= LCD_columns() || row >= LCD_lines()) return LCD_FIELD_NONE;
+	if (width > LCD_columns() - col) width = LCD_columns() - col;
+	if (width > LCD_FIELD_WIDTH) width = LCD_FIELD_WIDTH;
+
+	LCDfield * Campo = &Campos[Cantidad];
+	Campo->col = col;
+	Campo->row = row;
+	Campo->width = width;
+	Campo->align = align;
+	Campo->formatter = (formatter != NULL) ? formatter : LCD_field_decimal;
+
+	// No sabemos qué hay en pantalla: la primera actualización lo escribe todo
+	memset(Campo->mostrado, 0, sizeof(Campo->mostrado));
+	memset(Campo->nuevo, ' ', sizeof(Campo->nuevo));
+	Campo->cambios = (width < 32) ? ((1UL << width) - 1) : UINT32_MAX;
+
+	return (LCD_field) Cantidad++;
+}
+
+/*******************************************************************************
+* @brief  Escribe una etiqueta fija (no se registra ni se vuelve a enviar)
+* @param  Columna, fila y texto
+* @retval None
+*/
+void LCD_fieldLabel(uint8_t col, uint8_t row, const char * Texto) {
+	LCD_setCursor(col, row);
+	LCD_print(Texto);
+}
+
+/*******************************************************************************
+* @brief  Cambia el texto de un campo (se envía en LCD_fieldUpdate)
+* @param  Campo y texto
+* @retval None
+*/
+void LCD_fieldText(LCD_field id, const char * Texto) {
+	if (id < 0 || id >= Cantidad) return;
+	LCDfield * Campo = &Campos[id];
+
+	// Alineo el texto dentro del ancho del campo
+	size_t Largo = strnlen(Texto, Campo->width);
+	size_t Inicio = 0;
+	if (Campo->align == LCD_ALIGN_RIGHT) Inicio = Campo->width - Largo;
+	if (Campo->align == LCD_ALIGN_CENTER) Inicio = (Campo->width - Largo) / 2;
+
+	memset(Campo->nuevo, ' ', Campo->width);
+	memcpy(&Campo->nuevo[Inicio], Texto, Largo);
+
+	// Marco sólo los caracteres distintos a lo que hay en pantalla
+	Campo->cambios = 0;
+	for (uint8_t i=0; i<Campo->width; i++) {
+		if (Campo->nuevo[i] != Campo->mostrado[i]) Campo->cambios |= (1UL << i);
+	}
+}
+
+/*******************************************************************************
+* @brief  Cambia el valor de un campo, usando su formato
+* @param  Campo y valor
+* @retval None
+*/
+void LCD_fieldValue(LCD_field id, int32_t Valor) {
+	if (id < 0 || id >= Cantidad) return;
+	char Texto[LCD_FIELD_WIDTH + 1];
+
+	Campos[id].formatter(Texto, sizeof(Texto), Valor);
+	Texto[LCD_FIELD_WIDTH] = '\0';
+	LCD_fieldText(id, Texto);
+}
+
+/*******************************************************************************
+* @brief  Envía al LCD los caracteres que cambiaron en todos los campos
+* @param  None
+* @retval None
+* @note   Supone escritura de izquierda a derecha (LCD_leftToRight).
+*/
+void LCD_fieldUpdate(void) {
+	for (uint8_t id=0; id<Cantidad; id++) {
+		LCDfield * Campo = &Campos[id];
+
+		for (uint8_t i=0; Campo->cambios != 0 && i<Campo->width; i++) {
+			if ((Campo->cambios & (1UL << i)) == 0) continue;
+
+			// Sólo mando dirección si el AC no quedó ya en este lugar
+			if (!LCD_cursorAt(Campo->col + i, Campo->row)) LCD_setCursor(Campo->col + i, Campo->row);
+
+			LCD_write((uint8_t) Campo->nuevo[i]);
+			Campo->mostrado[i] = Campo->nuevo[i];
+			Campo->cambios &= ~(1UL << i);
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Borra el registro de campos (por ejemplo, al cambiar de pantalla)
+* @param  None
+* @retval None
+*/
+void LCD_fieldReset(void) {
+	Cantidad = 0;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Formato predeterminado: entero decimal
+* @param  Texto, largo y valor
+* @retval None
+*/
+static void LCD_field_decimal(char * Texto, size_t Largo, int32_t Valor) {
+	snprintf(Texto, Largo, "%ld", (long) Valor);
+}
+
+/***************************************************************END OF FILE****/
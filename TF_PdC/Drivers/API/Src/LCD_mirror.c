@@ -0,0 +1,98 @@
+/*******************************************************************************
+* @file    LCD_mirror.c
+* @author  Guillermo Caporaletti
+* @brief   Misma pantalla en varios displays que comparten el bus.
+*          Para cada celda se ve, con la sombra de cada display, cuáles
+*          necesitan el caracter. Esos se eligen juntos (LCD_select) y una
+*          sola transferencia lo escribe en todos: copiar una pantalla a 4
+*          displays cuesta lo mismo que escribirla en uno. Donde los
+*          contenidos difieren, sólo se escribe en los que hace falta.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_mirror.h>
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_mirror_cell(uint8_t Mascara, uint8_t Direccion, uint8_t Caracter);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Escribe un texto en varios displays
+* @param  Displays (un bit por display, o LCD_MIRROR_ALL), columna, fila y texto
+* @retval None
+* @note   Deja elegidos los mismos displays que antes de llamarla. Como
+*         LCD_print(), escribe a lo sumo LCD_PRINT_MAX caracteres.
+*/
+void LCD_mirrorPrint(uint8_t Mascara, uint8_t col, uint8_t row, const char * Texto) {
+	uint8_t Seleccion = LCD_selected();
+	uint8_t Direccion = LCD_cellAddress(col, row);
+
+	for (size_t n=0; n<LCD_PRINT_MAX && *Texto != '\0'; n++) {
+		LCD_mirror_cell(Mascara, Direccion, (uint8_t) *Texto++);
+		Direccion = LCD_nextAddress(Direccion);
+	}
+	LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Escribe un caracter en varios displays
+* @param  Displays, columna, fila y caracter
+* @retval None
+*/
+void LCD_mirrorWrite(uint8_t Mascara, uint8_t col, uint8_t row, uint8_t Caracter) {
+	uint8_t Seleccion = LCD_selected();
+	LCD_mirror_cell(Mascara, LCD_cellAddress(col, row), Caracter);
+	LCD_select(Seleccion);
+}
+
+/*******************************************************************************
+* @brief  Copia el contenido de un display a otros
+* @param  Display de origen y displays de destino
+* @retval None
+* @note   Recorre toda la DDRAM según la sombra del origen; sólo se envían
+*         las celdas que difieren en algún destino.
+*/
+void LCD_mirrorCopy(uint8_t Origen, uint8_t Mascara) {
+	uint8_t Seleccion = LCD_selected();
+	uint8_t Direccion = 0;
+
+	Mascara &= ~(1U << Origen);
+	do {
+		LCD_mirror_cell(Mascara, Direccion, LCD_shadowOf(Origen, Direccion));
+		Direccion = LCD_nextAddress(Direccion);
+	} while (Direccion != 0);
+	LCD_select(Seleccion);
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Escribe una celda en los displays que no la tengan
+* @param  Displays, dirección de DDRAM y caracter
+* @retval None
+* @note   Supone escritura de izquierda a derecha (LCD_leftToRight). La
+*         dirección se envía sólo si algún display elegido no tiene ya el
+*         AC en la celda (en celdas seguidas los AC avanzan juntos).
+*/
+static void LCD_mirror_cell(uint8_t Mascara, uint8_t Direccion, uint8_t Caracter) {
+	uint8_t Destino = 0;
+	bool Mover = false;
+
+	for (uint8_t d=0; d<LCD_displays(); d++) {
+		if ((Mascara & (1U << d)) == 0) continue;
+		if (LCD_shadowOf(d, Direccion) == Caracter) continue;
+		Destino |= 1U << d;
+		if (LCD_cgramSelectedOf(d) || LCD_addressOf(d) != Direccion) Mover = true;
+	}
+	if (Destino == 0) return;
+
+	LCD_select(Destino);
+	if (Mover) LCD_command(LCD_SETDDRAMADDR | Direccion);
+	LCD_write(Caracter);
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,286 @@
+/*******************************************************************************
+* @file    LCD_plan.c
+* @author  Guillermo Caporaletti
+* @brief   Actualización de pantalla por el camino más barato según el bus.
+*          Para llegar de lo que muestra el display (la sombra del driver) a
+*          una pantalla nueva, estima el tiempo de cada camino con el costo
+*          de las operaciones del bus en uso (LCDplanCost) y ejecuta el menor:
+*          - sólo lo distinto, con una dirección por tramo, o reescribiendo
+*            caracteres iguales si eso sale más barato que la dirección;
+*          - desplazar el display (si lo nuevo ya está en DDRAM, fuera de lo
+*            que se ve) y luego lo distinto;
+*          - home (vuelve el desplazamiento a 0) y luego lo distinto;
+*          - clear (1,52 ms) y luego lo que no es espacio.
+*          Supone escritura de izquierda a derecha, sin autoscroll.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_plan.h>
+
+/* Private define ------------------------------------------------------------*/
+
+#define LCD_PLAN_MAX_BRIDGE		2		// Caracteres iguales que se reescriben como máximo
+
+/* Exported constants --------------------------------------------------------*/
+
+const LCDplanCost LCD_plan_4bit = {
+	5000, LCD_T_EXEC_US * 1000, LCD_T_CLEAR_US * 1000, 0
+};
+const LCDplanCost LCD_plan_8bit = {
+	3000, LCD_T_EXEC_US * 1000, LCD_T_CLEAR_US * 1000, 0
+};
+// Cada instrucción espera al menos una lectura del busy flag (dos nibbles)
+const LCDplanCost LCD_plan_4bit_busy = {
+	5000, LCD_T_EXEC_US * 1000, LCD_T_CLEAR_US * 1000, 5000
+};
+// Dirección y cuatro bytes del expansor (dos nibbles, con E arriba y abajo):
+// unos 45 bits por byte del display. La ejecución queda oculta en el bus,
+// salvo la de clear y home.
+const LCDplanCost LCD_plan_i2c_100k = {
+	450000, 0, LCD_T_CLEAR_US * 1000, 0
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t LCD_plan_walk(const char * const Filas[], const LCDplanCost * Costo, LCDplan * Plan, bool Ejecutar);
+static uint8_t LCD_plan_address(const LCDplan * Plan, uint8_t col, uint8_t row);
+static bool LCD_plan_split(void);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Arma un modelo de costo con los tiempos en uso del driver
+* @param  Modelo, tiempo de transferencia de un byte y de una lectura del busy
+*         flag (0 con tiempos fijos), en nanosegundos
+* @retval None
+*/
+void LCD_planCostInit(LCDplanCost * Costo, uint32_t bus_ns, uint32_t poll_ns) {
+	const LCDtiming * Perfil = LCD_getTiming();
+	Costo->bus_ns = bus_ns;
+	Costo->exec_ns = Perfil->exec_us * 1000;
+	Costo->clear_ns = Perfil->clear_us * 1000;
+	Costo->poll_ns = poll_ns;
+}
+
+/*******************************************************************************
+* @brief  Elige el camino más barato hasta una pantalla nueva (no envía nada)
+* @param  Filas de la pantalla nueva (como LCD_printScreen; las cortas se
+*         completan con espacios), modelo de costo y plan elegido
+* @retval None
+* @note   El glifo 0 de CGRAM no puede ir en un texto: se escribe como 8, que
+*         en el HD44780 es el mismo glifo.
+*/
+void LCD_planMake(const char * const Filas[], const LCDplanCost * Costo, LCDplan * Plan) {
+	uint32_t Operacion = Costo->bus_ns + Costo->exec_ns + Costo->poll_ns;
+	uint32_t Borrado = Costo->bus_ns + Costo->clear_ns + Costo->poll_ns;
+	LCDplan Prueba;
+
+	Plan->kind = LCD_PLAN_DIFF;
+	Plan->scroll = 0;
+	Plan->cost_ns = LCD_plan_walk(Filas, Costo, Plan, false);
+
+	Prueba.kind = LCD_PLAN_CLEAR;
+	Prueba.scroll = 0;
+	Prueba.cost_ns = Borrado + LCD_plan_walk(Filas, Costo, &Prueba, false);
+	if (Prueba.cost_ns < Plan->cost_ns) *Plan = Prueba;
+
+	// Home sólo tiene sentido con el display desplazado
+	if (LCD_scrolledAddress(0, 0, 0) != LCD_cellAddress(0, 0)) {
+		Prueba.kind = LCD_PLAN_HOME;
+		Prueba.cost_ns = Borrado + LCD_plan_walk(Filas, Costo, &Prueba, false);
+		if (Prueba.cost_ns < Plan->cost_ns) *Plan = Prueba;
+	}
+
+	// Con dos controladores el desplazamiento mueve las dos mitades: no lo pruebo
+	if (LCD_plan_split()) return;
+	Prueba.kind = LCD_PLAN_SCROLL;
+	for (int8_t k=-LCD_PLAN_MAX_SCROLL; k<=LCD_PLAN_MAX_SCROLL; k++) {
+		if (k == 0) continue;
+		uint32_t Desplazar = (uint32_t) (k < 0 ? -k : k) * Operacion;
+		if (Desplazar >= Plan->cost_ns) continue;
+		Prueba.scroll = k;
+		Prueba.cost_ns = Desplazar + LCD_plan_walk(Filas, Costo, &Prueba, false);
+		if (Prueba.cost_ns < Plan->cost_ns) *Plan = Prueba;
+	}
+}
+
+/*******************************************************************************
+* @brief  Ejecuta un plan armado con LCD_planMake
+* @param  Filas de la pantalla nueva (las mismas del plan) y plan
+* @retval None
+* @note   El plan vale mientras no cambie lo que hay en el display. Con
+*         LCD_PLAN_SCROLL el display queda desplazado: las funciones que
+*         ubican el cursor con LCD_setCursor() (LCD_service, LCD_field, etc.)
+*         no lo tienen en cuenta, así que no conviene mezclarlas con el plan
+*         hasta volver con LCD_home() o LCD_clear().
+*/
+void LCD_planRun(const char * const Filas[], const LCDplan * Plan) {
+	LCDplan Copia = *Plan;
+
+	switch (Plan->kind) {
+	case LCD_PLAN_CLEAR:
+		LCD_clear();
+		break;
+	case LCD_PLAN_HOME:
+		LCD_home();
+		break;
+	case LCD_PLAN_SCROLL:
+		for (int8_t k=0; k<Plan->scroll; k++) LCD_scrollDisplayLeft();
+		for (int8_t k=0; k>Plan->scroll; k--) LCD_scrollDisplayRight();
+		// Ya desplazado, lo distinto se busca con el desplazamiento nuevo
+		Copia.kind = LCD_PLAN_DIFF;
+		break;
+	default:
+		break;
+	}
+	LCD_plan_walk(Filas, NULL, &Copia, true);
+}
+
+/*******************************************************************************
+* @brief  Lleva el display a una pantalla nueva por el camino más barato
+* @param  Filas de la pantalla nueva y modelo de costo
+* @retval Tiempo estimado en nanosegundos
+*/
+uint32_t LCD_planUpdate(const char * const Filas[], const LCDplanCost * Costo) {
+	LCDplan Plan;
+	LCD_planMake(Filas, Costo, &Plan);
+	LCD_planRun(Filas, &Plan);
+	return Plan.cost_ns;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Recorre la pantalla nueva contra la base del plan
+* @param  Filas, modelo de costo (NULL al ejecutar), plan y si se envía
+* @retval Tiempo estimado del recorrido (sin el clear, home o desplazamiento)
+* @note   Recorre las filas en orden de DDRAM (LCD_rowOrder), para que el AC
+*         pase solo de una fila a la siguiente cuando las direcciones siguen.
+*         Los caracteres iguales que siguen al AC se guardan como puente:
+*         al llegar a uno distinto, se reescriben si son menos que los
+*         comandos para ubicar el AC. Como un dato y un comando cuestan lo
+*         mismo (un byte y una ejecución), el puente sólo conviene cuando
+*         ubicar el AC lleva dos comandos (dos controladores y display
+*         desplazado); la decisión no depende del bus y se repite igual al
+*         ejecutar.
+*/
+static uint32_t LCD_plan_walk(const char * const Filas[], const LCDplanCost * Costo, LCDplan * Plan, bool Ejecutar) {
+	uint8_t Orden[LCD_MAX_LINES];
+	uint8_t Cantidad = LCD_rowOrder(Orden);
+	uint8_t Columnas = LCD_columns();
+	bool Dividida = LCD_plan_split();
+	bool Blanco = (Plan->kind == LCD_PLAN_CLEAR);
+	uint32_t Operacion = Ejecutar ? 0 : Costo->bus_ns + Costo->exec_ns + Costo->poll_ns;
+	uint32_t Total = 0;
+
+	uint8_t Puente[LCD_PLAN_MAX_BRIDGE];
+	uint8_t Largo = 0;
+
+	// Dónde está el AC antes de empezar
+	bool Ubicado;
+	uint8_t Display, Ac;
+	if (Plan->kind == LCD_PLAN_CLEAR || Plan->kind == LCD_PLAN_HOME) {
+		Ubicado = true;
+		Display = LCD_cellDisplay(0, Orden[0]);
+		Ac = 0;
+	} else if (Dividida) {
+		uint8_t Seleccion = LCD_selected();
+		Display = (uint8_t) __builtin_ctz(Seleccion | 0x80);
+		Ubicado = (Seleccion == (1U << Display)) && !LCD_cgramSelectedOf(Display);
+		Ac = LCD_addressOf(Display);
+	} else {
+		Display = LCD_cellDisplay(0, 0);
+		Ubicado = !LCD_cgramSelected();
+		Ac = LCD_address();
+	}
+	uint8_t Siguiente = Ac;		// Hasta dónde llega el puente
+
+	Plan->writes = 0;
+	Plan->jumps = 0;
+
+	for (uint8_t i=0; i<Cantidad; i++) {
+		uint8_t row = Orden[i];
+		const char * Texto = Filas[row];
+		bool Terminada = false;
+
+		for (uint8_t col=0; col<Columnas; col++) {
+			uint8_t Nuevo = Terminada ? ' ' : (uint8_t) Texto[col];
+			if (Nuevo == '\0') {
+				Terminada = true;
+				Nuevo = ' ';
+			}
+			uint8_t d = LCD_cellDisplay(col, row);
+			uint8_t Direccion = LCD_plan_address(Plan, col, row);
+			uint8_t Viejo = Blanco ? ' ' : LCD_shadowOf(d, Direccion);
+			bool Mismo = Ubicado && d == Display;
+
+			if (Nuevo == Viejo) {
+				// Igual: lo anoto si alarga el puente, si no el puente se corta
+				if (!Mismo) continue;
+				if (Direccion != Siguiente || Largo >= LCD_PLAN_MAX_BRIDGE) {
+					Largo = 0;
+					Siguiente = Ac;
+				}
+				if (Direccion == Siguiente) {
+					Puente[Largo++] = Nuevo;
+					Siguiente = LCD_nextAddress(Direccion);
+				}
+				continue;
+			}
+
+			// Distinto: llego por el puente o con una dirección
+			uint8_t Saltos = (Dividida && Direccion != LCD_cellAddress(col, row)) ? 2 : 1;
+			if (Mismo && Direccion == Siguiente && Largo < Saltos) {
+				Plan->writes += Largo;
+				Total += Largo * Operacion;
+				for (uint8_t k=0; Ejecutar && k<Largo; k++) LCD_write(Puente[k]);
+			} else {
+				Plan->jumps += Saltos;
+				Total += Saltos * Operacion;
+				if (Ejecutar) {
+					if (Dividida) LCD_setCursor(col, row);
+					if (!Dividida || Saltos > 1) LCD_command(LCD_SETDDRAMADDR | Direccion);
+				}
+			}
+			Plan->writes++;
+			Total += Operacion;
+			if (Ejecutar) LCD_write(Nuevo);
+
+			Ubicado = true;
+			Display = d;
+			Ac = Siguiente = LCD_nextAddress(Direccion);
+			Largo = 0;
+		}
+	}
+	return Total;
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM de una posición de pantalla, según el plan
+* @param  Plan, columna y fila
+* @retval Dirección
+*/
+static uint8_t LCD_plan_address(const LCDplan * Plan, uint8_t col, uint8_t row) {
+	switch (Plan->kind) {
+	case LCD_PLAN_CLEAR:
+	case LCD_PLAN_HOME:
+		return LCD_cellAddress(col, row);
+	case LCD_PLAN_SCROLL:
+		return LCD_scrolledAddress(col, row, Plan->scroll);
+	default:
+		return LCD_scrolledAddress(col, row, 0);
+	}
+}
+
+/*******************************************************************************
+* @brief  Indica si la pantalla está repartida en dos controladores
+* @param  None
+* @retval true con dos controladores
+*/
+static bool LCD_plan_split(void) {
+	return LCD_cellDisplay(0, 0) != LCD_cellDisplay(0, LCD_lines() - 1);
+}
+
+/***************************************************************END OF FILE****/
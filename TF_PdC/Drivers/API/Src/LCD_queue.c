@@ -0,0 +1,311 @@
+/*******************************************************************************
+* @file    LCD_queue.c
+* @author  Guillermo Caporaletti
+* @brief   Acceso al LCD desde varias tareas (RTOS).
+*          El driver no está protegido: sólo la tarea del display lo usa, a
+*          través de LCD_queueService(). Las demás tareas tienen dos caminos,
+*          ninguno de los cuales espera al bus ni toma un mutex:
+*          - Una cola acotada de operaciones (comando, texto en una posición,
+*            glifo de CGRAM), con varios productores y un consumidor. Cada
+*            lugar lleva un número de secuencia; el productor reserva el
+*            lugar con un CAS sobre el índice de entrada y lo publica al
+*            actualizar la secuencia. Si la cola está llena, la operación se
+*            descarta y se cuenta.
+*          - Un cuadro compartido de caracteres, del tamaño del display. Cada
+*            celda se escribe de forma atómica y queda marcada como propia
+*            del cuadro; el consumidor envía las celdas propias que difieren
+*            de la sombra de DDRAM del driver.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_queue.h>
+#include <stdatomic.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define LCD_FRAME_WORDS		((LCD_FRAME_COLS + 31) / 32)	// Palabras de 32 bits por fila
+
+/* Private types -------------------------------------------------------------*/
+
+typedef enum {LCD_OP_COMMAND, LCD_OP_PRINT, LCD_OP_CHAR} LCD_op_type;
+
+typedef struct {
+	uint8_t type;
+	uint8_t col;			// Columna o lugar de CGRAM
+	uint8_t row;
+	uint8_t length;
+	uint8_t data[LCD_QUEUE_TEXT];
+} LCDop;
+
+typedef struct {
+	atomic_uint sequence;	// Lugar libre: índice; publicado: índice + 1
+	LCDop op;
+} LCDslot;
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCDslot Cola[LCD_QUEUE_SIZE];
+static atomic_uint Entrada;			// Próximo lugar a reservar (productores)
+static unsigned int Salida;			// Próximo lugar a leer (sólo consumidor)
+static atomic_uint Descartadas;
+
+static _Atomic uint8_t Cuadro[LCD_FRAME_ROWS][LCD_FRAME_COLS];
+static atomic_uint_least32_t Propias[LCD_FRAME_ROWS][LCD_FRAME_WORDS];	// Un bit por columna
+static uint8_t Columnas, Filas;		// Las del display (fijas desde LCD_queueInit)
+
+_Static_assert((LCD_QUEUE_SIZE & (LCD_QUEUE_SIZE - 1)) == 0, "LCD_QUEUE_SIZE debe ser potencia de 2");
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool LCD_queue_push(const LCDop * Op);
+static bool LCD_queue_pop(LCDop * Op);
+static void LCD_queue_execute(const LCDop * Op);
+static void LCD_frame_flush(void);
+static void LCD_queue_ready(void);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Vacía la cola y el cuadro
+* @param  None
+* @retval false si el display no entra en el cuadro (LCD_FRAME_COLS x
+*         LCD_FRAME_ROWS): la cola funciona, pero el cuadro queda sin celdas
+* @note   Llamar luego de LCD_init y antes de arrancar las tareas productoras.
+*         Registra el aviso de fin de clear y home (LCD_onReady) para
+*         despertar a la tarea.
+*/
+bool LCD_queueInit(void) {
+	bool Entra = (LCD_columns() <= LCD_FRAME_COLS) && (LCD_lines() <= LCD_FRAME_ROWS);
+	Columnas = Entra ? LCD_columns() : 0;
+	Filas = Entra ? LCD_lines() : 0;
+
+	for (unsigned int i=0; i<LCD_QUEUE_SIZE; i++) {
+		atomic_init(&Cola[i].sequence, i);
+	}
+	atomic_init(&Entrada, 0);
+	atomic_init(&Descartadas, 0);
+	Salida = 0;
+	LCD_frameRelease();
+	LCD_onReady(LCD_queue_ready);
+	return Entra;
+}
+
+/*******************************************************************************
+* @brief  Encola un comando (LCD_CLEARDISPLAY, LCD_DISPLAYCONTROL | ..., etc.)
+* @param  Comando
+* @retval false si la cola estaba llena (se descarta)
+*/
+bool LCD_queueCommand(uint8_t Comando) {
+	LCDop Op = {.type = LCD_OP_COMMAND, .length = 1, .data = {Comando}};
+	return LCD_queue_push(&Op);
+}
+
+/*******************************************************************************
+* @brief  Encola un texto en una posición
+* @param  Columna, fila y texto (se envían hasta LCD_QUEUE_TEXT caracteres)
+* @retval false si la cola estaba llena (se descarta)
+* @note   Cada operación lleva su posición, así que textos de distintas
+*         tareas no se mezclan aunque se encolen intercalados.
+*/
+bool LCD_queuePrint(uint8_t col, uint8_t row, const char * Texto) {
+	LCDop Op = {.type = LCD_OP_PRINT, .col = col, .row = row};
+	Op.length = (uint8_t) strnlen(Texto, LCD_QUEUE_TEXT);
+	memcpy(Op.data, Texto, Op.length);
+	return LCD_queue_push(&Op);
+}
+
+/*******************************************************************************
+* @brief  Encola la carga de un caracter propio en CGRAM (como LCD_createChar)
+* @param  Lugar (0 a 7) y las 8 filas del caracter
+* @retval false si la cola estaba llena (se descarta)
+*/
+bool LCD_queueChar(uint8_t location, const uint8_t charmap[8]) {
+	LCDop Op = {.type = LCD_OP_CHAR, .col = location & 0x7, .length = 8};
+	memcpy(Op.data, charmap, 8);
+	return LCD_queue_push(&Op);
+}
+
+/*******************************************************************************
+* @brief  Operaciones descartadas por cola llena
+* @param  None
+* @retval Cantidad desde LCD_queueInit
+*/
+uint32_t LCD_queueDropped(void) {
+	return atomic_load_explicit(&Descartadas, memory_order_relaxed);
+}
+
+/*******************************************************************************
+* @brief  Escribe un caracter en el cuadro compartido
+* @param  Columna, fila y caracter
+* @retval None
+*/
+void LCD_frameSet(uint8_t col, uint8_t row, uint8_t Caracter) {
+	if (col >= Columnas || row >= Filas) return;
+	atomic_store_explicit(&Cuadro[row][col], Caracter, memory_order_relaxed);
+	atomic_fetch_or_explicit(&Propias[row][col / 32], 1UL << (col % 32), memory_order_release);
+}
+
+/*******************************************************************************
+* @brief  Escribe un texto en el cuadro compartido
+* @param  Columna, fila y texto (se recorta al final de la fila)
+* @retval None
+*/
+void LCD_framePrint(uint8_t col, uint8_t row, const char * Texto) {
+	while (*Texto != '\0' && col < Columnas) {
+		LCD_frameSet(col++, row, (uint8_t) *Texto++);
+	}
+}
+
+/*******************************************************************************
+* @brief  Libera todas las celdas del cuadro (lo que muestran queda en pantalla)
+* @param  None
+* @retval None
+*/
+void LCD_frameRelease(void) {
+	for (uint8_t row=0; row<LCD_FRAME_ROWS; row++) {
+		for (uint8_t w=0; w<LCD_FRAME_WORDS; w++) {
+			atomic_store_explicit(&Propias[row][w], 0, memory_order_relaxed);
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Ejecuta operaciones encoladas y luego envía los cambios del cuadro
+* @param  Máximo de operaciones a ejecutar (0: todas las que haya)
+* @retval Operaciones ejecutadas
+* @note   Es el único lugar que toca el bus: llamarlo sólo desde la tarea del
+*         display (o desde el lazo principal si no hay RTOS). Con la espera
+*         por interrupción (LCD_busyEvent), vuelve en cuanto queda un clear
+*         o home en curso: la tarea puede dormir hasta LCD_QUEUE_SIGNAL_FROM_ISR
+*         y seguir luego con lo que quedó en la cola.
+*/
+uint16_t LCD_queueService(uint16_t Maximo) {
+	LCDop Op;
+	uint16_t Hechas = 0;
+
+	while ((Maximo == 0 || Hechas < Maximo) && !LCD_busyPending() && LCD_queue_pop(&Op)) {
+		LCD_queue_execute(&Op);
+		Hechas++;
+	}
+	if (!LCD_busyPending()) LCD_frame_flush();
+	return Hechas;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Reserva un lugar, copia la operación y la publica
+* @param  Operación
+* @retval false si la cola estaba llena
+*/
+static bool LCD_queue_push(const LCDop * Op) {
+	unsigned int Pos = atomic_load_explicit(&Entrada, memory_order_relaxed);
+	LCDslot * Lugar;
+
+	for (;;) {
+		Lugar = &Cola[Pos & (LCD_QUEUE_SIZE - 1)];
+		unsigned int Secuencia = atomic_load_explicit(&Lugar->sequence, memory_order_acquire);
+		int Diferencia = (int) (Secuencia - Pos);
+
+		if (Diferencia == 0) {
+			// Lugar libre: intento reservarlo (si otro productor ganó, Pos se actualiza)
+			if (atomic_compare_exchange_weak_explicit(&Entrada, &Pos, Pos + 1,
+					memory_order_relaxed, memory_order_relaxed)) break;
+		} else if (Diferencia < 0) {
+			// El consumidor todavía no liberó este lugar: cola llena
+			atomic_fetch_add_explicit(&Descartadas, 1, memory_order_relaxed);
+			return false;
+		} else {
+			// Otro productor ya lo tomó
+			Pos = atomic_load_explicit(&Entrada, memory_order_relaxed);
+		}
+	}
+
+	Lugar->op = *Op;
+	atomic_store_explicit(&Lugar->sequence, Pos + 1, memory_order_release);
+	LCD_QUEUE_SIGNAL();
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Saca la operación más vieja (sólo el consumidor)
+* @param  Dónde copiarla
+* @retval false si no hay operaciones publicadas
+* @note   Si un productor reservó un lugar pero todavía no lo publicó, la
+*         cola se detiene ahí hasta la próxima llamada.
+*/
+static bool LCD_queue_pop(LCDop * Op) {
+	LCDslot * Lugar = &Cola[Salida & (LCD_QUEUE_SIZE - 1)];
+	unsigned int Secuencia = atomic_load_explicit(&Lugar->sequence, memory_order_acquire);
+
+	if (Secuencia != Salida + 1) return false;
+
+	*Op = Lugar->op;
+	atomic_store_explicit(&Lugar->sequence, Salida + LCD_QUEUE_SIZE, memory_order_release);
+	Salida++;
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Ejecuta una operación con el driver
+* @param  Operación
+* @retval None
+*/
+static void LCD_queue_execute(const LCDop * Op) {
+	switch (Op->type) {
+	case LCD_OP_COMMAND:
+		// Clear y home por sus funciones: pueden terminar por interrupción
+		if (Op->data[0] == LCD_CLEARDISPLAY) LCD_clear();
+		else if (Op->data[0] == LCD_RETURNHOME) LCD_home();
+		else LCD_command(Op->data[0]);
+		break;
+	case LCD_OP_PRINT:
+		LCD_setCursor(Op->col, Op->row);
+		LCD_printn((const char *) Op->data, Op->length);
+		break;
+	case LCD_OP_CHAR:
+		LCD_createChar(Op->col, Op->data);
+		break;
+	default:
+		break;
+	}
+}
+
+/*******************************************************************************
+* @brief  Envía las celdas propias del cuadro que difieren de la sombra
+* @param  None
+* @retval None
+* @note   Supone escritura de izquierda a derecha (LCD_leftToRight). Sólo
+*         manda la dirección cuando el AC no quedó ya en la celda.
+*/
+static void LCD_frame_flush(void) {
+	for (uint8_t row=0; row<Filas; row++) {
+		for (uint8_t w=0; w<LCD_FRAME_WORDS; w++) {
+			uint32_t Mascara = atomic_load_explicit(&Propias[row][w], memory_order_acquire);
+
+			for (uint8_t col=w*32; Mascara != 0; col++, Mascara >>= 1) {
+				if ((Mascara & 1) == 0) continue;
+
+				uint8_t Caracter = atomic_load_explicit(&Cuadro[row][col], memory_order_relaxed);
+				if (LCD_cellShadow(col, row) == Caracter) continue;
+
+				if (!LCD_cursorAt(col, row)) LCD_setCursor(col, row);
+				LCD_write(Caracter);
+			}
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Fin de un clear o home esperado por interrupción
+* @param  None
+* @retval None
+* @note   Se llama desde la interrupción del busy flag.
+*/
+static void LCD_queue_ready(void) {
+	LCD_QUEUE_SIGNAL_FROM_ISR();
+}
+
+/***************************************************************END OF FILE****/
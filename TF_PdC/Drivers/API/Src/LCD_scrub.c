@@ -0,0 +1,115 @@
+/*******************************************************************************
+* @file    LCD_scrub.c
+* @author  Guillermo Caporaletti
+* @brief   Verificación de DDRAM contra la copia en sombra, en segundo plano.
+*          Con la conexión open drain a 3,3V (ver README) puede aparecer algún
+*          caracter corrupto por ruido. Cada llamada lee unas pocas celdas por
+*          RW, corrige las que no coinciden con la sombra y lleva estadísticas.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_scrub.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint8_t Proxima = 0x00;		// Próxima dirección de DDRAM a verificar
+static LCDscrubStats Estadisticas;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static bool LCD_scrub_repair(uint8_t Direccion);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Verifica celdas de DDRAM hasta agotar el presupuesto de tiempo
+* @param  Presupuesto en microsegundos
+* @retval Cantidad de celdas verificadas
+* @note   Deja el AC donde estaba, para no molestar a la aplicación. Si el
+*         presupuesto no alcanza para el costo fijo (lo que falta de la
+*         instrucción anterior, la dirección y la vuelta del AC) y una celda
+*         con su corrección, no envía nada y devuelve 0.
+*/
+uint16_t LCD_scrub(uint32_t Presupuesto_us) {
+	uint16_t Verificadas = 0;
+	uint32_t Inicio = LCD_cycles();
+	uint32_t Gastado = 0;
+
+	// Costos con el perfil en uso: una celda con su corrección, y el fijo
+	uint32_t Transferencia_us = LCD_getTiming()->exec_us + LCD_SCRUB_TRANSFER_US;
+	uint32_t Celda_us = Transferencia_us * (1 + LCD_SCRUB_REPAIR_TRANSFERS);
+	uint32_t Fijo_us = Transferencia_us * LCD_SCRUB_OVERHEAD_TRANSFERS;
+
+	if (!LCD_canRead()) return 0;	// <-- Sin RW no hay cómo leer
+	if (LCD_readyIn() + Fijo_us + Celda_us > Presupuesto_us) return 0;
+
+	// Guardo el AC de la aplicación
+	uint8_t Direccion_previa = LCD_address();
+	bool Previa_en_cgram = LCD_cgramSelected();
+
+	// Las lecturas consecutivas avanzan solas: una sola dirección por tanda
+	LCD_command(LCD_SETDDRAMADDR | Proxima);
+	do {
+		uint8_t Direccion = LCD_address();
+		uint8_t Leido = LCD_data_read();
+		Estadisticas.checked++;
+		Verificadas++;
+
+		if (Leido != LCD_shadow(Direccion)) {
+			Estadisticas.errors++;
+			if (LCD_scrub_repair(Direccion)) Estadisticas.repaired++;
+			else Estadisticas.failed++;
+		}
+
+		// El AC sigue el sentido del entry mode; sigo por donde quedó
+		Proxima = LCD_address();
+		if (Proxima == 0x00) Estadisticas.passes++;
+
+		// Sigo sólo si alcanza el tiempo para una celda más (y su posible
+		// corrección), dejando lo de la vuelta del AC
+		Gastado = (LCD_cycles() - Inicio) / LCD_CYCLES_PER_US;
+	} while (Gastado + Celda_us + Transferencia_us <= Presupuesto_us);
+
+	// Devuelvo el AC a la aplicación
+	LCD_command((Previa_en_cgram ? LCD_SETCGRAMADDR : LCD_SETDDRAMADDR) | Direccion_previa);
+
+	return Verificadas;
+}
+
+/*******************************************************************************
+* @brief  Estadísticas de verificación acumuladas
+* @param  None
+* @retval Puntero a las estadísticas
+*/
+const LCDscrubStats * LCD_scrubStats(void) {
+	return &Estadisticas;
+}
+
+/*******************************************************************************
+* @brief  Pone a cero las estadísticas
+* @param  None
+* @retval None
+*/
+void LCD_scrubStatsReset(void) {
+	memset(&Estadisticas, 0, sizeof(Estadisticas));
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Reescribe una celda desde la sombra y la vuelve a leer
+* @param  Dirección de DDRAM
+* @retval true si quedó bien
+* @note   Luego de escribir hay que volver a fijar la dirección antes de leer
+*         (ver hoja de datos). Al salir el AC queda en la celda siguiente a la corregida.
+*/
+static bool LCD_scrub_repair(uint8_t Direccion) {
+	LCD_command(LCD_SETDDRAMADDR | Direccion);
+	LCD_write(LCD_shadow(Direccion));
+	LCD_command(LCD_SETDDRAMADDR | Direccion);
+	return LCD_data_read() == LCD_shadow(Direccion);
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,315 @@
+/*******************************************************************************
+* @file    LCD_selftest.c
+* @author  Guillermo Caporaletti
+* @brief   Prueba aleatoria del driver contra un modelo de referencia del HD44780.
+*          Sortea secuencias largas de llamadas (print, setCursor, scroll,
+*          modos de escritura, createChar, autoscroll...) y las aplica al
+*          driver y a un modelo simple del controlador, escrito aparte del
+*          driver. Después de cada paso compara el modelo con lo que el
+*          driver cree (AC y sombra de DDRAM) y, si RW está conectado, con el
+*          display: el AC en cada paso y toda la DDRAM y la CGRAM escrita
+*          cada LCD_SELFTEST_FULL_EVERY pasos. Sirve para comprobar que las
+*          optimizaciones que cambian la secuencia del bus (diferencias,
+*          seguimiento del AC, agrupado) dejan la pantalla igual.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_selftest.h>
+
+/* Private types -------------------------------------------------------------*/
+
+// Modelo del controlador: sólo lo que se ve desde afuera
+typedef struct {
+	uint8_t ddram[0x80];
+	uint8_t cgram[64];
+	bool cgram_known[64];	// Lugares de CGRAM que escribió la prueba
+	uint8_t ac;
+	bool cgram_selected;
+	bool increment;			// I/D
+	bool shift;				// S (autoscroll)
+	int16_t display_shift;	// Desplazamiento de la imagen (no se puede releer)
+	bool two_lines;
+} LCDmodel;
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCDmodel Modelo;
+static uint32_t Azar;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t LCD_test_random(uint32_t Rango);
+static void LCD_test_step(LCD_test_op Op);
+static void LCD_model_reset(void);
+static void LCD_model_write(uint8_t Dato);
+static uint8_t LCD_model_next(uint8_t Direccion, bool Incremento);
+static bool LCD_model_valid(uint8_t Direccion);
+static bool LCD_test_check_driver(void);
+static bool LCD_test_check_display(bool Completo, uint32_t * Lecturas);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Corre una secuencia aleatoria y la verifica paso a paso
+* @param  Semilla (distinta de 0), cantidad de pasos y dónde dejar el reporte
+* @retval true si el driver y el display coincidieron siempre con el modelo
+* @note   Borra la pantalla y usa toda la CGRAM: al terminar la deja borrada,
+*         de izquierda a derecha y sin autoscroll. Si se usa LCD_charset,
+*         llamar luego a LCD_charsetReset(). Con dos controladores, prueba
+*         el del cursor.
+*/
+bool LCD_selftest(uint32_t Semilla, uint32_t Pasos, LCDselftestReport * Reporte) {
+	LCDselftestReport Local;
+	if (Reporte == NULL) Reporte = &Local;
+	memset(Reporte, 0, sizeof(*Reporte));
+	Reporte->seed = Semilla;
+	Azar = (Semilla != 0) ? Semilla : 1;
+
+	// Punto de partida conocido
+	LCD_clear();
+	LCD_leftToRight();
+	LCD_noAutoscroll();
+	LCD_model_reset();
+
+	bool Bien = LCD_test_check_driver() && LCD_test_check_display(true, &Reporte->hw_reads);
+
+	for (uint32_t Paso=1; Bien && Paso<=Pasos; Paso++) {
+		LCD_test_op Op = (LCD_test_op) LCD_test_random(LCD_TEST_OPS);
+
+		// Los borrados son lentos (1,52 ms): los sorteo menos. El cursor
+		// sólo se mueve en DDRAM (en CGRAM la hoja de datos no lo define).
+		if (Op == LCD_TEST_CLEAR && LCD_test_random(8) != 0) Op = LCD_TEST_PRINT;
+		if (Op == LCD_TEST_CURSORMOVE && Modelo.cgram_selected) Op = LCD_TEST_SETCURSOR;
+
+		uint32_t Inicio = LCD_cycles();
+		LCD_test_step(Op);
+		Reporte->api_cycles += LCD_cycles() - Inicio;
+		Reporte->steps = Paso;
+
+		Bien = LCD_test_check_driver() &&
+			   LCD_test_check_display((Paso % LCD_SELFTEST_FULL_EVERY) == 0, &Reporte->hw_reads);
+		if (!Bien) {
+			Reporte->failed_step = Paso;
+			Reporte->failed_op = Op;
+		}
+	}
+
+	if (Reporte->api_cycles != 0) {
+		Reporte->ops_per_second = (uint32_t) (((uint64_t) Reporte->steps * LCD_CORE_CLOCK_HZ) / Reporte->api_cycles);
+	}
+
+	// Dejo el display en un estado conocido
+	LCD_clear();
+	LCD_leftToRight();
+	LCD_noAutoscroll();
+	return Bien;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Número pseudoaleatorio (xorshift32)
+* @param  Rango
+* @retval Número entre 0 y Rango-1
+*/
+static uint32_t LCD_test_random(uint32_t Rango) {
+	Azar ^= Azar << 13;
+	Azar ^= Azar >> 17;
+	Azar ^= Azar << 5;
+	return Azar % Rango;
+}
+
+/*******************************************************************************
+* @brief  Sortea los argumentos de una operación y la aplica al driver y al modelo
+* @param  Operación
+* @retval None
+*/
+static void LCD_test_step(LCD_test_op Op) {
+	char Texto[LCD_SELFTEST_TEXT + 1];
+	uint8_t Mapa[8];
+	uint8_t Largo, col, row, Lugar;
+	bool Sentido;
+
+	switch (Op) {
+	case LCD_TEST_PRINT:
+		Largo = 1 + LCD_test_random(LCD_SELFTEST_TEXT);
+		for (uint8_t i=0; i<Largo; i++) Texto[i] = (char) (0x20 + LCD_test_random(0x5F));
+		Texto[Largo] = '\0';
+		LCD_print(Texto);
+		for (uint8_t i=0; i<Largo; i++) LCD_model_write((uint8_t) Texto[i]);
+		break;
+
+	case LCD_TEST_WRITE:
+		// Incluye los códigos de CGRAM (0 a 7) y la mitad alta de la ROM
+		Largo = (uint8_t) LCD_test_random(256);
+		if (Largo >= 0x08 && Largo < 0x20) Largo = ' ';
+		LCD_write(Largo);
+		LCD_model_write(Largo);
+		break;
+
+	case LCD_TEST_SETCURSOR:
+		// Sólo filas del mismo controlador que la fila 0, y direcciones que existan
+		do {
+			col = (uint8_t) LCD_test_random(40);
+			row = (uint8_t) LCD_test_random(4);
+		} while (LCD_cellDisplay(0, row) != LCD_cellDisplay(0, 0) || !LCD_model_valid(LCD_cellAddress(col, row)));
+		LCD_setCursor(col, row);
+		Modelo.ac = LCD_cellAddress(col, row) & 0x7F;
+		Modelo.cgram_selected = false;
+		break;
+
+	case LCD_TEST_CURSORMOVE:
+		Sentido = LCD_test_random(2);
+		LCD_command(LCD_CURSORSHIFT | LCD_CURSORMOVE | (Sentido ? LCD_MOVERIGHT : LCD_MOVELEFT));
+		Modelo.ac = LCD_model_next(Modelo.ac, Sentido);
+		break;
+
+	case LCD_TEST_SCROLL:
+		Sentido = LCD_test_random(2);
+		if (Sentido) LCD_scrollDisplayRight();
+		else LCD_scrollDisplayLeft();
+		Modelo.display_shift += Sentido ? 1 : -1;
+		break;
+
+	case LCD_TEST_ENTRYMODE:
+		Modelo.increment = LCD_test_random(2);
+		if (Modelo.increment) LCD_leftToRight();
+		else LCD_rightToLeft();
+		break;
+
+	case LCD_TEST_AUTOSCROLL:
+		Modelo.shift = LCD_test_random(2);
+		if (Modelo.shift) LCD_autoscroll();
+		else LCD_noAutoscroll();
+		break;
+
+	case LCD_TEST_CREATECHAR:
+		Lugar = (uint8_t) LCD_test_random(8);
+		for (uint8_t i=0; i<8; i++) Mapa[i] = (uint8_t) LCD_test_random(0x20);
+		LCD_createChar(Lugar, Mapa);
+		Modelo.ac = Lugar << 3;
+		Modelo.cgram_selected = true;
+		for (uint8_t i=0; i<8; i++) LCD_model_write(Mapa[i]);
+		break;
+
+	case LCD_TEST_HOME:
+		LCD_home();
+		Modelo.ac = 0;
+		Modelo.cgram_selected = false;
+		Modelo.display_shift = 0;
+		break;
+
+	case LCD_TEST_CLEAR:
+	default:
+		LCD_clear();
+		memset(Modelo.ddram, ' ', sizeof(Modelo.ddram));
+		Modelo.ac = 0;
+		Modelo.cgram_selected = false;
+		Modelo.increment = true;
+		Modelo.display_shift = 0;
+		break;
+	}
+}
+
+/*******************************************************************************
+* @brief  Modelo recién borrado (CGRAM desconocida)
+* @param  None
+* @retval None
+*/
+static void LCD_model_reset(void) {
+	memset(&Modelo, 0, sizeof(Modelo));
+	memset(Modelo.ddram, ' ', sizeof(Modelo.ddram));
+	Modelo.increment = true;
+	Modelo.two_lines = LCD_cellAddress(0, 1) == 0x40;
+}
+
+/*******************************************************************************
+* @brief  Escribe un dato en el modelo, como lo haría el HD44780
+* @param  Dato
+* @retval None
+*/
+static void LCD_model_write(uint8_t Dato) {
+	if (Modelo.cgram_selected) {
+		Modelo.cgram[Modelo.ac] = Dato & 0x1F;		// <-- Sólo comparo los 5 bits del dibujo
+		Modelo.cgram_known[Modelo.ac] = true;
+		Modelo.ac = (Modelo.ac + (Modelo.increment ? 1 : -1)) & 0x3F;
+	} else {
+		Modelo.ddram[Modelo.ac] = Dato;
+		Modelo.ac = LCD_model_next(Modelo.ac, Modelo.increment);
+		if (Modelo.shift) Modelo.display_shift += Modelo.increment ? -1 : 1;
+	}
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM siguiente en el modelo
+* @param  Dirección y sentido
+* @retval Dirección
+*/
+static uint8_t LCD_model_next(uint8_t Direccion, bool Incremento) {
+	if (Modelo.two_lines) {
+		// Dos líneas: 0x00-0x27 y 0x40-0x67, encadenadas en anillo
+		if (Incremento) return (Direccion == 0x27) ? 0x40 : (Direccion == 0x67) ? 0x00 : Direccion + 1;
+		return (Direccion == 0x40) ? 0x27 : (Direccion == 0x00) ? 0x67 : Direccion - 1;
+	}
+	if (Incremento) return (Direccion == 0x4F) ? 0x00 : Direccion + 1;
+	return (Direccion == 0x00) ? 0x4F : Direccion - 1;
+}
+
+/*******************************************************************************
+* @brief  Indica si una dirección de DDRAM existe en el modo de líneas en uso
+* @param  Dirección
+* @retval true si existe
+*/
+static bool LCD_model_valid(uint8_t Direccion) {
+	if (Modelo.two_lines) return (Direccion <= 0x27) || (Direccion >= 0x40 && Direccion <= 0x67);
+	return Direccion <= 0x4F;
+}
+
+/*******************************************************************************
+* @brief  Compara el modelo con lo que cree el driver
+* @param  None
+* @retval true si coinciden AC, CGRAM/DDRAM y la sombra de DDRAM
+*/
+static bool LCD_test_check_driver(void) {
+	if (LCD_address() != Modelo.ac || LCD_cgramSelected() != Modelo.cgram_selected) return false;
+	for (uint8_t a=0; a<LCD_DDRAM_SIZE; a++) {
+		if (LCD_model_valid(a) && LCD_shadow(a) != Modelo.ddram[a]) return false;
+	}
+	return true;
+}
+
+/*******************************************************************************
+* @brief  Compara el modelo con el display (si RW está conectado)
+* @param  Releer toda la RAM (si no, sólo el AC) y contador de lecturas
+* @retval true si coinciden
+* @note   Al releer la RAM el AC se mueve: al final lo vuelvo a su lugar.
+*/
+static bool LCD_test_check_display(bool Completo, uint32_t * Lecturas) {
+	if (!LCD_canRead()) return true;
+
+	(*Lecturas)++;
+	if ((LCD_address_read() & 0x7F) != Modelo.ac) return false;
+	if (!Completo) return true;
+
+	bool Bien = true;
+	LCD_command(LCD_SETDDRAMADDR);
+	for (uint8_t a=0; Bien && a<0x80; a++) {
+		if (!LCD_model_valid(a)) continue;
+		if (LCD_address() != a) LCD_command(LCD_SETDDRAMADDR | a);
+		(*Lecturas)++;
+		if (LCD_data_read() != Modelo.ddram[a]) Bien = false;
+	}
+	for (uint8_t a=0; Bien && a<64; a++) {
+		if (!Modelo.cgram_known[a]) continue;
+		LCD_command(LCD_SETCGRAMADDR | a);
+		(*Lecturas)++;
+		if ((LCD_data_read() & 0x1F) != Modelo.cgram[a]) Bien = false;
+	}
+
+	LCD_command((Modelo.cgram_selected ? LCD_SETCGRAMADDR : LCD_SETDDRAMADDR) | Modelo.ac);
+	return Bien;
+}
+
+/***************************************************************END OF FILE****/
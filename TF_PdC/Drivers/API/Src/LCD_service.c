@@ -0,0 +1,150 @@
+/*******************************************************************************
+* @file    LCD_service.c
+* @author  Guillermo Caporaletti
+* @brief   Escritura diferida en pantalla, enviada de a poco desde el lazo
+*          principal con un presupuesto de tiempo.
+*          LCD_servicePrint() y LCD_serviceWrite() no acceden al bus: anotan
+*          lo que debe verse y marcan las celdas distintas a la sombra.
+*          LCD_service() envía esas celdas, una por paso, y antes de cada paso
+*          calcula cuánto tardaría (lo que falta de la instrucción anterior,
+*          la dirección si hace falta y el dato). Si no entra en el
+*          presupuesto, vuelve: el lazo nunca espera más que lo pedido.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_service.h>
+
+/* Compile-time checks -------------------------------------------------------*/
+
+_Static_assert(LCD_SERVICE_COLS <= 64, "LCD_SERVICE_COLS: un bit por columna en 64 bits");
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint8_t Objetivo[LCD_SERVICE_ROWS][LCD_SERVICE_COLS];	// Lo que debe verse
+static uint64_t Pendientes[LCD_SERVICE_ROWS];		// Un bit por celda a enviar
+static uint16_t Cantidad = 0;						// Bits en Pendientes
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_service_mark(uint8_t col, uint8_t row, bool Pendiente);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Anota texto a mostrar (se envía con LCD_service)
+* @param  Columna, fila y texto
+* @retval None
+* @note   El texto que no entra en la fila se descarta.
+*/
+void LCD_servicePrint(uint8_t col, uint8_t row, const char * Texto) {
+	while (*Texto != '\0' && col < LCD_columns()) {
+		LCD_serviceWrite(col++, row, (uint8_t) *Texto++);
+	}
+}
+
+/*******************************************************************************
+* @brief  Anota un caracter a mostrar (se envía con LCD_service)
+* @param  Columna, fila y caracter
+* @retval None
+* @note   Fuera del display (o de LCD_SERVICE_COLS x LCD_SERVICE_ROWS) no
+*         anota nada.
+*/
+void LCD_serviceWrite(uint8_t col, uint8_t row, uint8_t Caracter) {
+	if (col >= LCD_columns() || row >= LCD_lines()) return;
+	if (col >= LCD_SERVICE_COLS || row >= LCD_SERVICE_ROWS) return;
+	Objetivo[row][col] = Caracter;
+	LCD_service_mark(col, row, LCD_cellShadow(col, row) != Caracter);
+}
+
+/*******************************************************************************
+* @brief  Anota la pantalla en blanco (se envía con LCD_service)
+* @param  None
+* @retval None
+* @note   No usa LCD_clear(): sus 1,52 ms no se pueden repartir, mientras que
+*         los espacios se envían de a uno y sólo donde hay algo escrito.
+*/
+void LCD_serviceClear(void) {
+	for (uint8_t row=0; row<LCD_lines(); row++) {
+		for (uint8_t col=0; col<LCD_columns(); col++) {
+			LCD_serviceWrite(col, row, ' ');
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Envía celdas pendientes mientras alcance el presupuesto de tiempo
+* @param  Presupuesto en microsegundos
+* @retval Celdas que quedan pendientes
+* @note   Supone escritura de izquierda a derecha (LCD_leftToRight). Si el
+*         presupuesto no alcanza para un paso (unos 80 us con dirección), no
+*         envía nada. Las celdas que entre tanto otro módulo dejó iguales a lo
+*         anotado se descartan sin enviar. Las filas van en orden de DDRAM
+*         (LCD_rowOrder): en 4 filas, un tramo que sigue de la fila 0 a la 2
+*         no vuelve a enviar la dirección.
+*/
+uint16_t LCD_service(uint32_t Presupuesto_us) {
+	uint32_t Inicio = LCD_cycles();
+	uint32_t Ejecucion_us = LCD_getTiming()->exec_us;
+	uint8_t Orden[LCD_MAX_LINES];
+	uint8_t Lineas = LCD_rowOrder(Orden);
+
+	for (uint8_t i=0; i<Lineas; i++) {
+		uint8_t row = Orden[i];
+		if (row >= LCD_SERVICE_ROWS) continue;
+		while (Pendientes[row] != 0) {
+			uint8_t col = (uint8_t) __builtin_ctzll(Pendientes[row]);
+			uint8_t Caracter = Objetivo[row][col];
+
+			if (LCD_cellShadow(col, row) == Caracter) {
+				LCD_service_mark(col, row, false);
+				continue;
+			}
+
+			// Lo que tardaría este paso: espera, dirección (si hace falta) y dato
+			bool Ubicado = LCD_cursorAt(col, row);
+			uint32_t Paso_us = LCD_readyIn() + LCD_SERVICE_TRANSFER_US;
+			if (!Ubicado) Paso_us += Ejecucion_us + LCD_SERVICE_TRANSFER_US;
+
+			uint32_t Gastado_us = (LCD_cycles() - Inicio) / LCD_CYCLES_PER_US;
+			if (Gastado_us + Paso_us > Presupuesto_us) return Cantidad;
+
+			if (!Ubicado) LCD_setCursor(col, row);
+			LCD_write(Caracter);
+			LCD_service_mark(col, row, false);
+		}
+	}
+	return Cantidad;
+}
+
+/*******************************************************************************
+* @brief  Celdas que faltan enviar
+* @param  None
+* @retval Cantidad
+*/
+uint16_t LCD_servicePending(void) {
+	return Cantidad;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Marca o desmarca una celda como pendiente
+* @param  Columna, fila y estado
+* @retval None
+*/
+static void LCD_service_mark(uint8_t col, uint8_t row, bool Pendiente) {
+	uint64_t Bit = 1ULL << col;
+	bool Estaba = (Pendientes[row] & Bit) != 0;
+
+	if (Pendiente && !Estaba) {
+		Pendientes[row] |= Bit;
+		Cantidad++;
+	} else if (!Pendiente && Estaba) {
+		Pendientes[row] &= ~Bit;
+		Cantidad--;
+	}
+}
+
+/***************************************************************END OF FILE****/
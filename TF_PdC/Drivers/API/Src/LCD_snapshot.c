@@ -0,0 +1,247 @@
+/*******************************************************************************
+* @file    LCD_snapshot.c
+* @author  Guillermo Caporaletti
+* @brief   Imagen de la pantalla (PGM, texto o hash) a partir de la sombra.
+*          Dibuja cada caracter con los puntos de la ROM (A00) o de la CGRAM,
+*          como los mostraría el display, sin leer nada del bus. Sirve para
+*          comparar pantallas con imágenes de referencia en pruebas.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_snapshot.h>
+
+/* Private types -------------------------------------------------------------*/
+
+// Destino de cada fila de puntos
+typedef void (*LCD_snapshot_sink)(const uint8_t * Puntos, uint16_t Ancho, void * Contexto);
+
+typedef struct {
+	uint8_t * Salida;
+} LCDpgm;
+
+typedef struct {
+	char * Salida;
+} LCDtext;
+
+/* Private variables ---------------------------------------------------------*/
+
+// ROM A00, códigos 0x20 a 0x7F: 5 columnas de 7 puntos (bit 0 arriba)
+static const uint8_t Fuente[96][5] = {
+	{0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},	//  !"#
+	{0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00},	// $%&'
+	{0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08},	// ()*+
+	{0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02},	// ,-./
+	{0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31},	// 0123
+	{0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},	// 4567
+	{0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00},	// 89:;
+	{0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06},	// <=>?
+	{0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},	// @ABC
+	{0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x01,0x01}, {0x3E,0x41,0x49,0x49,0x7A},	// DEFG
+	{0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},	// HIJK
+	{0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x0C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},	// LMNO
+	{0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31},	// PQRS
+	{0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},	// TUVW
+	{0x63,0x14,0x08,0x14,0x63}, {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00},	// XYZ[
+	{0x15,0x16,0x7C,0x16,0x15}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},	// ¥]^_
+	{0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20},	// `abc
+	{0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x0C,0x52,0x52,0x52,0x3E},	// defg
+	{0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},	// hijk
+	{0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},	// lmno
+	{0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},	// pqrs
+	{0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},	// tuvw
+	{0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},	// xyz{
+	{0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x08,0x08,0x2A,0x1C,0x08}, {0x08,0x1C,0x2A,0x08,0x08},	// |}→←
+};
+
+// Filas de 5 puntos de la fuente (bit 4 a la izquierda), armadas en la primera imagen
+static uint8_t Filas_fuente[96][7];
+static bool Filas_listas = false;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static const LCDsnapshotSource * LCD_snapshot_source(const LCDsnapshotSource * Origen, LCDsnapshotSource * Sombra);
+static void LCD_snapshot_render(const LCDsnapshotSource * Origen, LCD_snapshot_sink Destino, void * Contexto);
+static uint8_t LCD_snapshot_glyph_row(const LCDsnapshotSource * Origen, uint8_t Codigo, uint8_t Linea);
+static void LCD_snapshot_pgm_row(const uint8_t * Puntos, uint16_t Ancho, void * Contexto);
+static void LCD_snapshot_text_row(const uint8_t * Puntos, uint16_t Ancho, void * Contexto);
+static void LCD_snapshot_hash_row(const uint8_t * Puntos, uint16_t Ancho, void * Contexto);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Imagen de la pantalla en formato PGM binario (P5)
+* @param  Origen (NULL: sombra del driver), buffer y su tamaño
+* @retval Bytes escritos, o 0 si no entran (ver LCD_SNAPSHOT_PGM_SIZE)
+* @note   En la PC se guarda tal cual en un archivo .pgm.
+*/
+size_t LCD_snapshotPGM(const LCDsnapshotSource * Origen, uint8_t * Buffer, size_t Tamanio) {
+	LCDsnapshotSource Sombra;
+	Origen = LCD_snapshot_source(Origen, &Sombra);
+	if (Origen->cols == 0 || Origen->cols > LCD_SNAPSHOT_MAX_COLS || Origen->rows == 0) return 0;
+
+	uint16_t Ancho = LCD_SNAPSHOT_WIDTH(Origen->cols);
+	uint16_t Alto = LCD_SNAPSHOT_HEIGHT(Origen->rows);
+	int Encabezado = snprintf((char *) Buffer, Tamanio, "P5\n%u %u\n255\n", Ancho, Alto);
+	if (Encabezado < 0 || (size_t) Encabezado + (size_t) Ancho * Alto > Tamanio) return 0;
+
+	LCDpgm Pgm = {&Buffer[Encabezado]};
+	LCD_snapshot_render(Origen, LCD_snapshot_pgm_row, &Pgm);
+	return (size_t) (Pgm.Salida - Buffer);
+}
+
+/*******************************************************************************
+* @brief  Imagen de la pantalla como texto ('#' encendido, '.' apagado)
+* @param  Origen (NULL: sombra del driver), buffer y su tamaño
+* @retval Caracteres escritos (sin el '\0'), o 0 si no entran (ver
+*         LCD_SNAPSHOT_TEXT_SIZE)
+* @note   Una línea por fila de puntos; la separación entre caracteres es ' '.
+*/
+size_t LCD_snapshotText(const LCDsnapshotSource * Origen, char * Buffer, size_t Tamanio) {
+	LCDsnapshotSource Sombra;
+	Origen = LCD_snapshot_source(Origen, &Sombra);
+	if (Origen->cols == 0 || Origen->cols > LCD_SNAPSHOT_MAX_COLS || Origen->rows == 0) return 0;
+	if ((size_t) LCD_SNAPSHOT_TEXT_SIZE(Origen->cols, Origen->rows) > Tamanio) return 0;
+
+	LCDtext Texto = {Buffer};
+	LCD_snapshot_render(Origen, LCD_snapshot_text_row, &Texto);
+	*Texto.Salida = '\0';
+	return (size_t) (Texto.Salida - Buffer);
+}
+
+/*******************************************************************************
+* @brief  Hash de la imagen de la pantalla (FNV-1a de 32 bits)
+* @param  Origen (NULL: sombra del driver)
+* @retval Hash
+* @note   No necesita buffer: sirve para comparar cada cuadro de una prueba
+*         con el hash de la imagen de referencia. Dos pantallas con los
+*         mismos puntos dan el mismo hash aunque los códigos sean distintos
+*         (por ejemplo, un glifo de CGRAM igual a una letra de la ROM).
+*/
+uint32_t LCD_snapshotHash(const LCDsnapshotSource * Origen) {
+	LCDsnapshotSource Sombra;
+	Origen = LCD_snapshot_source(Origen, &Sombra);
+	uint32_t Hash = 2166136261UL;
+	if (Origen->cols == 0 || Origen->cols > LCD_SNAPSHOT_MAX_COLS || Origen->rows == 0) return Hash;
+
+	LCD_snapshot_render(Origen, LCD_snapshot_hash_row, &Hash);
+	return Hash;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Origen a usar: el pedido o, si es NULL, la sombra del driver
+* @param  Origen pedido y lugar donde armar el de la sombra
+* @retval Origen
+*/
+static const LCDsnapshotSource * LCD_snapshot_source(const LCDsnapshotSource * Origen, LCDsnapshotSource * Sombra) {
+	if (Origen != NULL) return Origen;
+	Sombra->cols = LCD_columns();
+	Sombra->rows = LCD_lines();
+	Sombra->cell = LCD_cellVisible;
+	Sombra->cgram = LCD_cgramShadow;
+	Sombra->cursor = LCD_cursorShown;
+	return Sombra;
+}
+
+/*******************************************************************************
+* @brief  Dibuja la pantalla fila de puntos por fila de puntos
+* @param  Origen, destino de cada fila y su contexto
+* @retval None
+* @note   Cada fila de puntos tiene un byte por punto: LCD_SNAPSHOT_DOT_ON,
+*         LCD_SNAPSHOT_DOT_OFF o LCD_SNAPSHOT_GAP. Los caracteres de cada
+*         fila de texto se piden una sola vez.
+*/
+static void LCD_snapshot_render(const LCDsnapshotSource * Origen, LCD_snapshot_sink Destino, void * Contexto) {
+	uint8_t Puntos[LCD_SNAPSHOT_WIDTH(LCD_SNAPSHOT_MAX_COLS)];
+	uint8_t Codigos[LCD_SNAPSHOT_MAX_COLS];
+	uint8_t Cursor[LCD_SNAPSHOT_MAX_COLS];
+	uint16_t Ancho = LCD_SNAPSHOT_WIDTH(Origen->cols);
+
+	if (!Filas_listas) {
+		// Paso la fuente de columnas a filas, como las guarda la CGRAM
+		for (uint8_t c=0; c<96; c++) {
+			for (uint8_t y=0; y<7; y++) {
+				uint8_t Fila = 0;
+				for (uint8_t x=0; x<5; x++) {
+					if (Fuente[c][x] & (1U << y)) Fila |= (uint8_t) (0x10 >> x);
+				}
+				Filas_fuente[c][y] = Fila;
+			}
+		}
+		Filas_listas = true;
+	}
+
+	for (uint8_t row=0; row<Origen->rows; row++) {
+		for (uint8_t col=0; col<Origen->cols; col++) {
+			Codigos[col] = Origen->cell(col, row);
+			Cursor[col] = (Origen->cursor != NULL && Origen->cursor(col, row)) ? 0x1F : 0x00;
+		}
+
+		// Separación con la fila de texto anterior
+		if (row > 0) {
+			memset(Puntos, LCD_SNAPSHOT_GAP, Ancho);
+			Destino(Puntos, Ancho, Contexto);
+		}
+
+		for (uint8_t Linea=0; Linea<8; Linea++) {
+			uint8_t * p = Puntos;
+			for (uint8_t col=0; col<Origen->cols; col++) {
+				uint8_t Fila = LCD_snapshot_glyph_row(Origen, Codigos[col], Linea);
+				if (Linea == 7) Fila |= Cursor[col];
+
+				for (uint8_t Bit=0x10; Bit!=0; Bit>>=1) {
+					*p++ = (Fila & Bit) ? LCD_SNAPSHOT_DOT_ON : LCD_SNAPSHOT_DOT_OFF;
+				}
+				if (col + 1 < Origen->cols) *p++ = LCD_SNAPSHOT_GAP;
+			}
+			Destino(Puntos, Ancho, Contexto);
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Fila de puntos de un caracter
+* @param  Origen, código y fila (0 a 7)
+* @retval Fila de 5 puntos (bit 4 a la izquierda)
+* @note   Los códigos 0x00 a 0x0F son los glifos de CGRAM (0x08 a 0x0F repiten
+*         0x00 a 0x07). La fuente sólo tiene la parte ASCII de la ROM: los
+*         códigos sin dibujo se muestran como un rectángulo hueco.
+*/
+static uint8_t LCD_snapshot_glyph_row(const LCDsnapshotSource * Origen, uint8_t Codigo, uint8_t Linea) {
+	if (Codigo < 0x10) return Origen->cgram((uint8_t) ((Codigo & 0x07) << 3) | Linea) & 0x1F;
+	if (Linea == 7) return 0x00;
+	if (Codigo >= 0x20 && Codigo < 0x80) return Filas_fuente[Codigo - 0x20][Linea];
+	return (Linea == 0 || Linea == 6) ? 0x1F : 0x11;
+}
+
+/*******************************************************************************
+* @brief  Destinos de las filas de puntos: PGM, texto y hash
+* @param  Puntos, ancho y contexto
+* @retval None
+*/
+static void LCD_snapshot_pgm_row(const uint8_t * Puntos, uint16_t Ancho, void * Contexto) {
+	LCDpgm * Pgm = (LCDpgm *) Contexto;
+	memcpy(Pgm->Salida, Puntos, Ancho);
+	Pgm->Salida += Ancho;
+}
+
+static void LCD_snapshot_text_row(const uint8_t * Puntos, uint16_t Ancho, void * Contexto) {
+	LCDtext * Texto = (LCDtext *) Contexto;
+	for (uint16_t i=0; i<Ancho; i++) {
+		*Texto->Salida++ = (Puntos[i] == LCD_SNAPSHOT_DOT_ON) ? '#' : (Puntos[i] == LCD_SNAPSHOT_DOT_OFF) ? '.' : ' ';
+	}
+	*Texto->Salida++ = '\n';
+}
+
+static void LCD_snapshot_hash_row(const uint8_t * Puntos, uint16_t Ancho, void * Contexto) {
+	uint32_t Hash = *(uint32_t *) Contexto;
+	for (uint16_t i=0; i<Ancho; i++) {
+		Hash = (Hash ^ Puntos[i]) * 16777619UL;
+	}
+	*(uint32_t *) Contexto = Hash;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* @file    LCD_spark.c
+* @author  Guillermo Caporaletti
+* @brief   Gráfico de tendencia (sparkline) con caracteres propios rotativos.
+*          El gráfico ocupa width caracteres seguidos de una fila, cada uno un
+*          lugar de CGRAM, y cada muestra es una columna de puntos. Los puntos
+*          se guardan de a una columna por byte, en un buffer circular con el
+*          mismo orden que los lugares de CGRAM. Cada muestra nueva cambia
+*          sólo su columna: se envían las filas de CGRAM de ese caracter en
+*          las que cambió algún punto. Cuando se llena el caracter de la
+*          derecha, no se corren los puntos: el lugar de la izquierda (el más
+*          viejo) se borra y pasa a ser el de la derecha, y sólo se reescriben
+*          los códigos de los caracteres en pantalla.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_spark.h>
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t LCD_spark_column(const LCDspark * Grafico, int16_t Valor);
+static uint8_t LCD_spark_row(const LCDspark * Grafico, uint8_t Lugar, uint8_t Fila);
+static void LCD_spark_send(LCDspark * Grafico, uint8_t Lugar, uint8_t Filas);
+static void LCD_spark_place(LCDspark * Grafico);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Prepara un gráfico vacío y lo dibuja
+* @param  Gráfico, columna y fila del primer caracter, primer lugar de CGRAM,
+*         ancho en caracteres, valores de abajo y de arriba, y barras o puntos
+* @retval None
+* @note   El ancho se recorta a los lugares de CGRAM que quedan desde el
+*         primero. Las muestras nuevas entran por la derecha.
+*/
+void LCD_sparkInit(LCDspark * Grafico, uint8_t col, uint8_t row, uint8_t Primero, uint8_t Ancho, int16_t Minimo, int16_t Maximo, bool Barras) {
+	memset(Grafico, 0, sizeof(LCDspark));
+	Grafico->col = col;
+	Grafico->row = row;
+	Grafico->first = Primero & 0x07;
+	Grafico->width = Ancho;
+	if (Grafico->width > LCD_SPARK_MAX_WIDTH - Grafico->first) Grafico->width = LCD_SPARK_MAX_WIDTH - Grafico->first;
+	if (Grafico->width == 0) Grafico->width = 1;
+	Grafico->min = Minimo;
+	Grafico->max = Maximo;
+	Grafico->bars = Barras;
+	LCD_sparkDraw(Grafico);
+}
+
+/*******************************************************************************
+* @brief  Agrega una muestra a la derecha del gráfico
+* @param  Gráfico y valor (se recorta entre min y max)
+* @retval None
+* @note   Envía sólo las filas de CGRAM que cambian (con puntos, una por
+*         muestra), sin repetir la dirección en filas seguidas. Cada
+*         LCD_SPARK_GLYPH_COLS muestras, además, borra el caracter más viejo y
+*         reescribe los width códigos en pantalla. Deja el AC donde quedó: lo
+*         siguiente a escribir en pantalla debe ubicar el cursor.
+*/
+void LCD_sparkAdd(LCDspark * Grafico, int16_t Valor) {
+	uint8_t Filas = 0;
+	bool Rota = false;
+
+	// Caracter de la derecha lleno: el más viejo pasa a la derecha, vacío
+	if (Grafico->fill == LCD_SPARK_GLYPH_COLS) {
+		Grafico->oldest = (uint8_t) ((Grafico->oldest + 1) % Grafico->width);
+		Grafico->fill = 0;
+		Rota = true;
+	}
+	uint8_t Lugar = (uint8_t) ((Grafico->oldest + Grafico->width - 1) % Grafico->width);
+	uint8_t * Columnas = &Grafico->pixels[Lugar * LCD_SPARK_GLYPH_COLS];
+
+	if (Rota) {
+		for (uint8_t x=0; x<LCD_SPARK_GLYPH_COLS; x++) {
+			Filas |= Columnas[x];
+			Columnas[x] = 0;
+		}
+	}
+
+	// Sólo cambian las filas donde la columna nueva difiere de la anterior
+	uint8_t Nueva = LCD_spark_column(Grafico, Valor);
+	Filas |= Columnas[Grafico->fill] ^ Nueva;
+	Columnas[Grafico->fill++] = Nueva;
+	Grafico->samples++;
+
+	LCD_spark_send(Grafico, Lugar, Filas);
+	if (Rota) LCD_spark_place(Grafico);
+}
+
+/*******************************************************************************
+* @brief  Dibuja el gráfico completo
+* @param  Gráfico
+* @retval None
+* @note   Sólo envía lo que difiere de las sombras de CGRAM y DDRAM: sirve
+*         luego de que otro módulo usara esos lugares de CGRAM o esas celdas.
+*/
+void LCD_sparkDraw(LCDspark * Grafico) {
+	for (uint8_t Lugar=0; Lugar<Grafico->width; Lugar++) {
+		uint8_t Filas = 0;
+		for (uint8_t Fila=0; Fila<LCD_SPARK_GLYPH_ROWS; Fila++) {
+			uint8_t Direccion = (uint8_t) (((Grafico->first + Lugar) << 3) | Fila);
+			if (!LCD_cgramKnown(Direccion) || (LCD_cgramShadow(Direccion) & 0x1F) != LCD_spark_row(Grafico, Lugar, Fila)) {
+				Filas |= (uint8_t) (1U << Fila);
+			}
+		}
+		LCD_spark_send(Grafico, Lugar, Filas);
+	}
+	LCD_spark_place(Grafico);
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Columna de puntos de un valor
+* @param  Gráfico y valor
+* @retval Puntos (bit 0 arriba, bit 7 abajo)
+*/
+static uint8_t LCD_spark_column(const LCDspark * Grafico, int16_t Valor) {
+	int32_t Rango = (int32_t) Grafico->max - Grafico->min;
+	int32_t Nivel = 0;		// 0 abajo, LCD_SPARK_GLYPH_ROWS - 1 arriba
+
+	if (Rango > 0) {
+		if (Valor < Grafico->min) Valor = Grafico->min;
+		if (Valor > Grafico->max) Valor = Grafico->max;
+		Nivel = (((int32_t) Valor - Grafico->min) * (LCD_SPARK_GLYPH_ROWS - 1) + Rango / 2) / Rango;
+	}
+
+	uint8_t Punto = (uint8_t) (LCD_SPARK_GLYPH_ROWS - 1 - Nivel);
+	if (Grafico->bars) return (uint8_t) (0xFFU << Punto);
+	return (uint8_t) (1U << Punto);
+}
+
+/*******************************************************************************
+* @brief  Fila de un caracter del gráfico, armada desde sus columnas
+* @param  Gráfico, lugar (desde first) y fila
+* @retval Puntos de la fila (bit 4 a la izquierda)
+*/
+static uint8_t LCD_spark_row(const LCDspark * Grafico, uint8_t Lugar, uint8_t Fila) {
+	const uint8_t * Columnas = &Grafico->pixels[Lugar * LCD_SPARK_GLYPH_COLS];
+	uint8_t Puntos = 0;
+	for (uint8_t x=0; x<LCD_SPARK_GLYPH_COLS; x++) {
+		Puntos = (uint8_t) ((Puntos << 1) | ((Columnas[x] >> Fila) & 0x01));
+	}
+	return Puntos;
+}
+
+/*******************************************************************************
+* @brief  Envía filas de un caracter del gráfico
+* @param  Gráfico, lugar (desde first) y filas a enviar (un bit por fila)
+* @retval None
+*/
+static void LCD_spark_send(LCDspark * Grafico, uint8_t Lugar, uint8_t Filas) {
+	for (uint8_t Fila=0; Filas != 0; Fila++, Filas >>= 1) {
+		if ((Filas & 0x01) == 0) continue;
+		LCD_glyphRow((uint8_t) (((Grafico->first + Lugar) << 3) | Fila), LCD_spark_row(Grafico, Lugar, Fila));
+		Grafico->rows_sent++;
+	}
+}
+
+/*******************************************************************************
+* @brief  Escribe en pantalla los códigos de los caracteres, del más viejo al
+*         más nuevo
+* @param  Gráfico
+* @retval None
+*/
+static void LCD_spark_place(LCDspark * Grafico) {
+	for (uint8_t i=0; i<Grafico->width; i++) {
+		uint8_t Codigo = (uint8_t) (Grafico->first + (Grafico->oldest + i) % Grafico->width);
+		uint8_t col = (uint8_t) (Grafico->col + i);
+		if (LCD_cellShadow(col, Grafico->row) == Codigo) continue;
+
+		if (!LCD_cursorAt(col, Grafico->row)) LCD_setCursor(col, Grafico->row);
+		LCD_write(Codigo);
+		Grafico->cells_sent++;
+	}
+}
+
+/***************************************************************END OF FILE****/
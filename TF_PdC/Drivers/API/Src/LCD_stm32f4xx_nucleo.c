@@ -1,236 +1,678 @@
-/*******************************************************************************
-* @file    LCD_stm32f4xx_nucleo.c
-* @author  Guillermo Caporaletti
-* @brief   Manejo de puertos y pines GPIO para NUCLEO-F429ZI
-* 		   para controlador de LCD alimentado por Hitachi HD44780 (o compatible)
-********************************************************************************
-*/
-
-/* Includes ------------------------------------------------------------------*/
-
-#include <LCD_driver.h>
-
-/* Private typedef -----------------------------------------------------------*/
-
-/* Private macros ------------------------------------------------------------*/
-
-// Puertos de los pines
-#define D0_port		ARDUINO_D0_port
-#define D1_port		ARDUINO_D1_port
-#define D2_port		ARDUINO_D2_port
-#define D3_port		ARDUINO_D3_port
-#define D4_port		ARDUINO_D4_port
-#define D5_port		ARDUINO_D5_port
-#define D6_port		ARDUINO_D6_port
-#define D7_port		ARDUINO_D7_port
-#define ENABLE_port	ARDUINO_D8_port
-#define RW_port		ARDUINO_D9_port
-#define RS_port		ARDUINO_D10_port
-
-// Pines dentro de cada puerto
-#define D0_pin		ARDUINO_D0_pin
-#define D1_pin		ARDUINO_D1_pin
-#define D2_pin		ARDUINO_D2_pin
-#define D3_pin		ARDUINO_D3_pin
-#define D4_pin		ARDUINO_D4_pin
-#define D5_pin		ARDUINO_D5_pin
-#define D6_pin		ARDUINO_D6_pin
-#define D7_pin		ARDUINO_D7_pin
-#define ENABLE_pin	ARDUINO_D8_pin
-#define RW_pin		ARDUINO_D9_pin
-#define RS_pin		ARDUINO_D10_pin
-
-// Características del LCD
-#define LCD_FOURBITMODE	false
-#define LCD_COLUMNS		16
-#define LCD_LINES		2
-#define LCD_DOT_SIZE	LCD_5x8DOTS
-
-/*******************************************************************************
-  * @brief  Inicializa la estructura LCDconfig para lograr la conexión al LCD
-  * 		y los pines de salida a nivel hardware.
-  * @param  puntero a la estructura de LCD a configurar
-  * @retval None
-  */
-void LCD_init_stm32f4xx(LCDconfig * LCD_a_configurar)
-{
-	// Asigno pines y puertos a la estructura del LCD
-	LCD_a_configurar->rs_pin = RS_pin;
-	LCD_a_configurar->rs_port = RS_port;
-
-	LCD_a_configurar->rw_pin = RW_pin;
-	LCD_a_configurar->rw_port = RW_port;
-
-	LCD_a_configurar->enable_pin = ENABLE_pin;
-	LCD_a_configurar->enable_port = ENABLE_port;
-
-	LCD_a_configurar->data_pins[0] = D0_pin;
-	LCD_a_configurar->data_pins[1] = D1_pin;
-	LCD_a_configurar->data_pins[2] = D2_pin;
-	LCD_a_configurar->data_pins[3] = D3_pin;
-	LCD_a_configurar->data_pins[4] = D4_pin;
-	LCD_a_configurar->data_pins[5] = D5_pin;
-	LCD_a_configurar->data_pins[6] = D6_pin;
-	LCD_a_configurar->data_pins[7] = D7_pin;
-
-	LCD_a_configurar->data_ports[0] = D0_port;
-	LCD_a_configurar->data_ports[1] = D1_port;
-	LCD_a_configurar->data_ports[2] = D2_port;
-	LCD_a_configurar->data_ports[3] = D3_port;
-	LCD_a_configurar->data_ports[4] = D4_port;
-	LCD_a_configurar->data_ports[5] = D5_port;
-	LCD_a_configurar->data_ports[6] = D6_port;
-	LCD_a_configurar->data_ports[7] = D7_port;
-
-	// Configuro modo de conexión (4 pines o 8 pines)
-	LCD_a_configurar->fourbitmode = LCD_FOURBITMODE;
-	if (LCD_FOURBITMODE == true) {
-		LCD_a_configurar->displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
-	} else {
-		LCD_a_configurar->displayfunction = LCD_8BITMODE | LCD_1LINE | LCD_5x8DOTS;
-	}
-
-	// Configuro número de líneas
-	LCD_a_configurar->numlines = LCD_LINES;
-	if (LCD_a_configurar->numlines > 1) {
-		LCD_a_configurar->displayfunction |= LCD_2LINE;
-	}
-
-	// Para algunos displays de 1 línea, se puede configurar
-	// altura de caracter de 10 pixeles
-	if ((LCD_DOT_SIZE != LCD_5x8DOTS) && (LCD_LINES == 1)) {
-	    LCD_a_configurar->displayfunction |= LCD_5x10DOTS;
-	}
-
-	// Offsets de filas (generalización para LCD de 4 filas)
-	LCD_a_configurar->row_offsets[0] = 0x00;
-	LCD_a_configurar->row_offsets[1] = 0x40;
-	LCD_a_configurar->row_offsets[2] = 0x00+LCD_COLUMNS;
-	LCD_a_configurar->row_offsets[3] = 0x40+LCD_COLUMNS;
-
-	// Dejo asentado que almacené valores iniciales en la estructura
-	LCD_a_configurar->initialized = true;
-
-	// Ahora opero sobre el hardware: activo los puertos
-	__HAL_RCC_GPIOD_CLK_ENABLE();
-	__HAL_RCC_GPIOE_CLK_ENABLE();
-	__HAL_RCC_GPIOF_CLK_ENABLE();
-	__HAL_RCC_GPIOG_CLK_ENABLE();
-
-	// Inicializamos los pines de salida RS, RW y ENABLE
-	pinMode(LCD_a_configurar->rs_port, LCD_a_configurar->rs_pin, LCD_WRITE);
-	if (LCD_a_configurar->rw_port != NULL) {
-		// Podemos ahorrar un pin no usando RW y conectándolo a GND.
-		// Si hacemos esto, lo indicamos como NULL en el puerto.
-	    pinMode(LCD_a_configurar->rw_port, LCD_a_configurar->rw_pin, LCD_WRITE);
-	}
-	pinMode(LCD_a_configurar->enable_port, LCD_a_configurar->enable_pin, LCD_WRITE);
-
-    // Configuramos a los pines de datos en modo escritura
-	LCD_write_mode(LCD_a_configurar);
-
-}
-
-/*******************************************************************************
-  * @brief  Configura los pines de datos en modo escritura.
-  * @param	Estructura del LCD.
-  * @retval None
-  * @note
-  */
-void LCD_write_mode(LCDconfig * LCD_a_escribir)
-{
-	// Seteamos los 8 o 4 bits de datos en modo escritura
-	for (int8_t i=0; i<((LCD_a_escribir->displayfunction & LCD_8BITMODE) ? 8 : 4); ++i)
-	{
-		pinMode(LCD_a_escribir->data_ports[i], LCD_a_escribir->data_pins[i], LCD_WRITE);
-	}
-	LCD_a_escribir->rw_config = WRITE_MODE;
-}
-
-/*******************************************************************************
-  * @brief  Configura los pines de datos en modo lectura.
-  * @param	Estructura del LCD.
-  * @retval None
-  * @note
-  */
-void LCD_read_mode(LCDconfig * LCD_a_leer)
-{
-	// Seteamos los 8 o 4 bits de datos en modo lectura
-	for (int8_t i=0; i<((LCD_a_leer->displayfunction & LCD_8BITMODE) ? 8 : 4); ++i)
-	{
-		pinMode(LCD_a_leer->data_ports[i], LCD_a_leer->data_pins[i], LCD_READ);
-	}
-	LCD_a_leer->rw_config = READ_MODE;
-}
-
-/*******************************************************************************
-  * @brief  Configura el modo de un pin de salida individual.
-  * @param	Puerto, Pin del puerto y Modo.
-  * @retval None
-  * @note	Debe habilitarse el puerto correspondiente.
-  */
-void pinMode(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint32_t Pin_Mode)
-{
-	GPIO_InitTypeDef  GPIO_InitStruct;
-
-	GPIO_InitStruct.Pin = GPIO_Pin;
-	GPIO_InitStruct.Mode = Pin_Mode;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;			// <- Configuración predeterminada
-	GPIO_InitStruct.Speed = GPIO_SPEED_FAST;	// <- Configuración predeterminada
-
-	HAL_GPIO_Init(GPIOx, &GPIO_InitStruct);
-
-	// ¡ATENCION!
-	// En algún otro lugar, se debe activar el CLK del puerto ejecutando:
-	// __HAL_RCC_GPIOA_CLK_ENABLE();
-}
-
-/*******************************************************************************
-  * @brief  Escribe en un pin o pines de un puerto.
-  * @param  Puerto, Pin del puerto y Estado de salida.
-  * @retval None
-  */
-void digitalWrite(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
-{
-	HAL_GPIO_WritePin(GPIOx, GPIO_Pin, PinState);
-}
-
-/*******************************************************************************
-  * @brief  Lee un pin o pines de un puerto.
-  * @param  Puerto, Pin del puerto y Estado de salida.
-  * @retval None
-  */
-GPIO_PinState digitalRead(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
-{
-	GPIO_PinState Lectura;
-	Lectura = HAL_GPIO_ReadPin(GPIOx, GPIO_Pin);
-	return Lectura;
-}
-
-/*******************************************************************************
-  * @brief  Un retardo en milisegundos
-  * @param  retardo
-  * @retval None
-  */
-void delayMilliseconds(uint32_t delay)
-{
-	  HAL_Delay(delay);
-}
-
-/*******************************************************************************
-  * @brief  Un micro retardo
-  * @param  Sticks...
-  * @retval None
-  */
-void delayMicro(uint8_t Sticks) {
-	if (Sticks==0) Sticks=1;
-	for (uint8_t i=0; i<Sticks; i++) {
-		for (uint16_t j=0; j<LOW_COUNT; j++) {
-			// Keep on walking!
-		}
-	}
-}
-
-
-
-/***************************************************************END OF FILE****/
+/*******************************************************************************
+* @file    LCD_stm32f4xx_nucleo.c
+* @author  Guillermo Caporaletti
+* @brief   Manejo de puertos y pines GPIO para NUCLEO-F429ZI
+* 		   para controlador de LCD alimentado por Hitachi HD44780 (o compatible)
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+#ifdef LCD_TRACE
+#include <LCD_trace.h>
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private macros ------------------------------------------------------------*/
+
+// Puertos de los pines
+#define D0_port		ARDUINO_D0_port
+#define D1_port		ARDUINO_D1_port
+#define D2_port		ARDUINO_D2_port
+#define D3_port		ARDUINO_D3_port
+#define D4_port		ARDUINO_D4_port
+#define D5_port		ARDUINO_D5_port
+#define D6_port		ARDUINO_D6_port
+#define D7_port		ARDUINO_D7_port
+#define ENABLE_port	ARDUINO_D8_port
+#define RW_port		ARDUINO_D9_port
+#define RS_port		ARDUINO_D10_port
+#define ENABLE1_port	ARDUINO_D11_port	// ENABLE de otros displays en el mismo bus
+#define ENABLE2_port	ARDUINO_D12_port
+#define ENABLE3_port	ARDUINO_D13_port
+
+// Pines dentro de cada puerto
+#define D0_pin		ARDUINO_D0_pin
+#define D1_pin		ARDUINO_D1_pin
+#define D2_pin		ARDUINO_D2_pin
+#define D3_pin		ARDUINO_D3_pin
+#define D4_pin		ARDUINO_D4_pin
+#define D5_pin		ARDUINO_D5_pin
+#define D6_pin		ARDUINO_D6_pin
+#define D7_pin		ARDUINO_D7_pin
+#define ENABLE_pin	ARDUINO_D8_pin
+#define RW_pin		ARDUINO_D9_pin
+#define RS_pin		ARDUINO_D10_pin
+#define ENABLE1_pin	ARDUINO_D11_pin
+#define ENABLE2_pin	ARDUINO_D12_pin
+#define ENABLE3_pin	ARDUINO_D13_pin
+
+// Características del LCD (pueden venir de la línea de compilación, como
+// en las pruebas en la PC de "Test")
+#ifndef LCD_FOURBITMODE
+#define LCD_FOURBITMODE	false
+#endif
+#ifndef LCD_COLUMNS
+#define LCD_COLUMNS		16
+#endif
+#ifndef LCD_LINES
+#define LCD_LINES		2
+#endif
+#define LCD_DOT_SIZE	LCD_5x8DOTS
+#ifndef LCD_TIMING
+#define LCD_TIMING		LCD_timing_HD44780	// Perfil de tiempos del controlador
+#endif
+#ifndef LCD_DISPLAYS
+#define LCD_DISPLAYS	1		// Displays en el mismo bus (hasta LCD_MAX_DISPLAYS)
+#endif
+#ifndef LCD_DUAL_CONTROLLER
+#define LCD_DUAL_CONTROLLER	false	// 40x4: filas 0-1 en ENABLE (E1), filas 2-3 en ENABLE1 (E2)
+#endif
+
+// Interrupción del busy flag (ver LCD_busyEvent): DB7 es D7 (PF13) con 8
+// pines y D3 (PE13) con 4; los dos están en la línea EXTI13. El grupo de
+// líneas 10 a 15 lo comparte el botón B1 (PC13, misma línea: no usar los dos)
+#define LCD_BUSY_IRQn			EXTI15_10_IRQn
+#define LCD_BUSY_IRQHandler		EXTI15_10_IRQHandler
+#define LCD_BUSY_IRQ_PRIORITY	5
+
+// Bus FMC (compilando con LCD_FMC, ver LCD_fmcInit): datos en FMC_D0 a D7
+// (PD14, PD15, PD0, PD1, PE7, PE8, PE9 y PE10), RS en FMC_A0 (PF0), RW en
+// FMC_A1 (PF1), y E = NE1 bajo y (NOE o NWE bajo), con compuertas (PD7, PD4
+// y PD5). Todos esos pines toleran 5V. Reemplaza a los pines de arriba.
+#define LCD_FMC_GPIOD_PINS	(GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_7 | GPIO_PIN_14 | GPIO_PIN_15)
+#define LCD_FMC_GPIOE_PINS	(GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10)
+#define LCD_FMC_GPIOF_PINS	(GPIO_PIN_0 | GPIO_PIN_1)
+
+#if (LCD_DISPLAYS < 1) || (LCD_DISPLAYS > LCD_MAX_DISPLAYS)
+#error "LCD_DISPLAYS debe estar entre 1 y LCD_MAX_DISPLAYS"
+#endif
+#if LCD_DUAL_CONTROLLER && ((LCD_DISPLAYS != 2) || (LCD_LINES != 4))
+#error "Un display de dos controladores usa LCD_DISPLAYS 2 y LCD_LINES 4"
+#endif
+#if defined(LCD_FMC) && (LCD_FOURBITMODE || (LCD_DISPLAYS != 1) || defined(LCD_TRACE))
+#error "El bus FMC es de 8 bits y para un solo display (y LCD_TRACE no ve sus accesos)"
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t LCD_fmc_cycles(uint32_t ns, uint32_t Minimo, uint32_t Maximo);
+
+/*******************************************************************************
+  * @brief  Inicializa la estructura LCDconfig para lograr la conexión al LCD
+  * 		y los pines de salida a nivel hardware.
+  * @param  puntero a la estructura de LCD a configurar
+  * @retval None
+  */
+void LCD_init_stm32f4xx(LCDconfig * LCD_a_configurar)
+{
+	// Asigno pines y puertos a la estructura del LCD
+	LCD_a_configurar->rs_pin = RS_pin;
+	LCD_a_configurar->rs_port = RS_port;
+
+	LCD_a_configurar->rw_pin = RW_pin;
+	LCD_a_configurar->rw_port = RW_port;
+
+	LCD_a_configurar->enable_pin = ENABLE_pin;
+	LCD_a_configurar->enable_port = ENABLE_port;
+
+	// Displays que comparten el bus: el 0 usa ENABLE, los demás ENABLE1 a 3
+	LCD_a_configurar->displays = LCD_DISPLAYS;
+	LCD_a_configurar->enable_pins[0] = ENABLE_pin;
+	LCD_a_configurar->enable_pins[1] = ENABLE1_pin;
+	LCD_a_configurar->enable_pins[2] = ENABLE2_pin;
+	LCD_a_configurar->enable_pins[3] = ENABLE3_pin;
+
+	LCD_a_configurar->enable_ports[0] = ENABLE_port;
+	LCD_a_configurar->enable_ports[1] = ENABLE1_port;
+	LCD_a_configurar->enable_ports[2] = ENABLE2_port;
+	LCD_a_configurar->enable_ports[3] = ENABLE3_port;
+
+	LCD_a_configurar->data_pins[0] = D0_pin;
+	LCD_a_configurar->data_pins[1] = D1_pin;
+	LCD_a_configurar->data_pins[2] = D2_pin;
+	LCD_a_configurar->data_pins[3] = D3_pin;
+	LCD_a_configurar->data_pins[4] = D4_pin;
+	LCD_a_configurar->data_pins[5] = D5_pin;
+	LCD_a_configurar->data_pins[6] = D6_pin;
+	LCD_a_configurar->data_pins[7] = D7_pin;
+
+	LCD_a_configurar->data_ports[0] = D0_port;
+	LCD_a_configurar->data_ports[1] = D1_port;
+	LCD_a_configurar->data_ports[2] = D2_port;
+	LCD_a_configurar->data_ports[3] = D3_port;
+	LCD_a_configurar->data_ports[4] = D4_port;
+	LCD_a_configurar->data_ports[5] = D5_port;
+	LCD_a_configurar->data_ports[6] = D6_port;
+	LCD_a_configurar->data_ports[7] = D7_port;
+
+	// Configuro modo de conexión (4 pines o 8 pines)
+	LCD_a_configurar->fourbitmode = LCD_FOURBITMODE;
+	if (LCD_FOURBITMODE == true) {
+		LCD_a_configurar->displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
+	} else {
+		LCD_a_configurar->displayfunction = LCD_8BITMODE | LCD_1LINE | LCD_5x8DOTS;
+	}
+
+	// Configuro número de líneas y columnas
+	LCD_a_configurar->numlines = LCD_LINES;
+	LCD_a_configurar->numcols = LCD_COLUMNS;
+	if (LCD_a_configurar->numlines > 1) {
+		LCD_a_configurar->displayfunction |= LCD_2LINE;
+	}
+
+	// Para algunos displays de 1 línea, se puede configurar
+	// altura de caracter de 10 pixeles
+	if ((LCD_DOT_SIZE != LCD_5x8DOTS) && (LCD_LINES == 1)) {
+	    LCD_a_configurar->displayfunction |= LCD_5x10DOTS;
+	}
+
+	// Tiempos del controlador
+	LCD_a_configurar->timing = LCD_TIMING;
+
+	// Offsets de filas (generalización para LCD de 4 filas)
+	LCD_a_configurar->row_offsets[0] = 0x00;
+	LCD_a_configurar->row_offsets[1] = 0x40;
+	LCD_a_configurar->row_offsets[2] = 0x00+LCD_COLUMNS;
+	LCD_a_configurar->row_offsets[3] = 0x40+LCD_COLUMNS;
+	for (uint8_t f=0; f<4; f++) LCD_a_configurar->row_display[f] = 0;
+
+	// Con dos controladores, cada uno es un display de 2 filas
+	LCD_a_configurar->split = LCD_DUAL_CONTROLLER;
+	LCD_a_configurar->focus = 0;
+	if (LCD_DUAL_CONTROLLER) {
+		LCD_a_configurar->row_offsets[2] = 0x00;
+		LCD_a_configurar->row_offsets[3] = 0x40;
+		LCD_a_configurar->row_display[2] = 1;
+		LCD_a_configurar->row_display[3] = 1;
+	}
+
+	// Direcciones de bit-band de los pines sueltos
+	LCD_bitbandInit(LCD_a_configurar);
+
+	// Dejo asentado que almacené valores iniciales en la estructura
+	LCD_a_configurar->initialized = true;
+
+	// Contador de ciclos para medir tiempos
+	LCD_cycleCounterInit();
+
+	// Ahora opero sobre el hardware: activo los puertos
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_GPIOD_CLK_ENABLE();
+	__HAL_RCC_GPIOE_CLK_ENABLE();
+	__HAL_RCC_GPIOF_CLK_ENABLE();
+	__HAL_RCC_GPIOG_CLK_ENABLE();
+
+#ifdef LCD_FMC
+	// Bus FMC: los pines son del FMC, y RS y RW, líneas de dirección
+	LCD_a_configurar->fmc = (volatile uint8_t *) LCD_FMC_BASE;
+	LCD_fmcInit(LCD_a_configurar);
+#else
+	LCD_a_configurar->fmc = NULL;
+
+	// Inicializamos los pines de salida RS, RW y ENABLE
+	pinMode(LCD_a_configurar->rs_port, LCD_a_configurar->rs_pin, LCD_WRITE);
+	if (LCD_a_configurar->rw_port != NULL) {
+		// Podemos ahorrar un pin no usando RW y conectándolo a GND.
+		// Si hacemos esto, lo indicamos como NULL en el puerto.
+	    pinMode(LCD_a_configurar->rw_port, LCD_a_configurar->rw_pin, LCD_WRITE);
+	    LCD_busyIrqInit(LCD_a_configurar);
+	}
+	for (uint8_t d=0; d<LCD_a_configurar->displays; d++) {
+		pinMode(LCD_a_configurar->enable_ports[d], LCD_a_configurar->enable_pins[d], LCD_WRITE);
+	}
+
+    // Configuramos a los pines de datos en modo escritura
+	LCD_write_mode(LCD_a_configurar);
+#endif
+
+}
+
+/*******************************************************************************
+  * @brief  Configura el FMC para ver al display como una SRAM de 8 bits.
+  * @param  Estructura del LCD.
+  * @retval None
+  * @note   Banco 1 (NE1), asincrónico, modo A. Los tiempos los fija
+  *         LCD_fmcTiming(), que LCD_setTiming() llama con cada perfil. Los
+  *         pines quedan push-pull a 3,3V: alcanza para el 1 del HD44780 a 5V
+  *         (VIH de 2,2V), y no hace falta la resistencia de ENABLE.
+  */
+void LCD_fmcInit(LCDconfig * LCD_a_configurar)
+{
+	GPIO_InitTypeDef GPIO_InitStruct;
+	FMC_NORSRAM_InitTypeDef Banco = {0};
+
+	(void) LCD_a_configurar;
+	__HAL_RCC_FMC_CLK_ENABLE();
+
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FAST;
+	GPIO_InitStruct.Alternate = GPIO_AF12_FMC;
+	GPIO_InitStruct.Pin = LCD_FMC_GPIOD_PINS;
+	HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
+	GPIO_InitStruct.Pin = LCD_FMC_GPIOE_PINS;
+	HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
+	GPIO_InitStruct.Pin = LCD_FMC_GPIOF_PINS;
+	HAL_GPIO_Init(GPIOF, &GPIO_InitStruct);
+
+	Banco.NSBank = FMC_NORSRAM_BANK1;
+	Banco.DataAddressMux = FMC_DATA_ADDRESS_MUX_DISABLE;
+	Banco.MemoryType = FMC_MEMORY_TYPE_SRAM;
+	Banco.MemoryDataWidth = FMC_NORSRAM_MEM_BUS_WIDTH_8;
+	Banco.BurstAccessMode = FMC_BURST_ACCESS_MODE_DISABLE;
+	Banco.WaitSignalPolarity = FMC_WAIT_SIGNAL_POLARITY_LOW;
+	Banco.WrapMode = FMC_WRAP_MODE_DISABLE;
+	Banco.WaitSignalActive = FMC_WAIT_TIMING_BEFORE_WS;
+	Banco.WriteOperation = FMC_WRITE_OPERATION_ENABLE;
+	Banco.WaitSignal = FMC_WAIT_SIGNAL_DISABLE;
+	Banco.ExtendedMode = FMC_EXTENDED_MODE_DISABLE;
+	Banco.AsynchronousWait = FMC_ASYNCHRONOUS_WAIT_DISABLE;
+	Banco.WriteBurst = FMC_WRITE_BURST_DISABLE;
+	Banco.ContinuousClock = FMC_CONTINUOUS_CLOCK_SYNC_ONLY;
+	FMC_NORSRAM_Init(FMC_NORSRAM_DEVICE, &Banco);
+	__FMC_NORSRAM_ENABLE(FMC_NORSRAM_DEVICE, FMC_NORSRAM_BANK1);
+}
+
+/*******************************************************************************
+  * @brief  Pasa un perfil de tiempos a los registros del FMC.
+  * @param  Perfil.
+  * @retval None
+  * @note   ADDSET da tAS, DATAST el pulso de E (PWEH, y tDDR al leer: el FMC
+  *         toma los datos al final) y BUSTURN separa el acceso siguiente
+  *         (tH). Un tiempo que no entra en su campo queda en el máximo (a
+  *         180 MHz, 83 ns para tAS y tH y 1416 ns para el pulso, varias veces
+  *         lo de cualquier perfil): lo que falte entre un acceso y el
+  *         siguiente lo completa el período tcycE, que cuida el driver (ver
+  *         LCD_fmc_period).
+  */
+void LCD_fmcTiming(const LCDtiming * Perfil)
+{
+	FMC_NORSRAM_TimingTypeDef Tiempos = {0};
+	uint32_t Pulso = (Perfil->pweh_ns > Perfil->ddr_ns) ? Perfil->pweh_ns : Perfil->ddr_ns;
+
+	Tiempos.AddressSetupTime = LCD_fmc_cycles(Perfil->as_ns, 0, LCD_FMC_ADDSET_MAX);
+	Tiempos.AddressHoldTime = 1;		// <-- No se usa en modo A
+	Tiempos.DataSetupTime = LCD_fmc_cycles(Pulso, 1, LCD_FMC_DATAST_MAX);
+	Tiempos.BusTurnAroundDuration = LCD_fmc_cycles(Perfil->h_ns, 0, LCD_FMC_BUSTURN_MAX);
+	Tiempos.CLKDivision = 2;
+	Tiempos.DataLatency = 2;
+	Tiempos.AccessMode = FMC_ACCESS_MODE_A;
+	FMC_NORSRAM_Timing_Init(FMC_NORSRAM_DEVICE, &Tiempos, FMC_NORSRAM_BANK1);
+}
+
+/*******************************************************************************
+  * @brief  Escribe un byte en el display por el FMC.
+  * @param  Banco, dirección (LCD_FMC_RS para datos) y valor.
+  * @retval None
+  * @note   Un único acceso: el FMC arma RS, E y los datos. La región del
+  *         banco es memoria "normal": __DSB() hace que la escritura salga
+  *         antes de empezar a contar la ejecución. En la PC, el modelo del
+  *         display la reemplaza (ver "Test/Src/LCD_sim.c").
+  */
+__weak void fmcWrite(volatile uint8_t * Banco, uint8_t Direccion, uint8_t Valor)
+{
+	Banco[Direccion] = Valor;
+	__DSB();
+}
+
+/*******************************************************************************
+  * @brief  Lee un byte del display por el FMC.
+  * @param  Banco y dirección (LCD_FMC_RW, y LCD_FMC_RS para datos).
+  * @retval Byte leído
+  * @note   En la PC, el modelo del display la reemplaza.
+  */
+__weak uint8_t fmcRead(volatile uint8_t * Banco, uint8_t Direccion)
+{
+	return Banco[Direccion];
+}
+
+/*******************************************************************************
+  * @brief  Pasa un tiempo a ciclos de HCLK para un campo del FMC.
+  * @param  Nanosegundos, y mínimo y máximo del campo.
+  * @retval Ciclos, recortados al rango del campo
+  */
+static uint32_t LCD_fmc_cycles(uint32_t ns, uint32_t Minimo, uint32_t Maximo)
+{
+	uint32_t Ciclos = LCD_NS_TO_CYCLES(ns);		// <-- El FMC usa HCLK (el reloj del núcleo)
+	if (Ciclos > Maximo) return Maximo;
+	return (Ciclos < Minimo) ? Minimo : Ciclos;
+}
+
+/*******************************************************************************
+  * @brief  Configura los pines de datos en modo escritura.
+  * @param	Estructura del LCD.
+  * @retval None
+  * @note
+  */
+void LCD_write_mode(LCDconfig * LCD_a_escribir)
+{
+	// Seteamos los 8 o 4 bits de datos en modo escritura
+	for (int8_t i=0; i<((LCD_a_escribir->displayfunction & LCD_8BITMODE) ? 8 : 4); ++i)
+	{
+		pinMode(LCD_a_escribir->data_ports[i], LCD_a_escribir->data_pins[i], LCD_WRITE);
+	}
+	LCD_a_escribir->rw_config = WRITE_MODE;
+}
+
+/*******************************************************************************
+  * @brief  Configura los pines de datos en modo lectura.
+  * @param	Estructura del LCD.
+  * @retval None
+  * @note
+  */
+void LCD_read_mode(LCDconfig * LCD_a_leer)
+{
+	// Seteamos los 8 o 4 bits de datos en modo lectura
+	for (int8_t i=0; i<((LCD_a_leer->displayfunction & LCD_8BITMODE) ? 8 : 4); ++i)
+	{
+		pinMode(LCD_a_leer->data_ports[i], LCD_a_leer->data_pins[i], LCD_READ);
+	}
+	LCD_a_leer->rw_config = READ_MODE;
+}
+
+/*******************************************************************************
+  * @brief  Configura el modo de un pin de salida individual.
+  * @param	Puerto, Pin del puerto y Modo.
+  * @retval None
+  * @note	Debe habilitarse el puerto correspondiente.
+  */
+void pinMode(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint32_t Pin_Mode)
+{
+	GPIO_InitTypeDef  GPIO_InitStruct;
+
+	GPIO_InitStruct.Pin = GPIO_Pin;
+	GPIO_InitStruct.Mode = Pin_Mode;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;			// <- Configuración predeterminada
+	GPIO_InitStruct.Speed = GPIO_SPEED_FAST;	// <- Configuración predeterminada
+
+	HAL_GPIO_Init(GPIOx, &GPIO_InitStruct);
+#ifdef LCD_TRACE
+	LCD_traceRecord(LCD_TRACE_MODE, GPIOx, GPIO_Pin, Pin_Mode == LCD_READ);
+#endif
+
+	// ¡ATENCION!
+	// En algún otro lugar, se debe activar el CLK del puerto ejecutando:
+	// __HAL_RCC_GPIOA_CLK_ENABLE();
+}
+
+/*******************************************************************************
+  * @brief  Escribe en un pin o pines de un puerto.
+  * @param  Puerto, Pin del puerto y Estado de salida.
+  * @retval None
+  */
+void digitalWrite(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	HAL_GPIO_WritePin(GPIOx, GPIO_Pin, PinState);
+#ifdef LCD_TRACE
+	LCD_traceRecord(LCD_TRACE_WRITE, GPIOx, GPIO_Pin, PinState);
+#endif
+}
+
+/*******************************************************************************
+  * @brief  Lee un pin o pines de un puerto.
+  * @param  Puerto, Pin del puerto y Estado de salida.
+  * @retval None
+  */
+GPIO_PinState digitalRead(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+	GPIO_PinState Lectura;
+	Lectura = HAL_GPIO_ReadPin(GPIOx, GPIO_Pin);
+#ifdef LCD_TRACE
+	LCD_traceRecord(LCD_TRACE_READ, GPIOx, GPIO_Pin, Lectura);
+#endif
+	return Lectura;
+}
+
+/*******************************************************************************
+  * @brief  Calcula los alias de bit-band de ENABLE, RS, RW y del busy flag.
+  * @param  Estructura del LCD, con pines y modo ya asignados.
+  * @retval None
+  * @note   Se usan si se compila con LCD_BITBAND (ver strobeWrite).
+  */
+void LCD_bitbandInit(LCDconfig * LCD_a_configurar)
+{
+	LCD_a_configurar->rs_bb = LCD_BITBAND_ALIAS(LCD_a_configurar->rs_port->ODR, POSITION_VAL(LCD_a_configurar->rs_pin));
+	LCD_a_configurar->enable_bb = LCD_BITBAND_ALIAS(LCD_a_configurar->enable_port->ODR, POSITION_VAL(LCD_a_configurar->enable_pin));
+	LCD_a_configurar->rw_bb = NULL;
+	if (LCD_a_configurar->rw_port != DISCONNECTED_PIN) {
+		LCD_a_configurar->rw_bb = LCD_BITBAND_ALIAS(LCD_a_configurar->rw_port->ODR, POSITION_VAL(LCD_a_configurar->rw_pin));
+	}
+
+	// El busy flag sale por DB7: data_pins[7] con 8 pines, data_pins[3] con 4
+	uint8_t Busy = LCD_a_configurar->fourbitmode ? 3 : 7;
+	LCD_a_configurar->busy_bb = LCD_BITBAND_ALIAS(LCD_a_configurar->data_ports[Busy]->IDR, POSITION_VAL(LCD_a_configurar->data_pins[Busy]));
+}
+
+/*******************************************************************************
+  * @brief  Configura una sola vez la línea EXTI del pin de busy flag.
+  * @param	Estructura del LCD.
+  * @retval None
+  * @note	Asigna la línea al puerto de DB7 y elige el flanco descendente,
+  *         pero la deja enmascarada: la arma LCD_busyIrqArm(). Se llama en
+  *         la inicialización, antes de poner los pines de datos como salida
+  *         (HAL_GPIO_Init con otro modo no toca la EXTI).
+  */
+void LCD_busyIrqInit(LCDconfig * LCD_a_esperar)
+{
+	uint8_t Busy = LCD_a_esperar->fourbitmode ? 3 : 7;
+	uint16_t Pin = LCD_a_esperar->data_pins[Busy];
+
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+	pinMode(LCD_a_esperar->data_ports[Busy], Pin, GPIO_MODE_IT_FALLING);
+	EXTI->IMR &= ~((uint32_t) Pin);
+	__HAL_GPIO_EXTI_CLEAR_IT(Pin);
+	HAL_NVIC_SetPriority(LCD_BUSY_IRQn, LCD_BUSY_IRQ_PRIORITY, 0);
+}
+
+/*******************************************************************************
+  * @brief  Arma la interrupción del pin de busy flag por flanco descendente.
+  * @param	Estructura del LCD.
+  * @retval None
+  * @note	Sólo borra lo pendiente y desenmascara la línea (ver
+  *         LCD_busyIrqInit): el pin sigue como entrada.
+  */
+void LCD_busyIrqArm(LCDconfig * LCD_a_esperar)
+{
+	uint16_t Pin = LCD_a_esperar->data_pins[LCD_a_esperar->fourbitmode ? 3 : 7];
+
+	__HAL_GPIO_EXTI_CLEAR_IT(Pin);
+	EXTI->IMR |= (uint32_t) Pin;
+	HAL_NVIC_EnableIRQ(LCD_BUSY_IRQn);
+}
+
+/*******************************************************************************
+  * @brief  Desarma la interrupción del pin de busy flag.
+  * @param	Estructura del LCD.
+  * @retval None
+  * @note	Se llama desde la interrupción: sólo enmascara la línea, sin
+  *         HAL_GPIO_Init. El flanco elegido queda para el próximo armado.
+  */
+void LCD_busyIrqDisarm(LCDconfig * LCD_a_esperar)
+{
+	uint16_t Pin = LCD_a_esperar->data_pins[LCD_a_esperar->fourbitmode ? 3 : 7];
+
+	HAL_NVIC_DisableIRQ(LCD_BUSY_IRQn);
+	EXTI->IMR &= ~((uint32_t) Pin);
+	__HAL_GPIO_EXTI_CLEAR_IT(Pin);
+}
+
+/*******************************************************************************
+  * @brief  Interrupción de las líneas EXTI 10 a 15.
+  * @param	None
+  * @retval None
+  */
+void LCD_BUSY_IRQHandler(void)
+{
+	uint16_t Pin = LCD_FOURBITMODE ? D3_pin : D7_pin;
+
+	if (__HAL_GPIO_EXTI_GET_IT(Pin) != 0) {
+		__HAL_GPIO_EXTI_CLEAR_IT(Pin);
+		LCD_busyIrq();
+	}
+}
+
+/*******************************************************************************
+  * @brief  Mide cuántos ciclos cuesta escribir un pin por cada camino.
+  * @param  Dónde dejar el resultado.
+  * @retval None
+  * @note   Usa RS, que sin un pulso de ENABLE no le hace nada al LCD, y lo
+  *         deja en 0. El resultado incluye la vuelta del lazo. busy_flag
+  *         queda en 0 si RW no está conectado. Llamar luego de LCD_init().
+  */
+void LCD_strobeBenchmark(LCDstrobeBench * Resultado)
+{
+	GPIO_TypeDef * Puerto = RS_port;
+	uint16_t Pin = RS_pin;
+	volatile uint32_t * Alias = LCD_BITBAND_ALIAS(Puerto->ODR, POSITION_VAL(Pin));
+	uint32_t Inicio;
+
+	Inicio = LCD_cycles();
+	for (uint16_t i=0; i<LCD_BENCH_ROUNDS; i++) {
+		HAL_GPIO_WritePin(Puerto, Pin, GPIO_PIN_SET);
+		HAL_GPIO_WritePin(Puerto, Pin, GPIO_PIN_RESET);
+	}
+	Resultado->hal = (LCD_cycles() - Inicio) / (2 * LCD_BENCH_ROUNDS);
+
+	Inicio = LCD_cycles();
+	for (uint16_t i=0; i<LCD_BENCH_ROUNDS; i++) {
+		Puerto->BSRR = Pin;
+		Puerto->BSRR = (uint32_t) Pin << 16;
+	}
+	Resultado->bsrr = (LCD_cycles() - Inicio) / (2 * LCD_BENCH_ROUNDS);
+
+	Inicio = LCD_cycles();
+	for (uint16_t i=0; i<LCD_BENCH_ROUNDS; i++) {
+		*Alias = 1;
+		*Alias = 0;
+	}
+	Resultado->bitband = (LCD_cycles() - Inicio) / (2 * LCD_BENCH_ROUNDS);
+
+	Resultado->busy_flag = 0;
+	if (LCD_canRead()) {
+		Inicio = LCD_cycles();
+		for (uint16_t i=0; i<LCD_BENCH_ROUNDS; i++) {
+			LCD_busy_flag();
+		}
+		Resultado->busy_flag = (LCD_cycles() - Inicio) / LCD_BENCH_ROUNDS;
+	}
+}
+
+/*******************************************************************************
+  * @brief  Mide cuántos bytes por segundo lleva el bus compilado (GPIO o FMC).
+  * @param  Dónde dejar el resultado.
+  * @retval None
+  * @note   Reescribe la fila 0 con lo que ya tiene (la pantalla no cambia).
+  *         Cada LCD_write() se mide luego de que el display esté listo, así
+  *         que sólo cuenta la transferencia; el texto, con las esperas. Deja
+  *         el AC al final de la fila: lo siguiente debe ubicar el cursor.
+  *         Llamar luego de LCD_init(), con GPIO y con LCD_FMC, y comparar.
+  *         Lo que no se pudo medir queda en 0.
+  */
+void LCD_busBenchmark(LCDbusBench * Resultado)
+{
+	uint8_t Columnas = LCD_columns();
+	uint32_t Transferencia = 0;
+	uint32_t Inicio, Total;
+
+	LCD_setCursor(0, 0);
+	while (LCD_readyIn() != 0) {}
+	Total = LCD_cycles();
+	for (uint8_t c=0; c<Columnas; c++) {
+		while (LCD_readyIn() != 0) {}
+		Inicio = LCD_cycles();
+		LCD_write(LCD_shadow(LCD_address()));
+		Transferencia += LCD_cycles() - Inicio;
+	}
+	while (LCD_readyIn() != 0) {}
+	Total = LCD_cycles() - Total;
+
+	// Sin columnas, o con un contador que no avanzó, no hay qué dividir
+	Resultado->write_cycles = (Columnas != 0) ? Transferencia / Columnas : 0;
+	Resultado->bytes_per_s = (Resultado->write_cycles != 0) ? LCD_CORE_CLOCK_HZ / Resultado->write_cycles : 0;
+	Resultado->text_bytes_per_s = (Total != 0) ? (uint32_t) (((uint64_t) Columnas * LCD_CORE_CLOCK_HZ) / Total) : 0;
+}
+
+/*******************************************************************************
+  * @brief  Activa el contador de ciclos del núcleo (DWT->CYCCNT).
+  * @param  None
+  * @retval None
+  */
+void LCD_cycleCounterInit(void)
+{
+	// Los retardos suponen el reloj de LCD_CORE_CLOCK_HZ
+	if (SystemCoreClock != LCD_CORE_CLOCK_HZ) Error_Handler();
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*******************************************************************************
+  * @brief  Lee el contador de ciclos del núcleo.
+  * @param  None
+  * @retval Ciclos (da la vuelta cada 2^32 ciclos, unos 23 s a 180 MHz)
+  */
+uint32_t LCD_cycles(void)
+{
+	return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+  * @brief  Un retardo en milisegundos
+  * @param  retardo
+  * @retval None
+  */
+void delayMilliseconds(uint32_t delay)
+{
+	  HAL_Delay(delay);
+}
+
+/*******************************************************************************
+  * @brief  Un micro retardo
+  * @param  Microsegundos (se mantiene por compatibilidad: ver delayMicroseconds)
+  * @retval None
+  */
+void delayMicro(uint8_t Sticks) {
+	delayMicroseconds(Sticks);
+}
+
+/*******************************************************************************
+  * @brief  Retardo en microsegundos, medido con el contador de ciclos
+  * @param  Microsegundos
+  * @retval None
+  */
+void delayMicroseconds(uint32_t us)
+{
+	delayCycles(us * LCD_CYCLES_PER_US);
+}
+
+/*******************************************************************************
+  * @brief  Retardo en nanosegundos, medido con el contador de ciclos
+  * @param  Nanosegundos (se redondea hacia arriba al ciclo siguiente)
+  * @retval None
+  * @note   A 180 MHz un ciclo es de 5,6 ns: la resolución alcanza para los
+  *         tiempos de E del HD44780. El llamado en sí agrega unos ciclos.
+  */
+void delayNanoseconds(uint32_t ns)
+{
+	delayCycles(LCD_NS_TO_CYCLES(ns));
+}
+
+/*******************************************************************************
+  * @brief  Retardo en ciclos del núcleo
+  * @param  Ciclos
+  * @retval None
+  * @note   La resta en 32 bits funciona aunque DWT->CYCCNT dé la vuelta.
+  */
+void delayCycles(uint32_t Ciclos)
+{
+	uint32_t Inicio = DWT->CYCCNT;
+	while ((DWT->CYCCNT - Inicio) < Ciclos) {
+		// Keep on walking!
+	}
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,248 @@
+/*******************************************************************************
+* @file    LCD_trace.c
+* @author  Guillermo Caporaletti
+* @brief   Registro de flancos de los pines del LCD, exportable como VCD.
+*          Cada digitalWrite/digitalRead/pinMode queda guardado con el valor
+*          de DWT->CYCCNT en un buffer circular en RAM. El volcado en formato
+*          VCD se abre con GTKWave; LCD_traceCheck() compara los tiempos con
+*          los mínimos de la hoja de datos (LCD_T_* en LCD_driver.h).
+*          Se compila sólo si está definido LCD_TRACE (el registro agrega
+*          unos ciclos a cada acceso a pin).
+********************************************************************************
+*/
+
+#ifdef LCD_TRACE
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_trace.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+// Señales registradas
+#define SIG_E		0
+#define SIG_RS		1
+#define SIG_RW		2
+#define SIG_D0		3		// D0 a D7 son 3 a 10
+#define SIG_DIR		11		// Pines de datos en lectura (1) o escritura (0)
+#define SIGNALS		12
+#define SIG_NONE	0xFF
+
+/* Private variables ---------------------------------------------------------*/
+
+static const char * const Nombres[SIGNALS] = {
+	"E", "RS", "RW", "D0", "D1", "D2", "D3", "D4", "D5", "D6", "D7", "DIR"
+};
+
+static const LCDconfig * LCD_trazado = NULL;
+static LCDtraceEntry Registro[LCD_TRACE_SIZE];
+static uint16_t Inicio = 0;		// Evento más viejo
+static uint16_t Cantidad = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t LCD_trace_signal(GPIO_TypeDef * Puerto, uint16_t Pin, LCD_trace_event Evento);
+static uint32_t LCD_trace_ns(uint32_t Ciclos);
+static void LCD_trace_min(LCDtraceReport * Reporte, LCD_trace_check Control, uint32_t Ciclos, uint32_t Minimo_ns);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Comienza a registrar los pines del LCD indicado
+* @param  Estructura del LCD (pines y puertos)
+* @retval None
+*/
+void LCD_traceInit(const LCDconfig * LCD_a_trazar) {
+	LCD_trazado = LCD_a_trazar;
+	LCD_traceClear();
+}
+
+/*******************************************************************************
+* @brief  Registra un acceso a pin (llamada desde LCD_stm32f4xx_nucleo.c)
+* @param  Tipo de evento, puerto, pin y valor
+* @retval None
+*/
+void LCD_traceRecord(LCD_trace_event Evento, GPIO_TypeDef * Puerto, uint16_t Pin, uint8_t Valor) {
+	uint32_t Ciclos = LCD_cycles();	// <-- Lo antes posible
+	if (LCD_trazado == NULL) return;
+
+	uint8_t Senal = LCD_trace_signal(Puerto, Pin, Evento);
+	if (Senal == SIG_NONE) return;
+
+	// Buffer circular: si está lleno piso el evento más viejo
+	uint16_t i = (Inicio + Cantidad) % LCD_TRACE_SIZE;
+	if (Cantidad < LCD_TRACE_SIZE) Cantidad++;
+	else Inicio = (Inicio + 1) % LCD_TRACE_SIZE;
+
+	Registro[i].cycles = Ciclos;
+	Registro[i].event = Evento;
+	Registro[i].signal = Senal;
+	Registro[i].value = Valor;
+}
+
+/*******************************************************************************
+* @brief  Vacía el registro
+* @param  None
+* @retval None
+*/
+void LCD_traceClear(void) {
+	Inicio = 0;
+	Cantidad = 0;
+}
+
+/*******************************************************************************
+* @brief  Cantidad de eventos registrados
+* @param  None
+* @retval Cantidad
+*/
+uint16_t LCD_traceCount(void) {
+	return Cantidad;
+}
+
+/*******************************************************************************
+* @brief  Evento registrado, del más viejo (0) al más nuevo
+* @param  Índice
+* @retval Puntero al evento, NULL si no existe
+*/
+const LCDtraceEntry * LCD_traceEntry(uint16_t Indice) {
+	if (Indice >= Cantidad) return NULL;
+	return &Registro[(Inicio + Indice) % LCD_TRACE_SIZE];
+}
+
+/*******************************************************************************
+* @brief  Vuelca el registro en formato VCD (Value Change Dump)
+* @param  Función de salida de texto
+* @retval None
+*/
+void LCD_traceDumpVCD(LCD_output Salida) {
+	char Linea[48];
+	int Largo;
+
+	// Encabezado: una señal de 1 bit por pin, con tiempos en ns
+	static const char Encabezado[] = "$timescale 1ns $end\n$scope module lcd $end\n";
+	static const char Fin[] = "$upscope $end\n$enddefinitions $end\n";
+
+	Salida(Encabezado, sizeof(Encabezado) - 1);
+	for (uint8_t s=0; s<SIGNALS; s++) {
+		Largo = snprintf(Linea, sizeof(Linea), "$var wire 1 %c %s $end\n", '!' + s, Nombres[s]);
+		Salida(Linea, Largo);
+	}
+	Salida(Fin, sizeof(Fin) - 1);
+	if (Cantidad == 0) return;
+
+	uint32_t Origen = LCD_traceEntry(0)->cycles;
+	uint32_t Anterior = UINT32_MAX;
+	for (uint16_t i=0; i<Cantidad; i++) {
+		const LCDtraceEntry * e = LCD_traceEntry(i);
+		uint32_t t = LCD_trace_ns(e->cycles - Origen);
+		if (t != Anterior) {
+			Largo = snprintf(Linea, sizeof(Linea), "#%lu\n", (unsigned long) t);
+			Salida(Linea, Largo);
+			Anterior = t;
+		}
+		Largo = snprintf(Linea, sizeof(Linea), "%c%c\n", e->value ? '1' : '0', '!' + e->signal);
+		Salida(Linea, Largo);
+	}
+}
+
+/*******************************************************************************
+* @brief  Verifica los tiempos registrados contra los mínimos del HD44780
+* @param  Reporte a completar (puede ser NULL)
+* @retval Cantidad total de violaciones
+*/
+uint32_t LCD_traceCheck(LCDtraceReport * Reporte) {
+	LCDtraceReport Local;
+	if (Reporte == NULL) Reporte = &Local;
+	memset(Reporte, 0, sizeof(*Reporte));
+	for (uint8_t c=0; c<LCD_TRACE_CHECKS; c++) Reporte->worst_ns[c] = UINT32_MAX;
+
+	bool Nivel_E = false, Lectura = false;
+	bool Hay_control = false, Hay_datos = false, Hay_subida = false, Espera_hold = false;
+	uint32_t t_control = 0, t_datos = 0, t_subida = 0, t_bajada = 0;
+
+	for (uint16_t i=0; i<Cantidad; i++) {
+		const LCDtraceEntry * e = LCD_traceEntry(i);
+		if (e->event != LCD_TRACE_WRITE) continue;	// <-- Sólo flancos generados por el MCU
+
+		if (e->signal == SIG_E) {
+			if (e->value == Nivel_E) continue;		// <-- Sin flanco
+			Nivel_E = e->value;
+			if (Nivel_E) {
+				if (Hay_control) LCD_trace_min(Reporte, LCD_TRACE_SETUP, e->cycles - t_control, LCD_T_AS_NS);
+				if (Hay_subida)  LCD_trace_min(Reporte, LCD_TRACE_CYCLE, e->cycles - t_subida, LCD_T_CYCLE_NS);
+				t_subida = e->cycles;
+				Hay_subida = true;
+				Espera_hold = false;
+			} else {
+				if (Hay_subida) LCD_trace_min(Reporte, LCD_TRACE_PULSE, e->cycles - t_subida, LCD_T_PWEH_NS);
+				if (Hay_datos && !Lectura) LCD_trace_min(Reporte, LCD_TRACE_DATA_SETUP, e->cycles - t_datos, LCD_T_DSW_NS);
+				t_bajada = e->cycles;
+				Espera_hold = true;
+			}
+			continue;
+		}
+
+		// Cambio de RS, RW o datos: debe respetar el hold luego de bajar E
+		if (Espera_hold) {
+			LCD_trace_min(Reporte, LCD_TRACE_HOLD, e->cycles - t_bajada, LCD_T_H_NS);
+			Espera_hold = false;
+		}
+		if (e->signal == SIG_RS || e->signal == SIG_RW) {
+			t_control = e->cycles;
+			Hay_control = true;
+			if (e->signal == SIG_RW) Lectura = e->value;
+		} else {
+			t_datos = e->cycles;
+			Hay_datos = true;
+		}
+	}
+
+	uint32_t Total = 0;
+	for (uint8_t c=0; c<LCD_TRACE_CHECKS; c++) Total += Reporte->violations[c];
+	return Total;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Identifica a qué señal del LCD corresponde un pin
+* @param  Puerto, pin y tipo de evento
+* @retval Índice de señal o SIG_NONE
+*/
+static uint8_t LCD_trace_signal(GPIO_TypeDef * Puerto, uint16_t Pin, LCD_trace_event Evento) {
+	if (Puerto == LCD_trazado->enable_port && (Pin & LCD_trazado->enable_pin)) return SIG_E;	// <-- Puede ir junto a otros ENABLE
+	if (Puerto == LCD_trazado->rs_port && Pin == LCD_trazado->rs_pin) return SIG_RS;
+	if (Puerto == LCD_trazado->rw_port && Pin == LCD_trazado->rw_pin) return SIG_RW;
+	for (uint8_t i=0; i<8; i++) {
+		if (Puerto == LCD_trazado->data_ports[i] && Pin == LCD_trazado->data_pins[i]) {
+			// Cambiar de modo un pin de datos se registra en DIR (una vez por cambio)
+			if (Evento == LCD_TRACE_MODE) return (i == 0) ? SIG_DIR : SIG_NONE;
+			return SIG_D0 + i;
+		}
+	}
+	return SIG_NONE;
+}
+
+/*******************************************************************************
+* @brief  Convierte ciclos del núcleo a nanosegundos
+* @param  Ciclos
+* @retval Nanosegundos
+*/
+static uint32_t LCD_trace_ns(uint32_t Ciclos) {
+	return (uint32_t) (((uint64_t) Ciclos * 1000ULL) / LCD_CYCLES_PER_US);
+}
+
+/*******************************************************************************
+* @brief  Compara un intervalo con su mínimo y actualiza el reporte
+* @param  Reporte, control, intervalo en ciclos y mínimo en ns
+* @retval None
+*/
+static void LCD_trace_min(LCDtraceReport * Reporte, LCD_trace_check Control, uint32_t Ciclos, uint32_t Minimo_ns) {
+	uint32_t ns = LCD_trace_ns(Ciclos);
+	if (ns < Reporte->worst_ns[Control]) Reporte->worst_ns[Control] = ns;
+	if (ns < Minimo_ns) Reporte->violations[Control]++;
+}
+
+#endif /* LCD_TRACE */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* @file    LCD_tune.c
+* @author  Guillermo Caporaletti
+* @brief   Ajuste automático de los tiempos del bus para el display conectado.
+*          Partiendo del perfil en uso, baja todos los tiempos paso a paso.
+*          En cada paso escribe patrones de prueba y los relee por RW; se queda
+*          con el paso más rápido que no falló, más un margen de seguridad.
+*          El resultado queda sellado para guardarlo y reusarlo en el próximo
+*          arranque (ver LCD_timingValid y LCD_setTiming).
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_tune.h>
+
+/* Private constants ---------------------------------------------------------*/
+
+// Patrones: alternados, todo 0/1 y bits que caminan en ambos sentidos
+static const uint8_t Patrones[] = {0x55, 0xAA, 0x00, 0xFF, 0x01, 0x80, 0xFE, 0x7F};
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void LCD_tune_scale(LCDtiming * Destino, const LCDtiming * Origen, uint16_t Porcentaje);
+static bool LCD_tune_area(uint8_t * Direccion);
+static bool LCD_tune_test(uint8_t Direccion);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Busca los tiempos más cortos con los que el display responde bien
+* @param  Dónde dejar el perfil resultante (puede ser NULL)
+* @retval true si al menos el perfil original funcionó; false, sin tocar
+*         nada, si no hay RW o no quedan LCD_TUNE_LENGTH celdas fuera de la
+*         vista (por ejemplo en un 40x2 o un 20x4)
+* @note   Deja aplicado el perfil resultante, o el original si ni siquiera ese
+*         pasó la prueba. Durante la prueba escribe de izquierda a derecha y
+*         sin autoscroll; al terminar repone el modo de escritura.
+*/
+bool LCD_autotune(LCDtiming * Resultado) {
+	uint8_t Area;
+	if (!LCD_canRead() || !LCD_tune_area(&Area)) return false;
+
+	LCDtiming Original = *LCD_getTiming();
+	LCDtiming Prueba;
+	uint16_t Mejor = 0;
+	bool Fallo = false;
+
+	// Guardo el AC de la aplicación, el modo de escritura y el contenido del área de prueba
+	uint8_t Direccion_previa = LCD_address();
+	bool Previa_en_cgram = LCD_cgramSelected();
+	uint8_t Modo = LCD_entryMode();
+	uint8_t Contenido[LCD_TUNE_LENGTH];
+	for (uint8_t i=0, a=Area; i<LCD_TUNE_LENGTH; i++, a=LCD_nextAddress(a)) {
+		Contenido[i] = LCD_shadow(a);
+	}
+
+	// Con autoscroll, cada escritura desplazaría la pantalla
+	if ((Modo & LCD_ENTRYLEFT) == 0) LCD_leftToRight();
+	if (Modo & LCD_ENTRYSHIFTINCREMENT) LCD_noAutoscroll();
+
+	// Bajo los tiempos mientras las pruebas pasen
+	for (uint8_t n=0; n<LCD_TUNE_STEPS; n++) {
+		uint16_t p = 100 - n * LCD_TUNE_STEP_PCT;
+		LCD_tune_scale(&Prueba, &Original, p);
+		LCD_setTiming(&Prueba);
+		if (!LCD_tune_test(Area)) {
+			Fallo = true;
+			break;
+		}
+		Mejor = p;
+	}
+
+	// Aplico el margen sobre el último que anduvo
+	if (Mejor != 0) {
+		uint16_t Final = Mejor + (Mejor * LCD_TUNE_MARGIN_PCT) / 100;
+		if (Final > 100) Final = 100;
+		LCD_tune_scale(&Prueba, &Original, Final);
+	} else {
+		Prueba = Original;
+	}
+	LCD_timingSeal(&Prueba);
+	LCD_setTiming(&Prueba);
+	if (Resultado != NULL) *Resultado = Prueba;
+
+	// Un paso que falló puede haber perdido un nibble (en 4 bits el display
+	// queda a medio byte): sincronizo antes de escribir nada más
+	if (Fallo) LCD_resync();
+
+	// Restauro las celdas de prueba, el modo de escritura y el AC de la aplicación
+	LCD_command(LCD_SETDDRAMADDR | Area);
+	for (uint8_t i=0; i<LCD_TUNE_LENGTH; i++) {
+		LCD_write(Contenido[i]);
+	}
+	if ((Modo & LCD_ENTRYLEFT) == 0) LCD_rightToLeft();
+	if (Modo & LCD_ENTRYSHIFTINCREMENT) LCD_autoscroll();
+	LCD_command((Previa_en_cgram ? LCD_SETCGRAMADDR : LCD_SETDDRAMADDR) | Direccion_previa);
+
+	// Lo que se desincronizó pudo llegar como comandos cualquiera
+	if (Fallo && LCD_lost()) LCD_restore();
+
+	return Mejor != 0;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Escala todos los tiempos de un perfil
+* @param  Destino, origen y porcentaje
+* @retval None
+*/
+static void LCD_tune_scale(LCDtiming * Destino, const LCDtiming * Origen, uint16_t Porcentaje) {
+	Destino->as_ns = (Origen->as_ns * Porcentaje) / 100;
+	Destino->pweh_ns = (Origen->pweh_ns * Porcentaje) / 100;
+	Destino->ddr_ns = (Origen->ddr_ns * Porcentaje) / 100;
+	Destino->h_ns = (Origen->h_ns * Porcentaje) / 100;
+	Destino->cycle_ns = (Origen->cycle_ns * Porcentaje) / 100;
+	Destino->exec_us = (Origen->exec_us * Porcentaje) / 100;
+	Destino->clear_us = Origen->clear_us;	// <-- Probarlo exigiría borrar la pantalla
+	Destino->seal = 0;
+}
+
+/*******************************************************************************
+* @brief  Busca LCD_TUNE_LENGTH celdas seguidas de DDRAM que no se vean
+* @param  Dónde dejar la dirección de la primera
+* @retval true si las hay
+* @note   Según las filas y columnas en uso y el desplazamiento actual (el
+*         autoscroll queda apagado durante la prueba).
+*/
+static bool LCD_tune_area(uint8_t * Direccion) {
+	uint32_t Visible[4] = {0};		// <-- Un bit por dirección de DDRAM (0x00-0x7F)
+
+	for (uint8_t r=0; r<LCD_lines(); r++) {
+		for (uint8_t c=0; c<LCD_columns(); c++) {
+			uint8_t a = LCD_scrolledAddress(c, r, 0) & 0x7F;
+			Visible[a >> 5] |= 1UL << (a & 31);
+		}
+	}
+
+	// Recorro las direcciones en el orden del AC (en 2 líneas, 0x27 sigue en 0x40)
+	uint8_t Inicio = 0;
+	for (uint8_t n=0; n<LCD_DDRAM_SIZE; n++, Inicio=LCD_nextAddress(Inicio)) {
+		uint8_t a = Inicio, i = 0;
+		while (i < LCD_TUNE_LENGTH && (Visible[a >> 5] & (1UL << (a & 31))) == 0) {
+			a = LCD_nextAddress(a);
+			i++;
+		}
+		if (i == LCD_TUNE_LENGTH) {
+			*Direccion = Inicio;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*******************************************************************************
+* @brief  Escribe los patrones en el área de prueba y los relee
+* @param  Dirección de la primera celda de prueba
+* @retval true si todo se leyó igual a lo escrito
+* @note   Escribe con LCD_command/LCD_write, que actualizan la sombra; el
+*         llamador guarda antes el contenido y lo repone al terminar.
+*/
+static bool LCD_tune_test(uint8_t Direccion) {
+	for (uint8_t r=0; r<LCD_TUNE_ROUNDS; r++) {
+		// Escribo corrido (cada dato espera sólo el tiempo de ejecución en prueba)
+		LCD_command(LCD_SETDDRAMADDR | Direccion);
+		for (uint8_t i=0; i<LCD_TUNE_LENGTH; i++) {
+			LCD_write(Patrones[(i + r) % sizeof(Patrones)]);
+		}
+
+		// Releo y comparo
+		LCD_command(LCD_SETDDRAMADDR | Direccion);
+		for (uint8_t i=0; i<LCD_TUNE_LENGTH; i++) {
+			if (LCD_data_read() != Patrones[(i + r) % sizeof(Patrones)]) return false;
+		}
+	}
+	return true;
+}
+
+/***************************************************************END OF FILE****/
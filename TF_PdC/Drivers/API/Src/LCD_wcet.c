@@ -0,0 +1,199 @@
+/*******************************************************************************
+* @file    LCD_wcet.c
+* @author  Guillermo Caporaletti
+* @brief   Cotas del tiempo que puede bloquear cada función del driver.
+*          Ninguna espera del driver depende de cuántas veces se repite un
+*          lazo: todas terminan, a más tardar, en el tiempo del perfil (el de
+*          la instrucción anterior, o el de un clear si el display no
+*          contesta). Así, el tiempo de cada función es a lo sumo su cantidad
+*          de transferencias por lo que tarda cada una, más lo que quedaba de
+*          la instrucción anterior. Las cotas para el perfil más lento se
+*          verifican al compilar; LCD_wcetTable() las calcula para un perfil
+*          y un modo de bus dados, con la geometría del display en uso.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_wcet.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+// Cota al compilar: perfil más lento y bus de 4 bits (el que más tarda)
+#define LCD_WCET_WORST_US(k, espera) \
+	LCD_WCET_US(LCD_WCET_EXEC_US, LCD_WCET_CLEAR_US, LCD_WCET_CYCLE_NS, true, k, espera)
+
+/* Compile-time checks -------------------------------------------------------*/
+
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_PRINT(LCD_PRINT_MAX), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_print: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_CLEAR, LCD_WCET_WAIT_CLEAR(LCD_WCET_CLEAR_US)) <= LCD_WCET_LIMIT_US,
+	"LCD_clear/LCD_home: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_CREATECHAR, 0) <= LCD_WCET_LIMIT_US,
+	"LCD_createChar: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_CONTROL, 0) <= LCD_WCET_LIMIT_US,
+	"LCD_display/LCD_cursor/LCD_blink: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_SERVICE, LCD_WCET_BUDGET_US) <= LCD_WCET_LIMIT_US,
+	"LCD_service: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_PRINTSCREEN(LCD_WCET_LINES, LCD_WCET_COLUMNS), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_printScreen: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_CONSOLE(LCD_WCET_LINES, LCD_WCET_COLUMNS), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_console*: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_MIRROR(LCD_PRINT_MAX), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_mirrorPrint: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_MIRROR(LCD_DDRAM_CELLS), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_mirrorCopy: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_RESTORE(LCD_WCET_DISPLAYS), LCD_WCET_WAIT_RESTORE(LCD_WCET_CLEAR_US)) <= LCD_WCET_LIMIT_RESTORE_US,
+	"LCD_restore: la cota supera LCD_WCET_LIMIT_RESTORE_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_LOST(LCD_WCET_DISPLAYS), LCD_WCET_WAIT_LOST(LCD_WCET_CLEAR_US, LCD_WCET_DISPLAYS)) <= LCD_WCET_LIMIT_RESTORE_US,
+	"LCD_lost: la cota supera LCD_WCET_LIMIT_RESTORE_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_AUTOTUNE(LCD_WCET_DISPLAYS), LCD_WCET_WAIT_AUTOTUNE(LCD_WCET_CLEAR_US, LCD_WCET_DISPLAYS)) <= LCD_WCET_LIMIT_TUNE_US,
+	"LCD_autotune: la cota supera LCD_WCET_LIMIT_TUNE_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_RECOVER(LCD_WCET_DISPLAYS), LCD_WCET_WAIT_RECOVER(LCD_WCET_CLEAR_US, LCD_WCET_DISPLAYS)) <= LCD_WCET_LIMIT_RESTORE_US,
+	"LCD_recover: la cota supera LCD_WCET_LIMIT_RESTORE_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_RESYNC, LCD_WCET_WAIT_SYNC) <= LCD_WCET_LIMIT_RESTORE_US,
+	"LCD_resync: la cota supera LCD_WCET_LIMIT_RESTORE_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_UTF8(LCD_PRINT_MAX), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_printUTF8: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_TRANSLATE, 0) <= LCD_WCET_LIMIT_US,
+	"LCD_translate: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_FIELD(LCD_FIELD_MAX, LCD_FIELD_WIDTH), 0) <= LCD_WCET_LIMIT_REDRAW_US,
+	"LCD_fieldUpdate: la cota supera LCD_WCET_LIMIT_REDRAW_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_SCRUB(LCD_WCET_SCRUB_US, LCD_WCET_EXEC_US), 0) <= LCD_WCET_LIMIT_US,
+	"LCD_scrub: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_SPARK_ADD, 0) <= LCD_WCET_LIMIT_US,
+	"LCD_sparkAdd: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_SPARK_DRAW, 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_sparkDraw: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_BANK(LCD_CGRAM_SIZE / LCD_GLYPH_ROWS), 0) <= LCD_WCET_LIMIT_SCREEN_US,
+	"LCD_bankLoad: la cota supera LCD_WCET_LIMIT_SCREEN_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_ANIM, 0) <= LCD_WCET_LIMIT_US,
+	"LCD_animUpdate*: la cota supera LCD_WCET_LIMIT_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_PLAN(LCD_WCET_LINES, LCD_WCET_COLUMNS), LCD_WCET_WAIT_CLEAR(LCD_WCET_CLEAR_US)) <= LCD_WCET_LIMIT_REDRAW_US,
+	"LCD_planRun/LCD_planUpdate: la cota supera LCD_WCET_LIMIT_REDRAW_US");
+_Static_assert(LCD_WCET_WORST_US(LCD_WCET_K_QUEUE(LCD_WCET_QUEUE_OPS, LCD_WCET_LINES, LCD_WCET_COLUMNS),
+		LCD_WCET_WAIT_QUEUE(LCD_WCET_CLEAR_US, LCD_WCET_QUEUE_OPS)) <= LCD_WCET_LIMIT_REDRAW_US,
+	"LCD_queueService: la cota supera LCD_WCET_LIMIT_REDRAW_US");
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Calcula la cota de cada función para un perfil y un modo de bus
+* @param  Perfil de tiempos, true para 4 bits, y tabla a completar
+* @retval None
+* @note   LCD_print y LCD_mirrorPrint con LCD_PRINT_MAX caracteres,
+*         LCD_service con LCD_WCET_BUDGET_US de presupuesto, LCD_scrub con
+*         LCD_WCET_SCRUB_US, LCD_queueService con LCD_WCET_QUEUE_OPS
+*         operaciones, LCD_bankLoad con los 8 lugares, y las demás con las
+*         filas, columnas y displays en uso (llamar luego de LCD_init; la
+*         consola, con toda la pantalla; los campos, todos del ancho de la
+*         pantalla o de LCD_FIELD_WIDTH).
+*/
+void LCD_wcetTable(const LCDtiming * Perfil, bool Cuatro_bits, LCDwcetRow Tabla[LCD_WCET_ROWS]) {
+	uint32_t e = Perfil->exec_us, c = Perfil->clear_us, y = Perfil->cycle_ns;
+	uint8_t Displays = LCD_displays();
+	uint8_t Ancho = (LCD_columns() < LCD_FIELD_WIDTH) ? LCD_columns() : LCD_FIELD_WIDTH;
+	static const char * const Nombres[LCD_WCET_ROWS] = {
+		"LCD_write, LCD_command, LCD_setCursor, LCD_scrollDisplay*",
+		"LCD_data_read, LCD_address_read, LCD_busy_flag",
+		"LCD_print",
+		"LCD_clear, LCD_home",
+		"LCD_display, LCD_cursor, LCD_blink",
+		"LCD_leftToRight, LCD_autoscroll, LCD_flush",
+		"LCD_createChar",
+		"LCD_glyphRow",
+		"LCD_printScreen",
+		"LCD_restore",
+		"LCD_lost",
+		"LCD_autotune",
+		"LCD_service",
+		"LCD_consolePrint, LCD_consoleFlush",
+		"LCD_mirrorWrite",
+		"LCD_mirrorPrint",
+		"LCD_mirrorCopy",
+		"LCD_recover",
+		"LCD_resync",
+		"LCD_printUTF8",
+		"LCD_translate",
+		"LCD_fieldUpdate",
+		"LCD_scrub",
+		"LCD_sparkAdd",
+		"LCD_sparkDraw",
+		"LCD_bankLoad",
+		"LCD_animUpdate, LCD_animUpdateBudget",
+		"LCD_planRun, LCD_planUpdate",
+		"LCD_queueService"
+	};
+	const uint16_t Transferencias[LCD_WCET_ROWS] = {
+		LCD_WCET_K_WRITE,
+		LCD_WCET_K_READ,
+		LCD_WCET_K_PRINT(LCD_PRINT_MAX),
+		LCD_WCET_K_CLEAR,
+		LCD_WCET_K_CONTROL,
+		LCD_WCET_K_MODE,
+		LCD_WCET_K_CREATECHAR,
+		LCD_WCET_K_GLYPHROW,
+		LCD_WCET_K_PRINTSCREEN(LCD_lines(), LCD_columns()),
+		LCD_WCET_K_RESTORE(Displays),
+		LCD_WCET_K_LOST(Displays),
+		LCD_WCET_K_AUTOTUNE(Displays),
+		LCD_WCET_K_SERVICE,
+		LCD_WCET_K_CONSOLE(LCD_lines(), LCD_columns()),
+		LCD_WCET_K_MIRROR(1),
+		LCD_WCET_K_MIRROR(LCD_PRINT_MAX),
+		LCD_WCET_K_MIRROR(LCD_DDRAM_CELLS),
+		LCD_WCET_K_RECOVER(Displays),
+		LCD_WCET_K_RESYNC,
+		LCD_WCET_K_UTF8(LCD_PRINT_MAX),
+		LCD_WCET_K_TRANSLATE,
+		LCD_WCET_K_FIELD(LCD_FIELD_MAX, Ancho),
+		LCD_WCET_K_SCRUB(LCD_WCET_SCRUB_US, (e > 0) ? e : 1),
+		LCD_WCET_K_SPARK_ADD,
+		LCD_WCET_K_SPARK_DRAW,
+		LCD_WCET_K_BANK(LCD_CGRAM_SIZE / LCD_GLYPH_ROWS),
+		LCD_WCET_K_ANIM,
+		LCD_WCET_K_PLAN(LCD_lines(), LCD_columns()),
+		LCD_WCET_K_QUEUE(LCD_WCET_QUEUE_OPS, LCD_lines(), LCD_columns())
+	};
+	const uint32_t Esperas[LCD_WCET_ROWS] = {
+		[LCD_WCET_CLEAR] = LCD_WCET_WAIT_CLEAR(c),
+		[LCD_WCET_RESTORE] = LCD_WCET_WAIT_RESTORE(c),
+		[LCD_WCET_LOST] = LCD_WCET_WAIT_LOST(c, Displays),
+		[LCD_WCET_AUTOTUNE] = LCD_WCET_WAIT_AUTOTUNE(c, Displays),
+		[LCD_WCET_SERVICE] = LCD_WCET_BUDGET_US,
+		[LCD_WCET_RECOVER] = LCD_WCET_WAIT_RECOVER(c, Displays),
+		[LCD_WCET_RESYNC] = LCD_WCET_WAIT_SYNC,
+		[LCD_WCET_PLAN] = LCD_WCET_WAIT_CLEAR(c),
+		[LCD_WCET_QUEUE] = LCD_WCET_WAIT_QUEUE(c, LCD_WCET_QUEUE_OPS)
+	};
+
+	for (uint8_t i=0; i<LCD_WCET_ROWS; i++) {
+		Tabla[i].name = Nombres[i];
+		Tabla[i].transfers = (uint16_t) (Transferencias[i] + LCD_WCET_PENDING + LCD_WCET_BUSY_EVENT);
+		Tabla[i].bound_us = LCD_WCET_US(e, c, y, Cuatro_bits, Transferencias[i], Esperas[i]);
+	}
+}
+
+/*******************************************************************************
+* @brief  Calcula la cota de LCD_printn o LCD_printSpan
+* @param  Perfil de tiempos, true para 4 bits, y caracteres a enviar
+* @retval Tiempo máximo bloqueado, en us
+*/
+uint32_t LCD_wcetPrint(const LCDtiming * Perfil, bool Cuatro_bits, size_t Largo) {
+	return LCD_WCET_US(Perfil->exec_us, Perfil->clear_us, Perfil->cycle_ns, Cuatro_bits, Largo, 0);
+}
+
+/*******************************************************************************
+* @brief  Indica si un perfil está cubierto por las cotas verificadas al compilar
+* @param  Perfil de tiempos
+* @retval true si no es más lento que LCD_WCET_EXEC_US, LCD_WCET_CLEAR_US y
+*         LCD_WCET_CYCLE_NS
+* @note   LCD_autotune() sólo acorta el perfil (salvo clear, que no cambia).
+*/
+bool LCD_wcetCovers(const LCDtiming * Perfil) {
+	return Perfil->exec_us <= LCD_WCET_EXEC_US
+		&& Perfil->clear_us <= LCD_WCET_CLEAR_US
+		&& Perfil->cycle_ns <= LCD_WCET_CYCLE_NS;
+}
+
+/***************************************************************END OF FILE****/
@@ -1,177 +1,227 @@
-/*******************************************************************************
-* @file    main.c
-* @author  Guillermo Caporaletti
-* @brief   Programa de prueba de LCD_driver.h
-*          CESE, 18Co, FIUBA, octubre de 2022
-*          Más detalles en main.h
-********************************************************************************
-*/
-
-/* Includes ------------------------------------------------------------------*/
-#include "main.h"
-
-/* Private macros ------------------------------------------------------------*/
-#define TIEMPO_1_ENCENDIDO_LED 100
-#define TIEMPO_2_ENCENDIDO_LED 1000
-#define INTERVALO_FINAL_COUNTDOWN 10
-
-/* Private variables ---------------------------------------------------------*/
-delay_t parpadeoLed;				// Estructura para parpadeo de LED2
-delay_t refresco_Final_Countdown;	// (leer en pantalla...)
-uint32_t The_Final_Countdown=0;
-char Numero_en_cadena[16];
-
-// Caracter especial
-uint8_t Alf[8] = {
-  0b10001,
-  0b10001,
-  0b01110,
-  0b10101,
-  0b11111,
-  0b11111,
-  0b01110,
-  0b11011
-};
-
-/* Private function prototypes -----------------------------------------------*/
-static void CambiarTiempoParpadeoLed(void);
-static void LeerPantalla();
-
-/*******************************************************************************
-  * @brief  Main program
-  * @param  None
-  * @retval None
-  */
-int main(void)
-{
-  /* Inicialización para el manejo de errores    */
-  Error_Handler_Init();
-
-  /* STM32F4xx HAL library initialization:       */
-  HAL_Init();
-
-  /* Configure the system clock to 180 MHz       */
-  SystemClock_Config();
-
-  // Inicializo APIs
-  if (uartInit() == false) Error_Handler();
-  debounceFSM_init();
-  BSP_LED_Init(LED2);
-  delayInit( &parpadeoLed, TIEMPO_1_ENCENDIDO_LED);
-  delayInit( &refresco_Final_Countdown, INTERVALO_FINAL_COUNTDOWN);
-  The_Final_Countdown--;
-
-  // Driver que queremos probar!!!
-  LCD_init();
-  LCD_createChar(0, Alf);	// <--¿Aparecerá en la pantalla?
-
-  // Comienzo a mandar mensajes...
-  uartSendCR();
-  uartSendString((uint8_t *)"Recibiendo mensaje...\n\n");
-
-  LCD_home();
-  LCD_cursor();
-  LCD_blink();
-  delayMilliseconds(2000);
-
-  LCD_setCursor(0,0);
-  LCD_print("Hola terricolas");
-  delayMilliseconds(2000);
-
-  LCD_setCursor(0,1);
-  LCD_print("Como estan?");
-  delayMilliseconds(2000);
-
-  LeerPantalla();
-  uartSendCR();
-  uartSendString((uint8_t *)"Empieza cuenta...\n");
-
-  LCD_clear();
-  LCD_print("Vamos en camino!");
-  sprintf(Numero_en_cadena, "%lu",The_Final_Countdown);
-  LCD_setCursor(0,1);
-  LCD_noCursor();
-  LCD_noBlink();
-  LCD_print(Numero_en_cadena);
-
-  LCD_setCursor(15,1);
-  LCD_write(0);
-
-
-
-  /* Infinite loop */
-  while (1)
-  {
-	  // Reviso el boton de usuario...
-	  debounceFSM_update();
-
-	  // Reviso cuenta final
-	  if (delayRead( &refresco_Final_Countdown )) {
-		  The_Final_Countdown-=5;
-		  LCD_setCursor(0,1);
-		  sprintf(Numero_en_cadena, "%lu",The_Final_Countdown);
-		  LCD_print(Numero_en_cadena);
-	  }
-
-	  // Además parpadeo LED2
-	  if (delayRead( &parpadeoLed )) BSP_LED_Toggle(LED2);
-
-	  // Si hay flanco descendiente cambio parpadeo
-	  if (readKey()) {
-		  CambiarTiempoParpadeoLed();
-		  uartSendCR();
-		  LeerPantalla();
-	  }
-
-  }
-} /* Fin de función main ******************************************************/
-
-/*******************************************************************************
-  * @brief  Cambia el tiempo de parpadeo del LED2
-  * @param  None
-  * @retval None
-  */
-static void CambiarTiempoParpadeoLed(void) {
-	// Cambio el tiempo de encendido
-	static tick_t Encendido = TIEMPO_1_ENCENDIDO_LED;
-	delayWrite( &parpadeoLed, Encendido );
-
-	switch (Encendido) {
-		case TIEMPO_1_ENCENDIDO_LED:
-			Encendido = TIEMPO_2_ENCENDIDO_LED;
-		break;
-
-		case TIEMPO_2_ENCENDIDO_LED:
-			Encendido = TIEMPO_1_ENCENDIDO_LED;
-		break;
-
-		default:
-			Encendido = TIEMPO_1_ENCENDIDO_LED;
-		break;
-	}
-}
-
-/*******************************************************************************
-  * @brief  Lee pantalla y lo manda a la UART
-  * @param  None
-  * @retval None
-  */
-static void LeerPantalla(void) {
-	LCD_setCursor(0,0);
-	uint8_t Caracter_leido;
-
-	for (uint8_t i=0; i<80; i++) {
-		if (i==40) uartSendCR();	// <-- Retorno de línea al completarse una fila de la pantalla
-		Caracter_leido = LCD_data_read();
-		if (Caracter_leido > 31) {
-			uartSendStringSize(&Caracter_leido, 1);
-		} else {
-			uartSendStringSize((uint8_t *)" ", 1);
-		}
-	}
-	uartSendCR();	// <-- Retorno de línea
-}
-
-
-
-/***************************************************************END OF FILE****/
+/*******************************************************************************
+* @file    main.c
+* @author  Guillermo Caporaletti
+* @brief   Programa de prueba de LCD_driver.h
+*          CESE, 18Co, FIUBA, octubre de 2022
+*          Más detalles en main.h
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private macros ------------------------------------------------------------*/
+#define TIEMPO_1_ENCENDIDO_LED 100
+#define TIEMPO_2_ENCENDIDO_LED 1000
+#define INTERVALO_FINAL_COUNTDOWN 10
+#define PRESUPUESTO_LCD_US 200		// Tiempo máximo por vuelta para el display
+#define INTERVALO_REVISION_LCD 500	// Cada cuánto verificar que el display no se reinició
+
+/* Private variables ---------------------------------------------------------*/
+delay_t parpadeoLed;				// Estructura para parpadeo de LED2
+delay_t refresco_Final_Countdown;	// (leer en pantalla...)
+delay_t revision_LCD;				// Cortes de alimentación del display
+uint32_t The_Final_Countdown=0;
+char Numero_en_cadena[16];
+
+// Caracter especial (banco de la pantalla, empaquetado en flash)
+static const LCDglyph Glifos[] = {
+  LCD_GLYPH(0b10001,
+            0b10001,
+            0b01110,
+            0b10101,
+            0b11111,
+            0b11111,
+            0b01110,
+            0b11011)		// Alf, en el lugar 0
+};
+static const LCDglyphBank Banco = {Glifos, 0, 1};
+
+// Ruedita que gira en la posición (14,1), con el caracter 1 de CGRAM.
+// El primer cuadro carga el glifo entero; los demás, sólo las filas que cambian.
+#define RUEDITA_MS 150
+static const LCDanimRow Ruedita_barra[] = {		// |
+  {0x08, 0x00}, {0x09, 0x04}, {0x0A, 0x04}, {0x0B, 0x04},
+  {0x0C, 0x04}, {0x0D, 0x04}, {0x0E, 0x00}, {0x0F, 0x00}
+};
+static const LCDanimCell Ruedita_lugar[] = {{14, 1, 1}};
+static const LCDanimRow Ruedita_a_diagonal[] = {	// | -> /
+  {0x09, 0x01}, {0x0A, 0x02}, {0x0C, 0x08}, {0x0D, 0x10}
+};
+static const LCDanimRow Ruedita_a_guion[] = {		// / -> -
+  {0x09, 0x00}, {0x0A, 0x00}, {0x0B, 0x1F}, {0x0C, 0x00}, {0x0D, 0x00}
+};
+static const LCDanimRow Ruedita_a_contrabarra[] = {	// - -> contrabarra
+  {0x09, 0x10}, {0x0A, 0x08}, {0x0B, 0x04}, {0x0C, 0x02}, {0x0D, 0x01}
+};
+static const LCDanimRow Ruedita_a_barra[] = {		// contrabarra -> |
+  {0x09, 0x04}, {0x0A, 0x04}, {0x0C, 0x04}, {0x0D, 0x04}
+};
+static const LCDanimFrame Ruedita_cuadros[] = {
+  {RUEDITA_MS, Ruedita_barra, LCD_ANIM_COUNT(Ruedita_barra), Ruedita_lugar, LCD_ANIM_COUNT(Ruedita_lugar)},
+  {RUEDITA_MS, Ruedita_a_diagonal, LCD_ANIM_COUNT(Ruedita_a_diagonal), NULL, 0},
+  {RUEDITA_MS, Ruedita_a_guion, LCD_ANIM_COUNT(Ruedita_a_guion), NULL, 0},
+  {RUEDITA_MS, Ruedita_a_contrabarra, LCD_ANIM_COUNT(Ruedita_a_contrabarra), NULL, 0},
+  {RUEDITA_MS, Ruedita_a_barra, LCD_ANIM_COUNT(Ruedita_a_barra), NULL, 0}
+};
+static const LCDanimation Ruedita = {Ruedita_cuadros, 5, 1};
+LCDanimPlayer ruedita;
+
+/* Private function prototypes -----------------------------------------------*/
+static void CambiarTiempoParpadeoLed(void);
+static void LeerPantalla();
+
+/*******************************************************************************
+  * @brief  Main program
+  * @param  None
+  * @retval None
+  */
+int main(void)
+{
+  /* Inicialización para el manejo de errores    */
+  Error_Handler_Init();
+
+  /* STM32F4xx HAL library initialization:       */
+  HAL_Init();
+
+  /* Configure the system clock to 180 MHz       */
+  SystemClock_Config();
+
+  // Inicializo APIs
+  if (uartInit() == false) Error_Handler();
+  debounceFSM_init();
+  BSP_LED_Init(LED2);
+  delayInit( &parpadeoLed, TIEMPO_1_ENCENDIDO_LED);
+  delayInit( &refresco_Final_Countdown, INTERVALO_FINAL_COUNTDOWN);
+  delayInit( &revision_LCD, INTERVALO_REVISION_LCD);
+  The_Final_Countdown--;
+
+  // Driver que queremos probar!!!
+  LCD_init();
+  if (!LCD_wcetCovers(LCD_getTiming())) Error_Handler();	// <-- Perfil más lento que las cotas
+  LCD_deferControl(true);	// <-- Cursor y parpadeo salen juntos, en un comando
+  LCD_bankLoad(&Banco);	// <--¿Aparecerá en la pantalla?
+
+  // Comienzo a mandar mensajes...
+  uartSendCR();
+  uartSendString((uint8_t *)"Recibiendo mensaje...\n\n");
+
+  LCD_home();
+  LCD_cursor();
+  LCD_blink();
+  LCD_flush();			// <-- No hay nada más que enviar antes de la espera
+  delayMilliseconds(2000);
+
+  LCD_setCursor(0,0);
+  LCD_print("Hola terricolas");
+  delayMilliseconds(2000);
+
+  LCD_setCursor(0,1);
+  LCD_print("Como estan?");
+  delayMilliseconds(2000);
+
+  LeerPantalla();
+  uartSendCR();
+  uartSendString((uint8_t *)"Empieza cuenta...\n");
+
+  LCD_clear();
+  LCD_print("Vamos en camino!");
+  sprintf(Numero_en_cadena, "%lu",The_Final_Countdown);
+  LCD_setCursor(0,1);
+  LCD_noCursor();
+  LCD_noBlink();
+  LCD_print(Numero_en_cadena);
+
+  LCD_setCursor(15,1);
+  LCD_write(0);
+
+  LCD_animStart(&ruedita, &Ruedita);
+
+
+  /* Infinite loop */
+  while (1)
+  {
+	  // Reviso el boton de usuario...
+	  debounceFSM_update();
+
+	  // Reviso cuenta final
+	  if (delayRead( &refresco_Final_Countdown )) {
+		  The_Final_Countdown-=5;
+		  sprintf(Numero_en_cadena, "%lu",The_Final_Countdown);
+		  LCD_servicePrint(0, 1, Numero_en_cadena);	// <-- Sólo se anota
+	  }
+
+	  // El display no se pasa del presupuesto de la vuelta. Si toca revisar
+	  // si se reinició (corte de alimentación), la vuelta es sólo para eso;
+	  // si no, la ruedita y luego lo anotado se reparten el presupuesto
+	  if (delayRead( &revision_LCD )) {
+		  LCD_recover();	// <-- Si se reinició, la reposición sí tarda (unos 8 ms)
+	  } else {
+		  uint32_t Inicio_LCD = LCD_cycles();
+		  LCD_animUpdateBudget(&ruedita, PRESUPUESTO_LCD_US);
+		  uint32_t Gastado_LCD = (LCD_cycles() - Inicio_LCD) / LCD_CYCLES_PER_US;
+		  if (Gastado_LCD < PRESUPUESTO_LCD_US) LCD_service(PRESUPUESTO_LCD_US - Gastado_LCD);
+	  }
+
+	  // Además parpadeo LED2
+	  if (delayRead( &parpadeoLed )) BSP_LED_Toggle(LED2);
+
+	  // Si hay flanco descendiente cambio parpadeo
+	  if (readKey()) {
+		  CambiarTiempoParpadeoLed();
+		  uartSendCR();
+		  LeerPantalla();
+	  }
+
+  }
+} /* Fin de función main ******************************************************/
+
+/*******************************************************************************
+  * @brief  Cambia el tiempo de parpadeo del LED2
+  * @param  None
+  * @retval None
+  */
+static void CambiarTiempoParpadeoLed(void) {
+	// Cambio el tiempo de encendido
+	static tick_t Encendido = TIEMPO_1_ENCENDIDO_LED;
+	delayWrite( &parpadeoLed, Encendido );
+
+	switch (Encendido) {
+		case TIEMPO_1_ENCENDIDO_LED:
+			Encendido = TIEMPO_2_ENCENDIDO_LED;
+		break;
+
+		case TIEMPO_2_ENCENDIDO_LED:
+			Encendido = TIEMPO_1_ENCENDIDO_LED;
+		break;
+
+		default:
+			Encendido = TIEMPO_1_ENCENDIDO_LED;
+		break;
+	}
+}
+
+/*******************************************************************************
+  * @brief  Lee pantalla y lo manda a la UART
+  * @param  None
+  * @retval None
+  */
+static void LeerPantalla(void) {
+	LCD_setCursor(0,0);
+	uint8_t Caracter_leido;
+
+	for (uint8_t i=0; i<80; i++) {
+		if (i==40) uartSendCR();	// <-- Retorno de línea al completarse una fila de la pantalla
+		Caracter_leido = LCD_data_read();
+		if (Caracter_leido > 31) {
+			uartSendStringSize(&Caracter_leido, 1);
+		} else {
+			uartSendStringSize((uint8_t *)" ", 1);
+		}
+	}
+	uartSendCR();	// <-- Retorno de línea
+}
+
+
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,89 @@
+/*******************************************************************************
+* @file    LCD_sim.h
+* @author  Guillermo Caporaletti
+* @brief   Modelo del HD44780 para probar el driver en la PC.
+* ********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef LCD_SIM_H
+#define LCD_SIM_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_driver.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define LCD_SIM_GPIO_CYCLES		20		// Costo de cada acceso a un pin por HAL
+#define LCD_SIM_DWT_STEP		4		// Costo de leer el contador de ciclos...
+#define LCD_SIM_DWT_MAX_STEP	32		// ...que crece en las esperas
+#define LCD_SIM_EXEC_CYCLES		(37UL * LCD_CYCLES_PER_US)		// Instrucciones y datos
+#define LCD_SIM_CLEAR_CYCLES	(1520UL * LCD_CYCLES_PER_US)	// Clear y home
+
+// Cableado de la variante que se compila (ver "Makefile")
+#ifdef LCD_FOURBITMODE
+#define LCD_SIM_FOUR_WIRES		LCD_FOURBITMODE
+#else
+#define LCD_SIM_FOUR_WIRES		false
+#endif
+
+/* Types ---------------------------------------------------------------------*/
+
+// Un controlador (lo que tiene adentro el HD44780)
+typedef struct {
+	uint8_t ddram[128];
+	uint8_t cgram[64];
+	uint8_t ac;
+	bool cgram_selected;
+	bool increment;			// I/D
+	bool display_shift;		// S (autoscroll)
+	uint8_t control;		// D, C y B
+	int16_t shift;			// Desplazamientos a la izquierda
+	bool eight_bits;		// DL
+	bool two_lines;			// N
+	bool half;				// En 4 bits: llegó el primer nibble de una escritura
+	uint8_t high;
+	bool read_half;			// En 4 bits: falta leer el segundo nibble
+	uint8_t latch;
+	bool enable;			// ENABLE arriba
+	bool reading_ir;		// Leyendo el registro de instrucción (BF en DB7)
+	uint64_t busy_until;	// Ciclo en que termina la instrucción en curso
+	uint32_t pulses, commands, data, set_address, reads;
+	uint32_t clears, homes, control_commands, mode_commands;
+} LCDsimDisplay;
+
+typedef struct {
+	LCDsimDisplay display[LCD_MAX_DISPLAYS];
+	bool four_wires;		// Sólo DB4-DB7 conectados (D0 a D3 de la placa)
+	bool busy_model;		// BF alto mientras ejecuta (si no, siempre listo)
+	uint8_t drop;			// Pulsos de escritura a perder si llegan con el display ocupado
+	uint64_t cycles;		// Tiempo, en ciclos de la CPU
+	uint32_t gpio_writes, gpio_reads, pin_modes;
+	uint32_t irqs, wfis;
+	uint32_t fmc_writes, fmc_reads;	// Accesos al banco del FMC (compilando con LCD_FMC)
+	uint32_t exti_inits;	// HAL_GPIO_Init con la EXTI (no se borra con LCD_simZero)
+	bool nvic_enabled;
+	bool irq_on;			// PRIMASK en 0
+} LCDsim;
+
+/* Exported variables --------------------------------------------------------*/
+
+extern LCDsim Sim;
+
+/* Exported functions --------------------------------------------------------*/
+
+void LCD_simReset(bool);
+void LCD_simPowerCycle(uint8_t);
+void LCD_simAdvance(uint64_t);
+void LCD_simZero(void);
+uint8_t LCD_simCell(uint8_t, uint8_t, uint8_t);
+void LCD_simRow(uint8_t, uint8_t, char *);
+uint32_t LCD_simShadowMismatches(uint8_t);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* LCD_SIM_H */
+
+/***************************************************************END OF FILE****/
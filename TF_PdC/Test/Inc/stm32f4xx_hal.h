@@ -0,0 +1,198 @@
+/*******************************************************************************
+* @file    stm32f4xx_hal.h
+* @author  Guillermo Caporaletti
+* @brief   HAL mínima para compilar el driver en la PC (ver LCD_sim.h).
+*          Sólo lo que usan "LCD_driver.c" y "LCD_stm32f4xx_nucleo.c": los
+*          puertos son memoria común, y el contador de ciclos, las esperas y
+*          la EXTI los lleva el modelo del display.
+********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+#define __IO	volatile
+#define __weak	__attribute__((weak))
+
+#define SystemCoreClock		180000000UL
+
+// GPIO
+#define GPIO_PIN_0		0x0001U
+#define GPIO_PIN_1		0x0002U
+#define GPIO_PIN_2		0x0004U
+#define GPIO_PIN_3		0x0008U
+#define GPIO_PIN_4		0x0010U
+#define GPIO_PIN_5		0x0020U
+#define GPIO_PIN_6		0x0040U
+#define GPIO_PIN_7		0x0080U
+#define GPIO_PIN_8		0x0100U
+#define GPIO_PIN_9		0x0200U
+#define GPIO_PIN_10		0x0400U
+#define GPIO_PIN_11		0x0800U
+#define GPIO_PIN_12		0x1000U
+#define GPIO_PIN_13		0x2000U
+#define GPIO_PIN_14		0x4000U
+#define GPIO_PIN_15		0x8000U
+
+#define GPIO_MODE_INPUT			0x00000000U
+#define GPIO_MODE_OUTPUT_PP		0x00000001U
+#define GPIO_MODE_OUTPUT_OD		0x00000011U
+#define GPIO_MODE_AF_PP			0x00000002U
+#define GPIO_MODE_IT_FALLING	0x10210000U
+#define GPIO_NOPULL				0U
+#define GPIO_PULLUP				1U
+#define GPIO_SPEED_FAST			2U
+#define GPIO_SPEED_FREQ_VERY_HIGH	3U
+#define GPIO_AF12_FMC			12U
+
+#define GPIOA	(&LCD_simGPIO[0])
+#define GPIOB	(&LCD_simGPIO[1])
+#define GPIOC	(&LCD_simGPIO[2])
+#define GPIOD	(&LCD_simGPIO[3])
+#define GPIOE	(&LCD_simGPIO[4])
+#define GPIOF	(&LCD_simGPIO[5])
+#define GPIOG	(&LCD_simGPIO[6])
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()	do {} while (0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()	do {} while (0)
+#define __HAL_RCC_GPIOE_CLK_ENABLE()	do {} while (0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()	do {} while (0)
+#define __HAL_RCC_GPIOG_CLK_ENABLE()	do {} while (0)
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()	do {} while (0)
+#define __HAL_RCC_FMC_CLK_ENABLE()		do {} while (0)
+
+#define POSITION_VAL(v)		((uint32_t) __builtin_ctz(v))
+
+// Núcleo: DWT, bit-band, interrupciones y barreras
+#define PERIPH_BASE		0x40000000UL
+#define PERIPH_BB_BASE	0x42000000UL
+
+#define DWT			(LCD_simDWT())
+#define SysTick		(LCD_simSysTick())
+#define CoreDebug	(&LCD_simCoreDebug)
+#define CoreDebug_DEMCR_TRCENA_Msk	(1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk		1UL
+
+#define EXTI15_10_IRQn	40
+#define EXTI		(&LCD_simEXTI)
+#define __HAL_GPIO_EXTI_GET_IT(x)	(LCD_simEXTI.PR & (x))
+#define __HAL_GPIO_EXTI_CLEAR_IT(x)	do { LCD_simEXTI.PR &= ~(uint32_t) (x); } while (0)
+
+#define __disable_irq()		LCD_simIrq(false)
+#define __enable_irq()		LCD_simIrq(true)
+#define __get_PRIMASK()		((uint32_t) !LCD_simIrqOn())
+#define __set_PRIMASK(x)	LCD_simIrq((x) == 0)
+#define __WFI()				LCD_simWfi()
+#define __DMB()				__sync_synchronize()
+#define __DSB()				__sync_synchronize()
+
+// FMC (banco 1, NOR/SRAM)
+#define FMC_NORSRAM_DEVICE				(&LCD_simFMC)
+#define FMC_NORSRAM_BANK1				0U
+#define FMC_DATA_ADDRESS_MUX_DISABLE	0U
+#define FMC_MEMORY_TYPE_SRAM			0U
+#define FMC_NORSRAM_MEM_BUS_WIDTH_8		0U
+#define FMC_BURST_ACCESS_MODE_DISABLE	0U
+#define FMC_WAIT_SIGNAL_POLARITY_LOW	0U
+#define FMC_WRAP_MODE_DISABLE			0U
+#define FMC_WAIT_TIMING_BEFORE_WS		0U
+#define FMC_WRITE_OPERATION_ENABLE		0x1000U
+#define FMC_WAIT_SIGNAL_DISABLE			0U
+#define FMC_EXTENDED_MODE_DISABLE		0U
+#define FMC_ASYNCHRONOUS_WAIT_DISABLE	0U
+#define FMC_WRITE_BURST_DISABLE			0U
+#define FMC_CONTINUOUS_CLOCK_SYNC_ONLY	0U
+#define FMC_ACCESS_MODE_A				0U
+#define __FMC_NORSRAM_ENABLE(d, b)		((d)->BTCR[(b)] |= 1U)
+#define LCD_FMC_BASE					((uintptr_t) LCD_simFMCBank)	// <-- El banco, memoria común
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef struct {
+	__IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+} GPIO_TypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+	uint32_t Pin, Mode, Pull, Speed, Alternate;
+} GPIO_InitTypeDef;
+
+typedef struct {
+	__IO uint32_t CTRL, CYCCNT, LAR;
+} DWT_Type;
+
+typedef struct {
+	__IO uint32_t CTRL, LOAD, VAL, CALIB;
+} SysTick_Type;
+
+typedef struct {
+	__IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+	__IO uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR;
+} EXTI_TypeDef;
+
+typedef int IRQn_Type;
+
+typedef struct {
+	uint32_t NSBank, DataAddressMux, MemoryType, MemoryDataWidth, BurstAccessMode,
+		WaitSignalPolarity, WrapMode, WaitSignalActive, WriteOperation, WaitSignal,
+		ExtendedMode, AsynchronousWait, WriteBurst, ContinuousClock, WriteFifo, PageSize;
+} FMC_NORSRAM_InitTypeDef;
+
+typedef struct {
+	uint32_t AddressSetupTime, AddressHoldTime, DataSetupTime, BusTurnAroundDuration,
+		CLKDivision, DataLatency, AccessMode;
+} FMC_NORSRAM_TimingTypeDef;
+
+typedef struct {
+	uint32_t BTCR[8];
+} FMC_Bank1_TypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+
+extern GPIO_TypeDef LCD_simGPIO[7];
+extern CoreDebug_Type LCD_simCoreDebug;
+extern EXTI_TypeDef LCD_simEXTI;
+extern FMC_Bank1_TypeDef LCD_simFMC;
+extern volatile uint8_t LCD_simFMCBank[4];
+
+/* Exported functions --------------------------------------------------------*/
+
+void HAL_GPIO_Init(GPIO_TypeDef *, GPIO_InitTypeDef *);
+void HAL_GPIO_WritePin(GPIO_TypeDef *, uint16_t, GPIO_PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *, uint16_t);
+void HAL_GPIO_EXTI_IRQHandler(uint16_t);
+void HAL_Delay(uint32_t);
+uint32_t HAL_GetTick(void);
+void HAL_NVIC_SetPriority(IRQn_Type, uint32_t, uint32_t);
+void HAL_NVIC_EnableIRQ(IRQn_Type);
+void HAL_NVIC_DisableIRQ(IRQn_Type);
+void FMC_NORSRAM_Init(FMC_Bank1_TypeDef *, FMC_NORSRAM_InitTypeDef *);
+void FMC_NORSRAM_Timing_Init(FMC_Bank1_TypeDef *, FMC_NORSRAM_TimingTypeDef *, uint32_t);
+
+DWT_Type * LCD_simDWT(void);
+SysTick_Type * LCD_simSysTick(void);
+void LCD_simIrq(_Bool);
+_Bool LCD_simIrqOn(void);
+void LCD_simWfi(void);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* STM32F4XX_HAL_H */
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,32 @@
+/*******************************************************************************
+* @file    stm32f4xx_nucleo_144.h
+* @author  Guillermo Caporaletti
+* @brief   BSP mínimo para compilar en la PC: los LEDs no hacen nada.
+********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F4XX_NUCLEO_144_H
+#define STM32F4XX_NUCLEO_144_H
+
+/* Types ---------------------------------------------------------------------*/
+
+typedef enum {
+	LED1 = 0,
+	LED2 = 1,
+	LED3 = 2
+} Led_TypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+
+void BSP_LED_Init(Led_TypeDef);
+void BSP_LED_On(Led_TypeDef);
+void BSP_LED_Off(Led_TypeDef);
+void BSP_LED_Toggle(Led_TypeDef);
+
+/* ---------------------------------------------------------------------------*/
+
+#endif /* STM32F4XX_NUCLEO_144_H */
+
+/***************************************************************END OF FILE****/
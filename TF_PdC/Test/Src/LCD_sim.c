@@ -0,0 +1,566 @@
+/*******************************************************************************
+* @file    LCD_sim.c
+* @author  Guillermo Caporaletti
+* @brief   Modelo del HD44780 para probar el driver en la PC.
+*          Reemplaza a la HAL: los pines son memoria y cada flanco de un
+*          ENABLE (D8 para el display 0, D11 a D13 para los demás) le llega al
+*          controlador correspondiente, que interpreta RS, RW y el bus de
+*          datos como el de verdad (8 o 4 bits, DDRAM, CGRAM, AC, I/D, S,
+*          desplazamiento). El tiempo avanza con cada acceso a un pin y con
+*          cada lectura del contador de ciclos; con busy_model, BF queda alto
+*          mientras la instrucción se ejecuta y su flanco de bajada dispara la
+*          EXTI de DB7 si está armada. Con LCD_FMC, el banco del FMC es
+*          memoria común y cada acceso le llega al display 0.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <LCD_sim.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define PIN(p, m)	(((p)->ODR & (m)) != 0)
+
+/* Exported variables --------------------------------------------------------*/
+
+LCDsim Sim;
+GPIO_TypeDef LCD_simGPIO[7];
+CoreDebug_Type LCD_simCoreDebug;
+EXTI_TypeDef LCD_simEXTI;
+FMC_Bank1_TypeDef LCD_simFMC;
+volatile uint8_t LCD_simFMCBank[4];		// <-- Región del banco 1 (RS en A0, RW en A1)
+
+/* Private variables ---------------------------------------------------------*/
+
+static DWT_Type Dwt;
+static bool En_interrupcion = false;
+static bool Hay_enable = false;		// <-- Algún ENABLE arriba (sólo entonces BF llega a DB7)
+static uint32_t Paso_dwt = LCD_SIM_DWT_STEP;
+
+static GPIO_TypeDef * const Datos_port[8] = {
+	ARDUINO_D0_port, ARDUINO_D1_port, ARDUINO_D2_port, ARDUINO_D3_port,
+	ARDUINO_D4_port, ARDUINO_D5_port, ARDUINO_D6_port, ARDUINO_D7_port
+};
+static const uint16_t Datos_pin[8] = {
+	ARDUINO_D0_pin, ARDUINO_D1_pin, ARDUINO_D2_pin, ARDUINO_D3_pin,
+	ARDUINO_D4_pin, ARDUINO_D5_pin, ARDUINO_D6_pin, ARDUINO_D7_pin
+};
+static GPIO_TypeDef * const Enable_port[LCD_MAX_DISPLAYS] = {
+	ARDUINO_D8_port, ARDUINO_D11_port, ARDUINO_D12_port, ARDUINO_D13_port
+};
+static const uint16_t Enable_pin[LCD_MAX_DISPLAYS] = {
+	ARDUINO_D8_pin, ARDUINO_D11_pin, ARDUINO_D12_pin, ARDUINO_D13_pin
+};
+
+/* Private function prototypes -----------------------------------------------*/
+
+void EXTI15_10_IRQHandler(void);		// <-- La del driver ("LCD_stm32f4xx_nucleo.c")
+
+static void LCD_sim_enable(LCDsimDisplay * d, bool Subida);
+static void LCD_sim_command(LCDsimDisplay * d, uint8_t v);
+static void LCD_sim_data(LCDsimDisplay * d, uint8_t v);
+static uint8_t LCD_sim_read(LCDsimDisplay * d, bool Datos);
+static void LCD_sim_drive(uint8_t v, uint8_t Bits);
+static uint8_t LCD_sim_next(const LCDsimDisplay * d, uint8_t a, bool Incremento);
+static void LCD_sim_move(LCDsimDisplay * d);
+static void LCD_sim_busy_check(void);
+static void LCD_sim_irq(void);
+static void LCD_sim_tick(uint64_t Ciclos);
+static void LCD_sim_fmc_access(volatile uint8_t * Banco, uint8_t Direccion);
+
+/* Functions -----------------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Deja todo como al encender: displays en 8 bits, pines en 0
+* @param  true si sólo están conectados DB4-DB7 (bus de 4 bits)
+* @retval None
+*/
+void LCD_simReset(bool Cuatro_hilos) {
+	memset(&Sim, 0, sizeof(Sim));
+	memset(LCD_simGPIO, 0, sizeof(LCD_simGPIO));
+	memset(&LCD_simEXTI, 0, sizeof(LCD_simEXTI));
+	memset(&LCD_simFMC, 0, sizeof(LCD_simFMC));
+	memset((void *) LCD_simFMCBank, 0, sizeof(LCD_simFMCBank));
+	Hay_enable = false;
+	Sim.four_wires = Cuatro_hilos;
+	Sim.irq_on = true;
+	for (uint8_t d=0; d<LCD_MAX_DISPLAYS; d++) LCD_simPowerCycle(d);
+}
+
+/*******************************************************************************
+* @brief  Corta y vuelve la alimentación de un display (reinicio interno)
+* @param  Display
+* @retval None
+* @note   Queda en 8 bits, 1 línea, apagado, borrado y con el AC en 0.
+*/
+void LCD_simPowerCycle(uint8_t Display) {
+	LCDsimDisplay * d = &Sim.display[Display];
+	memset(d, 0, sizeof(*d));
+	memset(d->ddram, ' ', sizeof(d->ddram));
+	d->increment = true;
+	d->eight_bits = true;
+}
+
+/*******************************************************************************
+* @brief  Avanza el tiempo sin tocar el bus
+* @param  Ciclos
+* @retval None
+*/
+void LCD_simAdvance(uint64_t Ciclos) {
+	LCD_sim_tick(Ciclos);
+}
+
+/*******************************************************************************
+* @brief  Pone en cero los contadores de todos los displays
+* @param  None
+* @retval None
+*/
+void LCD_simZero(void) {
+	Sim.gpio_writes = Sim.gpio_reads = Sim.pin_modes = Sim.irqs = Sim.wfis = 0;
+	for (uint8_t k=0; k<LCD_MAX_DISPLAYS; k++) {
+		LCDsimDisplay * d = &Sim.display[k];
+		d->pulses = d->commands = d->data = d->set_address = d->reads = 0;
+		d->clears = d->homes = d->control_commands = d->mode_commands = 0;
+	}
+}
+
+/*******************************************************************************
+* @brief  Lo que se ve en una posición de la pantalla de un display
+* @param  Display, columna y fila
+* @retval Caracter, o ' ' con el display apagado
+* @note   Filas 2 y 3 a continuación de las 0 y 1 (LCD_columns() más allá),
+*         con el desplazamiento del display.
+*/
+uint8_t LCD_simCell(uint8_t Display, uint8_t col, uint8_t row) {
+	const LCDsimDisplay * d = &Sim.display[Display];
+	if ((d->control & LCD_DISPLAYON) == 0) return ' ';
+
+	uint16_t Largo = d->two_lines ? 40 : 80;
+	uint16_t Base = (d->two_lines && (row & 1)) ? 0x40 : 0x00;
+	int32_t Posicion = (int32_t) col + ((row >= 2) ? LCD_columns() : 0) + d->shift;
+	Posicion %= Largo;
+	if (Posicion < 0) Posicion += Largo;
+	return d->ddram[Base + Posicion];
+}
+
+/*******************************************************************************
+* @brief  Copia una fila de la pantalla, como texto
+* @param  Display, fila y destino (LCD_columns() + 1 lugares)
+* @retval None
+*/
+void LCD_simRow(uint8_t Display, uint8_t row, char * Texto) {
+	uint8_t c;
+	for (c=0; c<LCD_columns(); c++) Texto[c] = (char) LCD_simCell(Display, c, row);
+	Texto[c] = '\0';
+}
+
+/*******************************************************************************
+* @brief  Compara la DDRAM de un display con la sombra del driver
+* @param  Display
+* @retval Cantidad de celdas distintas
+*/
+uint32_t LCD_simShadowMismatches(uint8_t Display) {
+	uint32_t Distintas = 0;
+	for (uint8_t a=0; a<LCD_DDRAM_SIZE; a++) {
+		if (Sim.display[Display].two_lines && (a & 0x3F) >= 40) continue;
+		if (!Sim.display[Display].two_lines && a >= 80) continue;
+		if (LCD_shadowOf(Display, a) != Sim.display[Display].ddram[a]) Distintas++;
+	}
+	return Distintas;
+}
+
+/* HAL ------------------------------------------------------------------------*/
+
+void HAL_GPIO_Init(GPIO_TypeDef * Puerto, GPIO_InitTypeDef * Init) {
+	(void) Puerto;
+	Sim.pin_modes++;
+	if (Init->Mode == GPIO_MODE_IT_FALLING) {
+		Sim.exti_inits++;
+		LCD_simEXTI.IMR |= Init->Pin;
+		LCD_simEXTI.FTSR |= Init->Pin;
+	}
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef * Puerto, uint16_t Pin, GPIO_PinState Estado) {
+	uint32_t Antes = Puerto->ODR;
+
+	Sim.gpio_writes++;
+	Paso_dwt = LCD_SIM_DWT_STEP;
+	LCD_sim_tick(LCD_SIM_GPIO_CYCLES);
+	if (Estado == GPIO_PIN_SET) Puerto->ODR |= Pin;
+	else Puerto->ODR &= ~(uint32_t) Pin;
+
+	// Un flanco de algún ENABLE le llega a su display
+	for (uint8_t k=0; k<LCD_MAX_DISPLAYS; k++) {
+		if (Puerto == Enable_port[k] && (Pin & Enable_pin[k]) && ((Antes ^ Puerto->ODR) & Enable_pin[k])) {
+			LCD_sim_enable(&Sim.display[k], Estado == GPIO_PIN_SET);
+		}
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef * Puerto, uint16_t Pin) {
+	Sim.gpio_reads++;
+	Paso_dwt = LCD_SIM_DWT_STEP;
+	LCD_sim_tick(LCD_SIM_GPIO_CYCLES);
+	return (Puerto->IDR & Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_Delay(uint32_t ms) {
+	LCD_sim_tick((uint64_t) ms * 1000UL * LCD_CYCLES_PER_US);
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t) (Sim.cycles / (1000UL * LCD_CYCLES_PER_US));
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t Prioridad, uint32_t Sub) {
+	(void) IRQn; (void) Prioridad; (void) Sub;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+	(void) IRQn;
+	Sim.nvic_enabled = true;
+	LCD_sim_irq();
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+	(void) IRQn;
+	Sim.nvic_enabled = false;
+}
+
+void FMC_NORSRAM_Init(FMC_Bank1_TypeDef * Dispositivo, FMC_NORSRAM_InitTypeDef * Init) {
+	(void) Dispositivo; (void) Init;
+}
+
+void FMC_NORSRAM_Timing_Init(FMC_Bank1_TypeDef * Dispositivo, FMC_NORSRAM_TimingTypeDef * Tiempos, uint32_t Banco) {
+	// Como en FMC_BTRx: ADDSET, ADDHLD, DATAST y BUSTURN
+	Dispositivo->BTCR[Banco + 1] = (Tiempos->AddressSetupTime & 0x0F) | ((Tiempos->AddressHoldTime & 0x0F) << 4)
+		| ((Tiempos->DataSetupTime & 0xFF) << 8) | ((Tiempos->BusTurnAroundDuration & 0x0F) << 16);
+}
+
+/* Banco del FMC ---------------------------------------------------------------*/
+
+// Reemplazan a las de "LCD_stm32f4xx_nucleo.c": en la PC el banco es memoria
+// común, y cada acceso, además de quedar en ella, le llega al display 0
+// como un pulso de E (8 bits, RS en A0) que dura lo que programó el FMC.
+
+void fmcWrite(volatile uint8_t * Banco, uint8_t Direccion, uint8_t Valor) {
+	LCD_sim_fmc_access(Banco, Direccion);
+	if (Direccion & LCD_FMC_RW) Error_Handler();
+	Banco[Direccion] = Valor;
+	Sim.fmc_writes++;
+
+	LCDsimDisplay * d = &Sim.display[0];
+	d->pulses++;
+	if (!d->eight_bits) Error_Handler();	// <-- El FMC no maneja 4 bits
+	if (Direccion & LCD_FMC_RS) LCD_sim_data(d, Valor);
+	else LCD_sim_command(d, Valor);
+}
+
+uint8_t fmcRead(volatile uint8_t * Banco, uint8_t Direccion) {
+	LCD_sim_fmc_access(Banco, Direccion);
+	if ((Direccion & LCD_FMC_RW) == 0) Error_Handler();
+	Sim.fmc_reads++;
+
+	LCDsimDisplay * d = &Sim.display[0];
+	bool Datos = (Direccion & LCD_FMC_RS) != 0;
+	Banco[Direccion] = LCD_sim_read(d, Datos);
+	d->reads++;
+	if (Datos) LCD_sim_move(d);
+	return Banco[Direccion];
+}
+
+DWT_Type * LCD_simDWT(void) {
+	// Cada lectura del contador también lleva tiempo; en una espera (lecturas
+	// seguidas, sin tocar pines) el paso crece, para no dar miles de vueltas
+	LCD_sim_tick(Paso_dwt);
+	if (Paso_dwt < LCD_SIM_DWT_MAX_STEP) Paso_dwt *= 2;
+	return &Dwt;
+}
+
+SysTick_Type * LCD_simSysTick(void) {
+	// Cuenta hacia abajo, con HCLK, hasta el próximo milisegundo
+	static SysTick_Type Tick;
+	uint64_t Milisegundo = 1000UL * LCD_CYCLES_PER_US;
+	Tick.LOAD = (uint32_t) (Milisegundo - 1);
+	Tick.VAL = (uint32_t) (Milisegundo - Sim.cycles % Milisegundo);
+	return &Tick;
+}
+
+void LCD_simIrq(bool Habilitadas) {
+	Sim.irq_on = Habilitadas;
+	LCD_sim_irq();
+}
+
+bool LCD_simIrqOn(void) {
+	return Sim.irq_on;
+}
+
+void LCD_simWfi(void) {
+	// Duermo hasta que termine la instrucción en curso (la EXTI de BF), o
+	// hasta el próximo SysTick (cada 1 ms), lo que llegue antes
+	uint64_t Milisegundo = 1000UL * LCD_CYCLES_PER_US;
+	uint64_t Hasta = (Sim.cycles / Milisegundo + 1) * Milisegundo;
+	for (uint8_t k=0; k<LCD_MAX_DISPLAYS; k++) {
+		if (Sim.display[k].busy_until > Sim.cycles && Sim.display[k].busy_until < Hasta) Hasta = Sim.display[k].busy_until;
+	}
+	Sim.wfis++;
+	LCD_sim_tick(Hasta - Sim.cycles);
+}
+
+/* BSP y errores ---------------------------------------------------------------*/
+
+void BSP_LED_Init(Led_TypeDef Led) { (void) Led; }
+void BSP_LED_On(Led_TypeDef Led) { (void) Led; }
+void BSP_LED_Off(Led_TypeDef Led) { (void) Led; }
+void BSP_LED_Toggle(Led_TypeDef Led) { (void) Led; }
+
+void Error_Handler(void) {
+	fprintf(stderr, "Error_Handler\n");
+	abort();
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Revisa un acceso al banco del FMC y avanza lo que dura
+* @param  Banco y dirección
+* @retval None
+* @note   El banco tiene que ser la región que el driver recibió de
+*         LCD_FMC_BASE, habilitada, y el acceso dura ADDSET + DATAST +
+*         BUSTURN ciclos de HCLK (el reloj del núcleo).
+*/
+static void LCD_sim_fmc_access(volatile uint8_t * Banco, uint8_t Direccion) {
+	uint32_t Tiempos = LCD_simFMC.BTCR[FMC_NORSRAM_BANK1 + 1];
+
+	if (Banco != LCD_simFMCBank || Direccion >= sizeof(LCD_simFMCBank)) Error_Handler();
+	if ((LCD_simFMC.BTCR[FMC_NORSRAM_BANK1] & 1U) == 0) Error_Handler();
+	Paso_dwt = LCD_SIM_DWT_STEP;
+	LCD_sim_tick((Tiempos & 0x0F) + ((Tiempos >> 8) & 0xFF) + ((Tiempos >> 16) & 0x0F));
+}
+
+/*******************************************************************************
+* @brief  Flanco de ENABLE: lectura al subir, escritura al bajar
+* @param  Display y sentido del flanco
+* @retval None
+*/
+static void LCD_sim_enable(LCDsimDisplay * d, bool Subida) {
+	bool Datos = PIN(ARDUINO_D10_port, ARDUINO_D10_pin);
+	bool Lectura = PIN(ARDUINO_D9_port, ARDUINO_D9_pin);
+	bool Ocho = d->eight_bits && !Sim.four_wires;
+
+	d->enable = Subida;
+	Hay_enable = false;
+	for (uint8_t k=0; k<LCD_MAX_DISPLAYS; k++) Hay_enable |= Sim.display[k].enable;
+	d->reading_ir = Lectura && !Datos && (d->eight_bits || !d->read_half);
+
+	if (Lectura) {
+		if (Subida) {
+			if (d->eight_bits || !d->read_half) d->latch = LCD_sim_read(d, Datos);
+			if (Ocho) LCD_sim_drive(d->latch, 8);
+			else if (d->eight_bits || !d->read_half) LCD_sim_drive(d->latch >> 4, 4);
+			else LCD_sim_drive(d->latch & 0x0F, 4);
+		} else if (d->eight_bits || d->read_half) {
+			d->reads++;
+			if (Datos) LCD_sim_move(d);
+			d->read_half = false;
+		} else {
+			d->read_half = true;
+		}
+		return;
+	}
+	if (Subida) return;
+
+	// Pulso perdido (por ejemplo, con tiempos demasiado cortos)
+	if (Sim.drop > 0 && Sim.cycles < d->busy_until) {
+		Sim.drop--;
+		return;
+	}
+
+	d->pulses++;
+	uint8_t v = 0;
+	if (Ocho) {
+		for (uint8_t i=0; i<8; i++) v |= (uint8_t) (PIN(Datos_port[i], Datos_pin[i]) << i);
+	} else {
+		uint8_t Nibble = 0;
+		for (uint8_t i=0; i<4; i++) Nibble |= (uint8_t) (PIN(Datos_port[i], Datos_pin[i]) << i);
+		if (d->eight_bits) {
+			v = (uint8_t) (Nibble << 4);	// <-- En 8 bits con 4 hilos, DB0-DB3 quedan en 0
+		} else if (!d->half) {
+			d->high = Nibble;
+			d->half = true;
+			return;
+		} else {
+			d->half = false;
+			v = (uint8_t) ((d->high << 4) | Nibble);
+		}
+	}
+	if (Datos) LCD_sim_data(d, v);
+	else LCD_sim_command(d, v);
+}
+
+/*******************************************************************************
+* @brief  Ejecuta una instrucción
+* @param  Display e instrucción
+* @retval None
+*/
+static void LCD_sim_command(LCDsimDisplay * d, uint8_t v) {
+	d->commands++;
+	d->busy_until = Sim.cycles + (((v & 0xFC) == 0) ? LCD_SIM_CLEAR_CYCLES : LCD_SIM_EXEC_CYCLES);
+
+	if (v & LCD_SETDDRAMADDR) {
+		d->ac = v & 0x7F;
+		d->cgram_selected = false;
+		d->set_address++;
+	} else if (v & LCD_SETCGRAMADDR) {
+		d->ac = v & 0x3F;
+		d->cgram_selected = true;
+		d->set_address++;
+	} else if (v & LCD_FUNCTIONSET) {
+		d->eight_bits = (v & LCD_8BITMODE) != 0;
+		d->two_lines = (v & LCD_2LINE) != 0;
+		d->half = d->read_half = false;
+	} else if (v & LCD_CURSORSHIFT) {
+		bool Derecha = (v & LCD_MOVERIGHT) != 0;
+		if (v & LCD_DISPLAYMOVE) {
+			d->shift += Derecha ? -1 : 1;
+		} else if (d->cgram_selected) {
+			d->ac = (uint8_t) ((d->ac + (Derecha ? 1 : -1)) & 0x3F);
+		} else {
+			d->ac = LCD_sim_next(d, d->ac, Derecha);
+		}
+	} else if (v & LCD_DISPLAYCONTROL) {
+		d->control = v & 0x07;
+		d->control_commands++;
+	} else if (v & LCD_ENTRYMODESET) {
+		d->increment = (v & LCD_ENTRYLEFT) != 0;
+		d->display_shift = (v & LCD_ENTRYSHIFTINCREMENT) != 0;
+		d->mode_commands++;
+	} else if (v & LCD_RETURNHOME) {
+		d->ac = 0;
+		d->cgram_selected = false;
+		d->shift = 0;
+		d->homes++;
+	} else if (v & LCD_CLEARDISPLAY) {
+		memset(d->ddram, ' ', sizeof(d->ddram));
+		d->ac = 0;
+		d->cgram_selected = false;
+		d->increment = true;
+		d->shift = 0;
+		d->clears++;
+	}
+}
+
+/*******************************************************************************
+* @brief  Escribe un dato en la RAM que apunta el AC
+* @param  Display y dato
+* @retval None
+*/
+static void LCD_sim_data(LCDsimDisplay * d, uint8_t v) {
+	d->data++;
+	d->busy_until = Sim.cycles + LCD_SIM_EXEC_CYCLES;
+	if (d->cgram_selected) d->cgram[d->ac & 0x3F] = v;
+	else d->ddram[d->ac & 0x7F] = v;
+	LCD_sim_move(d);
+	if (d->display_shift && !d->cgram_selected) d->shift += d->increment ? 1 : -1;
+}
+
+/*******************************************************************************
+* @brief  Lee el registro de instrucción (BF y AC) o la RAM
+* @param  Display, true para la RAM
+* @retval Byte leído
+*/
+static uint8_t LCD_sim_read(LCDsimDisplay * d, bool Datos) {
+	if (!Datos) {
+		bool Ocupado = Sim.busy_model && Sim.cycles < d->busy_until;
+		return (uint8_t) ((d->ac & 0x7F) | (Ocupado ? 0x80 : 0));
+	}
+	return d->cgram_selected ? d->cgram[d->ac & 0x3F] : d->ddram[d->ac & 0x7F];
+}
+
+/*******************************************************************************
+* @brief  Pone un valor en los pines de datos (lo que maneja el display)
+* @param  Valor y cantidad de bits (desde D0)
+* @retval None
+*/
+static void LCD_sim_drive(uint8_t v, uint8_t Bits) {
+	for (uint8_t i=0; i<Bits; i++) {
+		if ((v >> i) & 1U) Datos_port[i]->IDR |= Datos_pin[i];
+		else Datos_port[i]->IDR &= ~(uint32_t) Datos_pin[i];
+	}
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM siguiente o anterior, según N
+* @param  Display, dirección y sentido
+* @retval Dirección
+*/
+static uint8_t LCD_sim_next(const LCDsimDisplay * d, uint8_t a, bool Incremento) {
+	if (d->two_lines) {
+		if (Incremento) return (a == 0x27) ? 0x40 : (a == 0x67) ? 0x00 : (uint8_t) (a + 1);
+		return (a == 0x40) ? 0x27 : (a == 0x00) ? 0x67 : (uint8_t) (a - 1);
+	}
+	if (Incremento) return (a == 0x4F) ? 0x00 : (uint8_t) (a + 1);
+	return (a == 0x00) ? 0x4F : (uint8_t) (a - 1);
+}
+
+/*******************************************************************************
+* @brief  Mueve el AC tras escribir o leer la RAM
+* @param  Display
+* @retval None
+*/
+static void LCD_sim_move(LCDsimDisplay * d) {
+	if (d->cgram_selected) d->ac = (uint8_t) ((d->ac + (d->increment ? 1 : -1)) & 0x3F);
+	else d->ac = LCD_sim_next(d, d->ac, d->increment);
+}
+
+/*******************************************************************************
+* @brief  Baja DB7 cuando termina la instrucción, si se está leyendo BF
+* @param  None
+* @retval None
+* @note   Con ENABLE arriba leyendo el registro de instrucción, DB7 sigue a
+*         BF: su flanco de bajada marca la línea EXTI si está armada.
+*/
+static void LCD_sim_busy_check(void) {
+	if (!Sim.busy_model || !Hay_enable) return;
+	for (uint8_t k=0; k<LCD_MAX_DISPLAYS; k++) {
+		LCDsimDisplay * d = &Sim.display[k];
+		if (!d->enable || !d->reading_ir || Sim.cycles < d->busy_until) continue;
+
+		uint8_t b = (d->eight_bits && !Sim.four_wires) ? 7 : 3;
+		if ((Datos_port[b]->IDR & Datos_pin[b]) == 0) continue;
+		Datos_port[b]->IDR &= ~(uint32_t) Datos_pin[b];
+		d->latch &= 0x7F;
+		if (LCD_simEXTI.FTSR & Datos_pin[b]) LCD_simEXTI.PR |= Datos_pin[b];
+	}
+	LCD_sim_irq();
+}
+
+/*******************************************************************************
+* @brief  Atiende la EXTI pendiente, si está habilitada
+* @param  None
+* @retval None
+*/
+static void LCD_sim_irq(void) {
+	if (LCD_simEXTI.PR == 0 || En_interrupcion || !Sim.irq_on || !Sim.nvic_enabled) return;
+	if ((LCD_simEXTI.PR & LCD_simEXTI.IMR) == 0) return;
+	En_interrupcion = true;
+	Sim.irqs++;
+	EXTI15_10_IRQHandler();
+	En_interrupcion = false;
+}
+
+/*******************************************************************************
+* @brief  Avanza el tiempo
+* @param  Ciclos
+* @retval None
+*/
+static void LCD_sim_tick(uint64_t Ciclos) {
+	Sim.cycles += Ciclos;
+	Dwt.CYCCNT += (uint32_t) Ciclos;
+	LCD_sim_busy_check();
+}
+
+/***************************************************************END OF FILE****/
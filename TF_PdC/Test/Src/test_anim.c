@@ -0,0 +1,102 @@
+/*******************************************************************************
+* @file    test_anim.c
+* @author  Guillermo Caporaletti
+* @brief   La ruedita de "main.c" (LCD_anim) durante 3 s de ticks, contra el
+*          modelo del HD44780: al terminar cada cuadro, la CGRAM del display
+*          tiene que ser la que resulta de aplicar los cambios de todos los
+*          cuadros hasta ahí, y el caracter tiene que estar en su lugar. Mide
+*          además la llamada más larga a LCD_animUpdate() (el primer cuadro),
+*          que no debe pasar de LCD_ANIM_BUDGET cambios de una fila cada uno.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_anim.h>
+#include <LCD_wcet.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define DURACION_MS		3000
+#define RUEDITA_MS		150
+
+/* Private variables ---------------------------------------------------------*/
+
+// Lo mismo que anima "main.c"
+static const LCDanimRow Ruedita_barra[] = {
+	{0x08, 0x00}, {0x09, 0x04}, {0x0A, 0x04}, {0x0B, 0x04},
+	{0x0C, 0x04}, {0x0D, 0x04}, {0x0E, 0x00}, {0x0F, 0x00}
+};
+static const LCDanimCell Ruedita_lugar[] = {{14, 1, 1}};
+static const LCDanimRow Ruedita_a_diagonal[] = {
+	{0x09, 0x01}, {0x0A, 0x02}, {0x0C, 0x08}, {0x0D, 0x10}
+};
+static const LCDanimRow Ruedita_a_guion[] = {
+	{0x09, 0x00}, {0x0A, 0x00}, {0x0B, 0x1F}, {0x0C, 0x00}, {0x0D, 0x00}
+};
+static const LCDanimRow Ruedita_a_contrabarra[] = {
+	{0x09, 0x10}, {0x0A, 0x08}, {0x0B, 0x04}, {0x0C, 0x02}, {0x0D, 0x01}
+};
+static const LCDanimRow Ruedita_a_barra[] = {
+	{0x09, 0x04}, {0x0A, 0x04}, {0x0C, 0x04}, {0x0D, 0x04}
+};
+static const LCDanimFrame Ruedita_cuadros[] = {
+	{RUEDITA_MS, Ruedita_barra, LCD_ANIM_COUNT(Ruedita_barra), Ruedita_lugar, LCD_ANIM_COUNT(Ruedita_lugar)},
+	{RUEDITA_MS, Ruedita_a_diagonal, LCD_ANIM_COUNT(Ruedita_a_diagonal), NULL, 0},
+	{RUEDITA_MS, Ruedita_a_guion, LCD_ANIM_COUNT(Ruedita_a_guion), NULL, 0},
+	{RUEDITA_MS, Ruedita_a_contrabarra, LCD_ANIM_COUNT(Ruedita_a_contrabarra), NULL, 0},
+	{RUEDITA_MS, Ruedita_a_barra, LCD_ANIM_COUNT(Ruedita_a_barra), NULL, 0}
+};
+static const LCDanimation Ruedita = {Ruedita_cuadros, 5, 1};
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCDanimPlayer ruedita;
+	uint8_t Esperada[64];
+	uint32_t Cuadros = 0, Fallas = 0, Peor = 0;
+	uint16_t Ultimo = 0xFFFF;		// Último cuadro comprobado
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	memcpy(Esperada, Sim.display[0].cgram, sizeof(Esperada));
+
+	// Cota: LCD_ANIM_BUDGET filas de CGRAM, con el perfil en uso
+	const LCDtiming * Perfil = LCD_getTiming();
+	uint32_t Cota = (LCD_ANIM_BUDGET * LCD_WCET_K_GLYPHROW *
+		LCD_WCET_OP_NS(Perfil->exec_us, Perfil->cycle_ns, LCD_SIM_FOUR_WIRES) + 999UL) / 1000UL;
+
+	LCD_animStart(&ruedita, &Ruedita);
+	for (uint32_t ms=0; ms<DURACION_MS; ms++) {
+		uint64_t Inicio = Sim.cycles;
+		LCD_animUpdate(&ruedita);
+		uint32_t us = (uint32_t) ((Sim.cycles - Inicio) / LCD_CYCLES_PER_US);
+		if (us > Peor) Peor = us;
+
+		// Cuadro recién terminado: lo que debería haber en CGRAM
+		if (!ruedita.sending && ruedita.frame != Ultimo) {
+			const LCDanimFrame * Cuadro = &Ruedita.frames[ruedita.frame];
+			for (uint8_t i=0; i<Cuadro->row_count; i++) Esperada[Cuadro->rows[i].address & 0x3F] = Cuadro->rows[i].bits;
+			if (memcmp(Esperada, Sim.display[0].cgram, sizeof(Esperada)) != 0 || LCD_simCell(0, 14, 1) != 1) {
+				printf("anim: cuadro %u (%lu ms) distinto\n", ruedita.frame, (unsigned long) ms);
+				Fallas++;
+			}
+			Ultimo = ruedita.frame;
+			Cuadros++;
+		}
+
+		// Hasta el milisegundo siguiente
+		uint64_t Siguiente = (uint64_t) (ms + 1) * 1000UL * LCD_CYCLES_PER_US;
+		if (Sim.cycles < Siguiente) LCD_simAdvance(Siguiente - Sim.cycles);
+	}
+
+	if (Cuadros < DURACION_MS / RUEDITA_MS || Peor > Cota) Fallas++;
+	printf("anim %s: %lu cuadros en %u ms, llamada más larga %lu us (cota %lu us), %lu fallas\n",
+		LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Cuadros, DURACION_MS,
+		(unsigned long) Peor, (unsigned long) Cota, (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/***************************************************************END OF FILE****/
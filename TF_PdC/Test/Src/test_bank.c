@@ -0,0 +1,100 @@
+/*******************************************************************************
+* @file    test_bank.c
+* @author  Guillermo Caporaletti
+* @brief   Bancos de glifos (LCD_bank) contra el modelo del HD44780. Dos
+*          bancos de 4 glifos que comparten 2: la primera carga envía todo
+*          (aunque la CGRAM del display ya tenga esos puntos, al encender no
+*          se conoce), cambiar de banco envía sólo las filas distintas, y
+*          recargar el mismo banco no envía nada. Después de cada carga, la
+*          CGRAM del modelo tiene que tener los glifos del banco.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_bank.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static const LCDglyph A[] = {
+	LCD_GLYPH(0x11, 0x11, 0x0E, 0x15, 0x1F, 0x1F, 0x0E, 0x1B),
+	LCD_GLYPH(0x00, 0x04, 0x0E, 0x1F, 0x04, 0x04, 0x04, 0x00),
+	LCD_GLYPH(0x00, 0x04, 0x04, 0x04, 0x1F, 0x0E, 0x04, 0x00),
+	LCD_GLYPH(0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00)
+};
+static const LCDglyph B[] = {
+	LCD_GLYPH(0x11, 0x11, 0x0E, 0x15, 0x1F, 0x1F, 0x0E, 0x1B),
+	LCD_GLYPH(0x00, 0x04, 0x0E, 0x1F, 0x04, 0x04, 0x04, 0x00),
+	LCD_GLYPH(0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00),
+	LCD_GLYPH(0x10, 0x18, 0x1C, 0x1E, 0x1C, 0x18, 0x10, 0x00)
+};
+static const LCDglyphBank Banco_A = {A, 0, 4};
+static const LCDglyphBank Banco_B = {B, 0, 4};
+
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void cargar(const char * Nombre, const LCDglyphBank * Banco, uint32_t Esperadas, uint32_t Completas);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	uint8_t Filas[8];
+
+	// El empaquetado de 5 bytes vuelve a las mismas 8 filas
+	LCD_glyphUnpack(A[0], Filas);
+	if (memcmp(Filas, (const uint8_t[8]) {0x11, 0x11, 0x0E, 0x15, 0x1F, 0x1F, 0x0E, 0x1B}, 8) != 0) {
+		printf("bank: LCD_GLYPH/LCD_glyphUnpack no coinciden\n");
+		Fallas++;
+	}
+
+	// CGRAM con basura que coincide con el banco A: igual se envía todo
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	for (uint8_t g=0; g<4; g++) LCD_glyphUnpack(A[g], &Sim.display[0].cgram[g * 8]);
+	LCD_init();
+
+	cargar("A (al encender)", &Banco_A, 33, 36);	// Dirección y 32 filas
+	cargar("A -> B", &Banco_B, 15, 36);				// 13 filas en 2 tramos
+	cargar("B -> A", &Banco_A, 15, 36);
+	cargar("A -> A", &Banco_A, 0, 36);
+
+	if (LCD_bankFlashSaved(&Banco_A) != 12) Fallas++;
+	printf("bank %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Carga un banco y compara transferencias y CGRAM con lo esperado
+* @param  Nombre del paso, banco, transferencias esperadas y las de
+*         LCD_createChar() con cada glifo
+* @retval None
+*/
+static void cargar(const char * Nombre, const LCDglyphBank * Banco, uint32_t Esperadas, uint32_t Completas) {
+	LCDbankStats Antes = *LCD_bankStats();
+	LCD_simZero();
+
+	LCD_bankLoad(Banco);
+
+	const LCDbankStats * Despues = LCD_bankStats();
+	uint32_t Transferencias = Despues->transfers - Antes.transfers;
+	uint32_t Bus = Sim.display[0].commands + Sim.display[0].data;
+	bool Bien = (Transferencias == Esperadas && Bus == Esperadas &&
+		Despues->transfers_full - Antes.transfers_full == Completas);
+
+	for (uint8_t g=0; g<Banco->count; g++) {
+		uint8_t Filas[8];
+		LCD_glyphUnpack(Banco->glyphs[g], Filas);
+		if (memcmp(Filas, &Sim.display[0].cgram[(Banco->first + g) * 8], 8) != 0) Bien = false;
+	}
+	if (!Bien) {
+		printf("bank: %s, %lu transferencias (bus %lu), esperaba %lu\n", Nombre,
+			(unsigned long) Transferencias, (unsigned long) Bus, (unsigned long) Esperadas);
+		Fallas++;
+	}
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,113 @@
+/*******************************************************************************
+* @file    test_busy.c
+* @author  Guillermo Caporaletti
+* @brief   Espera de clear y home por interrupción (LCD_busyEvent) contra el
+*          modelo del HD44780, con el busy flag real:
+*          - la línea EXTI de DB7 se configura una sola vez, en LCD_init(),
+*            y queda enmascarada hasta que se arma;
+*          - cada clear termina por la interrupción, una sola vez (un aviso
+*            de LCD_onReady() por clear), y lo siguiente se escribe bien;
+*          - LCD_busyIrq() sin nada armado no hace nada, y deja PRIMASK
+*            como estaba;
+*          - con el display trabado en busy, la espera termina sola un
+*            tiempo de ejecución después de lo previsto, no un clear.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define CLEARS			20
+#define HOLGURA_US		10		// Transferencias y vueltas de la espera
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint32_t Avisos = 0;
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void aviso(void);
+static void fila(const char * Esperada);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	revisar(Sim.exti_inits == 1, "la EXTI se configura una vez en LCD_init()");
+	revisar(LCD_simEXTI.IMR == 0 && LCD_simEXTI.FTSR != 0, "la EXTI queda enmascarada y con el flanco elegido");
+
+	// Cada clear termina por la interrupción
+	LCD_busyEvent(true);
+	LCD_onReady(aviso);
+	LCD_simZero();
+	uint32_t Pendientes = 0;
+	for (uint32_t i=0; i<CLEARS; i++) {
+		LCD_print("Texto");
+		LCD_clear();
+		if (LCD_busyPending()) Pendientes++;
+		LCD_print("Hola");
+		fila("Hola");
+		revisar(!LCD_busyPending() && LCD_simEXTI.IMR == 0, "la interrupción desarma la línea");
+	}
+	printf("busy: %u clears, %lu pendientes al volver, %lu interrupciones, %lu avisos, %lu lecturas\n", CLEARS,
+		(unsigned long) Pendientes, (unsigned long) Sim.irqs, (unsigned long) Avisos, (unsigned long) Sim.display[0].reads);
+	revisar(Pendientes == CLEARS && Sim.irqs == CLEARS && Avisos == CLEARS, "un aviso por clear, desde la interrupción");
+	revisar(Sim.exti_inits == 1, "armar no vuelve a configurar el pin");
+
+	// Sin nada armado, LCD_busyIrq() no hace nada
+	__disable_irq();
+	LCD_busyIrq();
+	revisar(__get_PRIMASK() != 0, "LCD_busyIrq() deja las interrupciones deshabilitadas");
+	__enable_irq();
+	LCD_busyIrq();
+	revisar(__get_PRIMASK() == 0 && Avisos == CLEARS, "LCD_busyIrq() sin armar no avisa");
+
+	// Display trabado en busy: la espera tiene cota
+	LCD_clear();
+	Sim.display[0].busy_until = Sim.cycles + 1000000UL * LCD_CYCLES_PER_US;
+	uint32_t Cota = LCD_readyIn() + LCD_T_EXEC_US + HOLGURA_US;
+	uint64_t Inicio = Sim.cycles;
+	LCD_busyEvent(false);
+	uint32_t us = (uint32_t) ((Sim.cycles - Inicio) / LCD_CYCLES_PER_US);
+	printf("busy: trabado, la espera terminó en %lu us (cota %lu us)\n", (unsigned long) us, (unsigned long) Cota);
+	revisar(us <= Cota && !LCD_busyPending(), "la espera de un display trabado tiene cota");
+
+	printf("busy %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+static void aviso(void) {
+	Avisos++;
+}
+
+/*******************************************************************************
+* @brief  Compara la fila 0 del modelo con lo esperado (el resto, espacios)
+* @param  Texto esperado
+* @retval None
+*/
+static void fila(const char * Esperada) {
+	char Vista[48], Completa[48];
+	snprintf(Completa, sizeof(Completa), "%-*s", LCD_columns(), Esperada);
+	LCD_simRow(0, 0, Vista);
+	if (strcmp(Vista, Completa) != 0) {
+		printf("busy: fila 0 \"%s\", esperaba \"%s\"\n", Vista, Completa);
+		Fallas++;
+	}
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("busy: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,132 @@
+/*******************************************************************************
+* @file    test_charset.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_printUTF8() y LCD_translate() contra el modelo del HD44780:
+*          - un glifo que se ve no se pisa al cargar otros: "¿Año" en la
+*            fila 0 y luego "ÁÉÍÓÚáéíóú" en la fila 1 dejan la fila 0 igual,
+*            y lo que no entra en CGRAM sale como LCD_CHARSET_UNKNOWN;
+*          - lo que está en ROM, en la A00 y en la A02;
+*          - las secuencias UTF-8 inválidas (formas largas de más, mitades
+*            de UTF-16, cortadas) dan un '?' por cada parte inválida.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_charset.h>
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct {
+	uint32_t codigo;
+	uint8_t a00, a02;		// 0: un glifo de CGRAM (lugar 1 a 7)
+} Traduccion;
+
+/* Private variables ---------------------------------------------------------*/
+
+static const Traduccion Traducciones[] = {
+	{'A', 'A', 'A'},
+	{'\\', 0, '\\'},		// ¥ en la A00
+	{0x00F1, 0xEE, 0xF1},	// ñ
+	{0x00B0, 0xDF, 0xB0},	// °
+	{0x00FC, 0xF5, 0xFC},	// ü
+	{0x00E1, 0, 0xE1},		// á
+	{0x00BF, 0, 0xBF},		// ¿
+	{0x03C0, 0xF7, LCD_CHARSET_UNKNOWN},	// π
+	{0x2192, 0x7E, LCD_CHARSET_UNKNOWN},	// →
+	{0x4E2D, LCD_CHARSET_UNKNOWN, LCD_CHARSET_UNKNOWN},
+};
+
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void celdas(uint8_t row, const uint8_t * Esperadas, uint8_t n, const char * Caso);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	LCD_charset(LCD_ROM_A00);
+
+	// Un glifo a la vista no se pisa
+	static const uint8_t Fila0[] = {0x01, 'A', 0xEE, 'o'};
+	static const uint8_t Fila1[] = {0x02, 0x03, 0x04, 0x05, 0x06, 0x07, '?', '?', '?', '?'};
+	LCD_setCursor(0, 0);
+	LCD_printUTF8("¿Año");
+	LCD_setCursor(0, 1);
+	LCD_printUTF8("ÁÉÍÓÚáéíóú");
+	celdas(0, Fila0, sizeof(Fila0), "¿Año");
+	celdas(1, Fila1, sizeof(Fila1), "ÁÉÍÓÚáéíóú");
+	revisar(memcmp(Sim.display[0].cgram + 8, (const uint8_t[]) {0x04, 0x00, 0x04, 0x08, 0x10, 0x11, 0x0E, 0x00}, 8) == 0,
+		"el lugar 1 sigue con el ¿");
+
+	// Al borrar la fila 1, sus lugares se vuelven a usar (el del ¿ no)
+	LCD_setCursor(0, 1);
+	LCD_print("          ");
+	LCD_setCursor(0, 1);
+	LCD_printUTF8("éíóú");
+	static const uint8_t Reuso[] = {0x02, 0x03, 0x04, 0x05};
+	celdas(1, Reuso, sizeof(Reuso), "éíóú, reusando");
+	celdas(0, Fila0, sizeof(Fila0), "¿Año, luego de reusar");
+
+	// Las dos ROM
+	for (uint8_t r=0; r<2; r++) {
+		LCD_clear();
+		LCD_charset(r == 0 ? LCD_ROM_A00 : LCD_ROM_A02);
+		for (size_t i=0; i<sizeof(Traducciones)/sizeof(Traducciones[0]); i++) {
+			const Traduccion * t = &Traducciones[i];
+			uint8_t Esperado = (r == 0) ? t->a00 : t->a02;
+			uint8_t Obtenido = LCD_translate(t->codigo);
+			bool Bien = (Esperado == 0) ? (Obtenido >= LCD_GLYPH_FIRST_SLOT && Obtenido <= LCD_GLYPH_LAST_SLOT)
+				: (Obtenido == Esperado);
+			if (Bien) continue;
+			printf("charset: %s, U+%04lX dio 0x%02X, esperaba 0x%02X\n", r == 0 ? "A00" : "A02",
+				(unsigned long) t->codigo, Obtenido, Esperado);
+			Fallas++;
+		}
+	}
+
+	// UTF-8 inválido
+	LCD_charset(LCD_ROM_A00);
+	LCD_clear();
+	LCD_printUTF8("\xE0\x80\x80" "a" "\xED\xA0\x80" "b" "\xF0\x8F\xBF\xBF" "c" "\xE2\x86\x92" "\xE2\x86" "d" "\xC3");
+	static const uint8_t Invalidos[] = {'?', '?', '?', 'a', '?', '?', '?', 'b', '?', '?', '?', '?', 'c', 0x7E, '?', 'd', '?'};
+	if (memcmp(Sim.display[0].ddram, Invalidos, sizeof(Invalidos)) != 0 || Sim.display[0].ac != sizeof(Invalidos)) {
+		printf("charset: UTF-8 inválido: DDRAM");
+		for (uint8_t i=0; i<sizeof(Invalidos); i++) printf(" %02X", Sim.display[0].ddram[i]);
+		printf(", AC %u\n", Sim.display[0].ac);
+		Fallas++;
+	}
+
+	printf("charset %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Compara las primeras celdas de una fila del modelo
+* @param  Fila, códigos esperados, cuántos, y el caso (para el reporte)
+* @retval None
+*/
+static void celdas(uint8_t row, const uint8_t * Esperadas, uint8_t n, const char * Caso) {
+	for (uint8_t c=0; c<n; c++) {
+		uint8_t Celda = LCD_simCell(0, c, row);
+		if (Celda == Esperadas[c]) continue;
+		printf("charset: %s, fila %u columna %u: 0x%02X, esperaba 0x%02X\n", Caso, row, c, Celda, Esperadas[c]);
+		Fallas++;
+	}
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("charset: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
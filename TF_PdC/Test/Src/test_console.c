@@ -0,0 +1,78 @@
+/*******************************************************************************
+* @file    test_console.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_console contra el modelo del HD44780, con la geometría que
+*          venga del módulo de puerto: regiones que no entran en el display,
+*          y un registro largo en una consola de todas las filas menos la
+*          primera, que tiene que quedar intacta.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_console.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define LINEAS			50		// Del registro
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	uint8_t Columnas, Lineas;
+	char Esperada[48], Vista[48];
+	bool Bien = true;
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Columnas = LCD_columns();
+	Lineas = LCD_lines();
+
+	// Regiones fuera del display: rechazadas, y la consola no escribe
+	if (LCD_consoleInit(Lineas, 1) || LCD_consoleInit(0, (uint8_t) (Lineas + 1)) || LCD_consoleInit(1, Lineas)) {
+		printf("console: aceptó una región fuera de %ux%u\n", Columnas, Lineas);
+		Bien = false;
+	}
+	LCD_simZero();
+	LCD_consolePrint("nada");
+	if (Sim.display[0].data != 0) {
+		printf("console: escribió desactivada\n");
+		Bien = false;
+	}
+
+	// Fila 0 fija, la consola en el resto, con renglones más largos que el display
+	LCD_setCursor(0, 0);
+	LCD_print("estado");
+	if (!LCD_consoleInit(1, 0)) {
+		printf("console: rechazó las filas 1 a %u\n", Lineas - 1);
+		Bien = false;
+	}
+	for (unsigned int i=0; i<LINEAS; i++) {
+		char Texto[64];
+		snprintf(Texto, sizeof(Texto), "%u: %s\n", i, (i % 3 == 0) ? "renglon largo que sigue en la otra linea" : "corto");
+		LCD_consolePrint(Texto);
+	}
+
+	// La última fila muestra el último renglón (el salto aún no se aplicó)
+	snprintf(Esperada, sizeof(Esperada), "%-*s", Columnas, "49: corto");
+	LCD_simRow(0, (uint8_t) (Lineas - 1), Vista);
+	if (strncmp(Vista, Esperada, Columnas) != 0) {
+		printf("console: última fila \"%.*s\"\n", Columnas, Vista);
+		Bien = false;
+	}
+	LCD_simRow(0, 0, Vista);
+	if (strncmp(Vista, "estado", 6) != 0) {
+		printf("console: pisó la fila 0\n");
+		Bien = false;
+	}
+	if (LCD_simShadowMismatches(0) != 0) {
+		printf("console: la sombra difiere del display\n");
+		Bien = false;
+	}
+
+	printf("console %ux%u: %s\n", Columnas, Lineas, Bien ? "bien" : "MAL");
+	return Bien ? 0 : 1;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* @file    test_dual.c
+* @author  Guillermo Caporaletti
+* @brief   Un display de 40x4 con dos controladores (LCD_DUAL_CONTROLLER)
+*          contra el modelo del HD44780, con un display del modelo por
+*          controlador:
+*          - las filas 0 y 1 llegan sólo al primero, y las 2 y 3 sólo al
+*            segundo; clear y los glifos, a los dos;
+*          - el cursor y el parpadeo se prenden sólo en el controlador donde
+*            está el cursor, y pasan al otro al cambiar de fila;
+*          - LCD_printScreen() intercala los dos controladores y tarda
+*            bastante menos que escribir la pantalla fila por fila.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define CURSOR_Y_PARPADEO	(LCD_CURSORON | LCD_BLINKON)
+
+/* Private variables ---------------------------------------------------------*/
+
+static const char * const Pantalla[4] = {
+	"Fila 0: primer controlador, arriba .....",
+	"Fila 1: primer controlador, abajo ......",
+	"Fila 2: segundo controlador, arriba ....",
+	"Fila 3: segundo controlador, abajo .....",
+};
+static const uint8_t Flecha[8] = {0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00};
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint64_t escribir(bool Intercalada);
+static void pantalla(const char * const Filas[4], const char * Caso);
+static void cursor(uint8_t Con, const char * Caso);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	revisar(LCD_displays() == 2 && LCD_lines() == 4 && LCD_columns() == 40, "40x4 con dos controladores");
+
+	// Cada fila, a su controlador
+	static const char * const Vacia[4] = {"", "", "", ""};
+	for (uint8_t row=0; row<4; row++) {
+		LCD_clear();
+		LCD_simAdvance(2 * LCD_SIM_CLEAR_CYCLES);
+		LCD_simZero();
+		LCD_setCursor(0, row);
+		LCD_print(Pantalla[row]);
+		uint8_t Duenio = row / 2;
+		revisar(Sim.display[Duenio].data == 40 && Sim.display[1 - Duenio].data == 0, "la fila llega sólo a su controlador");
+		const char * Filas[4] = {Vacia[0], Vacia[1], Vacia[2], Vacia[3]};
+		Filas[row] = Pantalla[row];
+		pantalla(Filas, "una fila");
+	}
+
+	// Clear y los glifos, a los dos
+	LCD_simZero();
+	LCD_clear();
+	LCD_createChar(1, Flecha);
+	revisar(Sim.display[0].clears == 1 && Sim.display[1].clears == 1, "clear llega a los dos controladores");
+	revisar(memcmp(Sim.display[0].cgram + 8, Flecha, 8) == 0 && memcmp(Sim.display[1].cgram + 8, Flecha, 8) == 0,
+		"el glifo llega a los dos controladores");
+
+	// Cursor y parpadeo, sólo en el controlador del cursor
+	LCD_cursor();
+	LCD_blink();
+	LCD_setCursor(5, 1);
+	cursor(0, "fila 1");
+	LCD_setCursor(7, 3);
+	cursor(1, "fila 3");
+	revisar(Sim.display[1].ac == 0x40 + 7, "el AC del segundo controlador queda en la columna 7 de su fila 1");
+	LCD_write('x');
+	revisar(LCD_simCell(1, 7, 1) == 'x' && LCD_simCell(0, 7, 1) == ' ', "el caracter va al controlador del cursor");
+	cursor(1, "luego de escribir");
+	LCD_home();
+	cursor(0, "home");
+	LCD_noCursor();
+	LCD_noBlink();
+	revisar((Sim.display[0].control & CURSOR_Y_PARPADEO) == 0 && (Sim.display[1].control & CURSOR_Y_PARPADEO) == 0,
+		"sin cursor ni parpadeo en ninguno");
+
+	// LCD_printScreen(), contra fila por fila
+	uint64_t Fila_por_fila = escribir(false);
+	pantalla(Pantalla, "fila por fila");
+	uint64_t Intercalada = escribir(true);
+	pantalla(Pantalla, "LCD_printScreen()");
+	double Relacion = (double) Intercalada / (double) Fila_por_fila;
+	printf("dual: la pantalla fila por fila en %lu us y con LCD_printScreen() en %lu us (%.2f)\n",
+		(unsigned long) (Fila_por_fila / LCD_CYCLES_PER_US), (unsigned long) (Intercalada / LCD_CYCLES_PER_US), Relacion);
+	revisar(Relacion <= 0.6, "LCD_printScreen() tarda a lo sumo 0,6 de fila por fila");
+	revisar(LCD_simShadowMismatches(0) == 0 && LCD_simShadowMismatches(1) == 0, "la sombra coincide con la DDRAM");
+
+	printf("dual 40x4: %lu fallas\n", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Borra y escribe la pantalla completa
+* @param  Con LCD_printScreen() (true) o fila por fila con LCD_print()
+* @retval Ciclos de la escritura, sin el clear
+*/
+static uint64_t escribir(bool Intercalada) {
+	LCD_clear();
+	LCD_simAdvance(2 * LCD_SIM_CLEAR_CYCLES);
+
+	uint64_t Inicio = Sim.cycles;
+	if (Intercalada) {
+		LCD_printScreen(Pantalla);
+	} else {
+		for (uint8_t row=0; row<4; row++) {
+			LCD_setCursor(0, row);
+			LCD_print(Pantalla[row]);
+		}
+	}
+	return Sim.cycles - Inicio;
+}
+
+/*******************************************************************************
+* @brief  Compara las cuatro filas con las de cada controlador del modelo
+* @param  Filas esperadas (el resto, espacios) y caso (para el reporte)
+* @retval None
+* @note   La fila r de la pantalla es la fila r % 2 del controlador r / 2.
+*/
+static void pantalla(const char * const Filas[4], const char * Caso) {
+	for (uint8_t row=0; row<4; row++) {
+		char Vista[48], Completa[48];
+		snprintf(Completa, sizeof(Completa), "%-40s", Filas[row]);
+		LCD_simRow(row / 2, row % 2, Vista);
+		if (strcmp(Vista, Completa) == 0) continue;
+		printf("dual: %s, fila %u \"%s\", esperaba \"%s\"\n", Caso, row, Vista, Completa);
+		Fallas++;
+	}
+}
+
+/*******************************************************************************
+* @brief  Revisa que cursor y parpadeo estén prendidos sólo en un controlador
+* @param  Controlador con el cursor y caso (para el reporte)
+* @retval None
+*/
+static void cursor(uint8_t Con, const char * Caso) {
+	uint8_t Otro = 1 - Con;
+	if ((Sim.display[Con].control & CURSOR_Y_PARPADEO) == CURSOR_Y_PARPADEO
+		&& (Sim.display[Otro].control & CURSOR_Y_PARPADEO) == 0
+		&& (Sim.display[0].control & LCD_DISPLAYON) && (Sim.display[1].control & LCD_DISPLAYON)) return;
+	printf("dual: %s: displaycontrol 0x%02X y 0x%02X, esperaba el cursor en el controlador %u\n", Caso,
+		Sim.display[0].control, Sim.display[1].control, Con);
+	Fallas++;
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("dual: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
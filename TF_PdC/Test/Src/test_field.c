@@ -0,0 +1,168 @@
+/*******************************************************************************
+* @file    test_field.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_field contra el modelo del HD44780, con un tablero de 20x4 de
+*          10 valores con etiqueta:
+*          - las etiquetas se escriben una vez y no se reenvían;
+*          - cada LCD_fieldUpdate() envía exactamente los caracteres que
+*            cambiaron (y una dirección por tramo, a lo sumo), nada si no
+*            cambió nada, y la pantalla queda como se anotó;
+*          - 500 actualizaciones con valores que cambian de a poco cuestan
+*            unos bytes cada una, no las 80 celdas de redibujar todo;
+*          - alineación a la izquierda, a la derecha y centrada.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_field.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define CAMPOS			10
+#define ANCHO			5
+#define ACTUALIZACIONES	500
+
+/* Private variables ---------------------------------------------------------*/
+
+static LCD_field Campo[CAMPOS];
+static char Mostrado[CAMPOS][ANCHO + 1];
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t cambios(const int32_t Valores[CAMPOS]);
+static uint32_t escrituras(void);
+static void pantalla(const int32_t Valores[CAMPOS]);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	int32_t Valores[CAMPOS];
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	// Tablero: tres campos por fila, cada uno con una letra de etiqueta
+	LCD_simZero();
+	for (uint8_t i=0; i<CAMPOS; i++) {
+		char Etiqueta[2] = {(char) ('a' + i), '\0'};
+		LCD_fieldLabel((i % 3) * (ANCHO + 1), i / 3, Etiqueta);
+		Campo[i] = LCD_fieldAdd((i % 3) * (ANCHO + 1) + 1, i / 3, ANCHO, LCD_ALIGN_RIGHT, NULL);
+		revisar(Campo[i] != LCD_FIELD_NONE, "LCD_fieldAdd() acepta el campo");
+	}
+	revisar(Sim.display[0].data == CAMPOS, "cada etiqueta se escribe una vez");
+
+	// Primera actualización: todo
+	for (uint8_t i=0; i<CAMPOS; i++) Valores[i] = 100 * i;
+	uint32_t Esperados = cambios(Valores);
+	LCD_simZero();
+	LCD_fieldUpdate();
+	revisar(Sim.display[0].data == Esperados && Esperados == CAMPOS * ANCHO, "la primera actualización escribe los campos");
+	pantalla(Valores);
+
+	// Sin cambios, nada
+	for (uint8_t i=0; i<CAMPOS; i++) LCD_fieldValue(Campo[i], Valores[i]);
+	LCD_simZero();
+	LCD_fieldUpdate();
+	revisar(escrituras() == 0, "sin cambios no se envía nada");
+
+	// Valores que cambian de a poco
+	uint32_t Total = 0, Peor = 0, Semilla = 1;
+	for (uint32_t n=0; n<ACTUALIZACIONES; n++) {
+		for (uint8_t i=0; i<CAMPOS; i++) {
+			Semilla = Semilla * 1103515245UL + 12345;
+			Valores[i] += (int32_t) ((Semilla >> 16) % 3) - 1;
+		}
+		Esperados = cambios(Valores);
+		LCD_simZero();
+		LCD_fieldUpdate();
+		if (Sim.display[0].data != Esperados || Sim.display[0].commands > Esperados) {
+			printf("field: actualización %lu: %lu datos y %lu comandos, cambiaron %lu caracteres\n", (unsigned long) n,
+				(unsigned long) Sim.display[0].data, (unsigned long) Sim.display[0].commands, (unsigned long) Esperados);
+			Fallas++;
+		}
+		Total += escrituras();
+		if (escrituras() > Peor) Peor = escrituras();
+	}
+	pantalla(Valores);
+	revisar(LCD_simShadowMismatches(0) == 0, "la sombra coincide con la DDRAM");
+	printf("field: %u campos, %u actualizaciones, %.1f bytes por actualización (la peor %lu; redibujar: %u)\n",
+		CAMPOS, ACTUALIZACIONES, (double) Total / ACTUALIZACIONES, (unsigned long) Peor, LCD_columns() * LCD_lines());
+	revisar(Peor < LCD_columns() * LCD_lines() / 2, "una actualización cuesta bytes, no la pantalla");
+
+	// Alineación
+	LCD_fieldReset();
+	LCD_field Izquierda = LCD_fieldAdd(0, 3, 6, LCD_ALIGN_LEFT, NULL);
+	LCD_field Centro = LCD_fieldAdd(6, 3, 6, LCD_ALIGN_CENTER, NULL);
+	LCD_field Derecha = LCD_fieldAdd(12, 3, 100, LCD_ALIGN_RIGHT, NULL);	// <-- Se recorta a la fila
+	LCD_fieldText(Izquierda, "ab");
+	LCD_fieldText(Centro, "cd");
+	LCD_fieldText(Derecha, "ef");
+	LCD_fieldUpdate();
+	char Fila[48];
+	LCD_simRow(0, 3, Fila);
+	revisar(strcmp(Fila, "ab      cd        ef") == 0, "alineación a la izquierda, al centro y a la derecha");
+	revisar(LCD_fieldAdd(LCD_columns(), 0, 1, LCD_ALIGN_LEFT, NULL) == LCD_FIELD_NONE, "un campo fuera de la pantalla se rechaza");
+
+	printf("field %ux%u: %lu fallas\n", LCD_columns(), LCD_lines(), (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Anota los valores y cuenta los caracteres que cambian en pantalla
+* @param  Valores
+* @retval Caracteres distintos a lo que ya se mostraba
+*/
+static uint32_t cambios(const int32_t Valores[CAMPOS]) {
+	uint32_t Distintos = 0;
+	for (uint8_t i=0; i<CAMPOS; i++) {
+		char Nuevo[16];
+		snprintf(Nuevo, sizeof(Nuevo), "%*ld", ANCHO, (long) Valores[i]);
+		for (uint8_t c=0; c<ANCHO; c++) {
+			if (Nuevo[c] != Mostrado[i][c]) Distintos++;
+		}
+		memcpy(Mostrado[i], Nuevo, ANCHO);
+		LCD_fieldValue(Campo[i], Valores[i]);
+	}
+	return Distintos;
+}
+
+static uint32_t escrituras(void) {
+	return Sim.display[0].commands + Sim.display[0].data;
+}
+
+/*******************************************************************************
+* @brief  Compara las filas del modelo con el tablero esperado
+* @param  Valores
+* @retval None
+*/
+static void pantalla(const int32_t Valores[CAMPOS]) {
+	for (uint8_t row=0; row<LCD_lines(); row++) {
+		char Esperada[48] = "", Vista[48];
+		for (uint8_t i=row*3; i<CAMPOS && i<row*3+3; i++) {
+			char Celda[16];
+			snprintf(Celda, sizeof(Celda), "%c%*ld", 'a' + i, ANCHO, (long) Valores[i]);
+			strcat(Esperada, Celda);
+		}
+		snprintf(Vista, sizeof(Vista), "%-*s", LCD_columns(), Esperada);
+		strcpy(Esperada, Vista);
+		LCD_simRow(0, row, Vista);
+		if (strcmp(Vista, Esperada) == 0) continue;
+		printf("field: fila %u \"%s\", esperaba \"%s\"\n", row, Vista, Esperada);
+		Fallas++;
+	}
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("field: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
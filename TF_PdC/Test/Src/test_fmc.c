@@ -0,0 +1,131 @@
+/*******************************************************************************
+* @file    test_fmc.c
+* @author  Guillermo Caporaletti
+* @brief   El bus FMC (compilando con LCD_FMC) contra el modelo del HD44780,
+*          con el banco reemplazado por memoria común:
+*          - LCD_init() configura el banco y no toca pines ni la EXTI, y
+*            cada byte es un único acceso al banco;
+*          - texto, glifos, lecturas y la recuperación luego de un corte;
+*          - LCD_selftest() con el busy flag real;
+*          - un perfil que no entra en los campos del FMC queda en el
+*            máximo de cada uno, sin Error_Handler(), y el bus sigue andando;
+*          - LCD_busBenchmark() da números con sentido.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_selftest.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define ADDSET(btr)		((btr) & 0x0F)
+#define DATAST(btr)		(((btr) >> 8) & 0xFF)
+#define BUSTURN(btr)	(((btr) >> 16) & 0x0F)
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint8_t Flecha[8] = {0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00};
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void fila(uint8_t row, const char * Esperada);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(false);
+	LCD_init();
+	Sim.busy_model = true;
+	uint32_t Btr = LCD_simFMC.BTCR[FMC_NORSRAM_BANK1 + 1];
+	printf("fmc: ADDSET %lu, DATAST %lu, BUSTURN %lu ciclos\n",
+		(unsigned long) ADDSET(Btr), (unsigned long) DATAST(Btr), (unsigned long) BUSTURN(Btr));
+	revisar((LCD_simFMC.BTCR[FMC_NORSRAM_BANK1] & 1U) != 0, "LCD_init() habilita el banco");
+	revisar(DATAST(Btr) >= LCD_NS_TO_CYCLES(LCD_getTiming()->pweh_ns), "DATAST cubre el pulso de E");
+	revisar(Sim.exti_inits == 0 && Sim.gpio_writes == 0, "con el FMC no se tocan pines ni la EXTI");
+
+	// Texto y glifos: un acceso por byte
+	LCD_simZero();
+	Sim.fmc_writes = 0;
+	LCD_setCursor(0, 0);
+	LCD_print("Hola FMC");
+	revisar(Sim.fmc_writes == 9 && Sim.gpio_writes == 0, "una escritura al banco por byte");
+	LCD_createChar(1, Flecha);
+	LCD_setCursor(0, 1);
+	LCD_write(1);
+	LCD_print(" listo");
+	fila(0, "Hola FMC");
+	revisar(LCD_simCell(0, 0, 1) == 1 && memcmp(Sim.display[0].cgram + 8, Flecha, 8) == 0, "el glifo llega a la CGRAM");
+
+	// Lecturas
+	LCD_setCursor(0, 0);
+	uint8_t a = LCD_data_read(), b = LCD_data_read();
+	revisar(a == 'H' && b == 'o', "LCD_data_read() lee la DDRAM");
+	revisar(LCD_address_read() == LCD_address() && LCD_address() == 2, "LCD_address_read() coincide con la sombra");
+
+	// Corte de alimentación
+	LCD_simPowerCycle(0);
+	revisar(LCD_recover(), "LCD_recover() ve el corte");
+	fila(0, "Hola FMC");
+	revisar(LCD_simShadowMismatches(0) == 0, "la DDRAM vuelve a ser la de la sombra");
+
+	// LCD_selftest, con el busy flag real
+	LCDselftestReport Reporte;
+	revisar(LCD_selftest(2654435761UL, 3000, &Reporte), "LCD_selftest() por el FMC");
+
+	// Un perfil que no entra en los campos: queda en el máximo, y el bus sigue
+	LCDtiming Original = *LCD_getTiming();
+	LCDtiming Lento = Original;
+	Lento.as_ns = 1000;
+	Lento.pweh_ns = 5000;
+	Lento.h_ns = 1000;
+	Lento.cycle_ns = 8000;
+	LCD_setTiming(&Lento);
+	Btr = LCD_simFMC.BTCR[FMC_NORSRAM_BANK1 + 1];
+	revisar(ADDSET(Btr) == LCD_FMC_ADDSET_MAX && DATAST(Btr) == LCD_FMC_DATAST_MAX && BUSTURN(Btr) == LCD_FMC_BUSTURN_MAX,
+		"un tiempo que no entra queda en el máximo del campo");
+	LCD_clear();
+	LCD_print("Lento");
+	fila(0, "Lento");
+	LCD_setTiming(&Original);
+
+	// Velocidad del bus
+	LCDbusBench Bus;
+	LCD_busBenchmark(&Bus);
+	printf("fmc: un byte en %lu ciclos (%lu bytes/s), texto %lu bytes/s\n", (unsigned long) Bus.write_cycles,
+		(unsigned long) Bus.bytes_per_s, (unsigned long) Bus.text_bytes_per_s);
+	revisar(Bus.write_cycles != 0 && Bus.bytes_per_s == LCD_CORE_CLOCK_HZ / Bus.write_cycles
+		&& Bus.text_bytes_per_s != 0 && Bus.text_bytes_per_s < Bus.bytes_per_s, "LCD_busBenchmark() mide el bus");
+	fila(0, "Lento");
+
+	printf("fmc: %lu fallas\n", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Compara una fila del modelo con lo esperado (el resto, espacios)
+* @param  Fila y texto esperado
+* @retval None
+*/
+static void fila(uint8_t row, const char * Esperada) {
+	char Vista[48], Completa[48];
+	snprintf(Completa, sizeof(Completa), "%-*s", LCD_columns(), Esperada);
+	LCD_simRow(0, row, Vista);
+	if (strcmp(Vista, Completa) != 0) {
+		printf("fmc: fila %u \"%s\", esperaba \"%s\"\n", row, Vista, Completa);
+		Fallas++;
+	}
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("fmc: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,149 @@
+/*******************************************************************************
+* @file    test_mirror.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_mirror contra el modelo del HD44780, con varios displays en
+*          el mismo bus:
+*          - una pantalla completa en todos cuesta el tiempo de bus de
+*            escribirla en uno, y todos quedan iguales;
+*          - con contenidos distintos, cada celda llega sólo a los displays
+*            que no la tienen, y sólo a los de la máscara;
+*          - LCD_mirrorCopy() envía sólo lo que difiere;
+*          - la selección de displays queda como estaba.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_mirror.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static const char * Pantalla[] = {"Temp  23.5 C    ", "Hum   61 %      ", "Pres  1013 hPa  ", "Viento 12 km/h  "};
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint64_t escribir(uint8_t Mascara);
+static void datos(const uint32_t Esperados[LCD_MAX_DISPLAYS], const char * Caso);
+static void fila(uint8_t d, uint8_t row, const char * Esperada);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	uint8_t Todos = (uint8_t) ((1U << LCD_displays()) - 1);
+
+	// La pantalla en uno, en cada uno por separado y en todos a la vez
+	uint64_t Uno = escribir(0x01);
+	uint64_t Separados = 0;
+	for (uint8_t d=0; d<LCD_displays(); d++) Separados += escribir((uint8_t) (1U << d));
+	uint64_t Espejo = escribir(LCD_MIRROR_ALL);
+	for (uint8_t d=0; d<LCD_displays(); d++) {
+		for (uint8_t row=0; row<LCD_lines(); row++) fila(d, row, Pantalla[row]);
+		revisar(LCD_simShadowMismatches(d) == 0, "la sombra de cada display coincide con su DDRAM");
+	}
+	printf("mirror: %u displays, la pantalla en uno %lu us, en cada uno por separado %lu us y en todos a la vez %lu us\n",
+		LCD_displays(), (unsigned long) (Uno / LCD_CYCLES_PER_US), (unsigned long) (Separados / LCD_CYCLES_PER_US),
+		(unsigned long) (Espejo / LCD_CYCLES_PER_US));
+	revisar(Espejo * 100 <= Uno * 105, "repetir la pantalla cuesta el tiempo de bus de un display");
+	revisar(Separados * 100 >= Uno * LCD_displays() * 95, "por separado cuesta un display por display");
+	revisar(LCD_selected() == Todos, "LCD_mirrorPrint() deja la selección como estaba");
+
+	// Otra cosa en el último display: sólo él recibe las celdas
+	uint8_t Ultimo = (uint8_t) (LCD_displays() - 1);
+	LCD_select((uint8_t) (1U << Ultimo));
+	LCD_setCursor(6, 0);
+	LCD_print("41,0");
+	LCD_select(1);
+	LCD_simZero();
+	LCD_mirrorPrint(LCD_MIRROR_ALL, 0, 0, Pantalla[0]);
+	uint32_t Esperados[LCD_MAX_DISPLAYS] = {0};
+	Esperados[Ultimo] = 4;
+	datos(Esperados, "sólo el display distinto recibe sus celdas");
+	revisar(Sim.display[Ultimo].set_address <= 1, "una dirección para el tramo distinto");
+	revisar(LCD_selected() == 1, "LCD_mirrorPrint() deja elegido el display que estaba");
+	fila(Ultimo, 0, Pantalla[0]);
+
+	// Sólo los de la máscara
+	LCD_simZero();
+	LCD_mirrorPrint(0x01, 0, 1, "Hum   99 %");
+	memset(Esperados, 0, sizeof(Esperados));
+	Esperados[0] = 2;
+	datos(Esperados, "la máscara elige los displays");
+	if (LCD_displays() > 1) fila(1, 1, Pantalla[1]);
+
+	// LCD_mirrorCopy(): del 0 a los demás, sólo lo distinto, en una transferencia
+	LCD_simZero();
+	LCD_mirrorCopy(0, LCD_MIRROR_ALL);
+	for (uint8_t d=1; d<LCD_displays(); d++) Esperados[d] = 2;
+	Esperados[0] = 0;
+	datos(Esperados, "LCD_mirrorCopy() envía sólo las celdas distintas");
+	for (uint8_t d=0; d<LCD_displays(); d++) fila(d, 1, "Hum   99 %      ");
+	LCD_simZero();
+	LCD_mirrorCopy(0, LCD_MIRROR_ALL);
+	memset(Esperados, 0, sizeof(Esperados));
+	datos(Esperados, "LCD_mirrorCopy() entre displays iguales no envía nada");
+	LCD_mirrorWrite(Todos, 0, 0, 'T');
+	datos(Esperados, "LCD_mirrorWrite() de lo que ya está no envía nada");
+
+	printf("mirror %u displays: %lu fallas\n", LCD_displays(), (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Borra todos los displays y escribe la pantalla con LCD_mirrorPrint()
+* @param  Displays donde escribirla
+* @retval Ciclos de la escritura, sin el clear
+*/
+static uint64_t escribir(uint8_t Mascara) {
+	LCD_select((uint8_t) ((1U << LCD_displays()) - 1));
+	LCD_clear();
+	LCD_simAdvance(2 * LCD_SIM_CLEAR_CYCLES);
+
+	uint64_t Inicio = Sim.cycles;
+	for (uint8_t row=0; row<LCD_lines(); row++) LCD_mirrorPrint(Mascara, 0, row, Pantalla[row]);
+	return Sim.cycles - Inicio;
+}
+
+/*******************************************************************************
+* @brief  Compara los datos que recibió cada display con los esperados
+* @param  Datos esperados por display y caso (para el reporte)
+* @retval None
+*/
+static void datos(const uint32_t Esperados[LCD_MAX_DISPLAYS], const char * Caso) {
+	for (uint8_t d=0; d<LCD_displays(); d++) {
+		if (Sim.display[d].data == Esperados[d]) continue;
+		printf("mirror: %s: el display %u recibió %lu datos, esperaba %lu\n", Caso, d,
+			(unsigned long) Sim.display[d].data, (unsigned long) Esperados[d]);
+		Fallas++;
+	}
+}
+
+/*******************************************************************************
+* @brief  Compara una fila de un display del modelo con lo esperado
+* @param  Display, fila y texto esperado (el resto, espacios)
+* @retval None
+*/
+static void fila(uint8_t d, uint8_t row, const char * Esperada) {
+	char Vista[48], Completa[48];
+	snprintf(Completa, sizeof(Completa), "%-*.*s", LCD_columns(), LCD_columns(), Esperada);
+	LCD_simRow(d, row, Vista);
+	if (strcmp(Vista, Completa) != 0) {
+		printf("mirror: display %u, fila %u \"%s\", esperaba \"%s\"\n", d, row, Vista, Completa);
+		Fallas++;
+	}
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("mirror: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
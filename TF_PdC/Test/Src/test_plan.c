@@ -0,0 +1,197 @@
+/*******************************************************************************
+* @file    test_plan.c
+* @author  Guillermo Caporaletti
+* @brief   Medición de LCD_plan en la PC, contra el modelo del HD44780: 100
+*          cuadros de tres escenas (un contador, un texto que se desplaza y
+*          dos menús que se alternan), enviados de tres maneras: redibujando
+*          todo, sólo lo distinto, y con el plan más barato. Informa el
+*          tiempo de bus de cada una (con LCD_plan_4bit, y lo estimado con
+*          LCD_plan_i2c_100k) y comprueba, después de cada cuadro, que el
+*          display muestre lo pedido. Falla si algún cuadro queda mal o si
+*          el plan tarda más que enviar sólo lo distinto.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_plan.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define CUADROS			100
+#define ANCHO			16
+
+/* Private types -------------------------------------------------------------*/
+
+typedef enum {
+	TODO,			// LCD_printScreen de la pantalla entera (con espacios)
+	DISTINTO,		// Sólo las celdas distintas a la sombra
+	PLAN			// LCD_planMake y LCD_planRun
+} Manera;
+
+typedef void (*Escena)(uint32_t Cuadro);
+
+/* Private variables ---------------------------------------------------------*/
+
+static char Fila_0[24], Fila_1[24];
+static const char * const Pantalla[2] = {Fila_0, Fila_1};
+static const char * const Texto = "Texto largo que da vueltas en el LCD... ";	// 40 columnas
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void contador(uint32_t Cuadro);
+static void marquesina(uint32_t Cuadro);
+static void menus(uint32_t Cuadro);
+static uint32_t medir(const char * Nombre, Escena Escena, Manera Manera, const LCDplanCost * Costo);
+static void enviar_distinto(void);
+static uint32_t comparar(void);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	static const struct {
+		const char * nombre;
+		Escena escena;
+		uint32_t ganancia;		// Cuántas veces menos que lo distinto, al menos
+	} Escenas[3] = {
+		{"contador", contador, 1},
+		{"marquesina", marquesina, 4},
+		{"menus", menus, 1}
+	};
+
+	printf("plan 16x2, %u cuadros, LCD_plan_4bit (tiempo en el modelo):\n", CUADROS);
+	for (uint8_t s=0; s<3; s++) {
+		medir(Escenas[s].nombre, Escenas[s].escena, TODO, NULL);
+		uint32_t Distinto = medir(Escenas[s].nombre, Escenas[s].escena, DISTINTO, NULL);
+		uint32_t Plan = medir(Escenas[s].nombre, Escenas[s].escena, PLAN, &LCD_plan_4bit);
+		if (Plan * Escenas[s].ganancia > Distinto + Distinto / 20) {
+			printf("plan: %s tarda %lu us, sólo lo distinto %lu us\n", Escenas[s].nombre, (unsigned long) Plan, (unsigned long) Distinto);
+			Fallas++;
+		}
+	}
+	printf("plan con LCD_plan_i2c_100k (tiempo estimado):\n");
+	for (uint8_t s=0; s<3; s++) medir(Escenas[s].nombre, Escenas[s].escena, PLAN, &LCD_plan_i2c_100k);
+
+	printf("plan: %lu fallas\n", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+static void contador(uint32_t Cuadro) {
+	snprintf(Fila_0, sizeof(Fila_0), "Cuenta: %lu", (unsigned long) (12345 + Cuadro));
+	snprintf(Fila_1, sizeof(Fila_1), "Temp %lu.%luC", (unsigned long) (20 + (Cuadro / 37) % 5), (unsigned long) (Cuadro % 10));
+}
+
+static void marquesina(uint32_t Cuadro) {
+	for (uint8_t c=0; c<ANCHO; c++) Fila_0[c] = Texto[(Cuadro + c) % 40];
+	Fila_0[ANCHO] = '\0';
+	Fila_1[0] = '\0';
+}
+
+static void menus(uint32_t Cuadro) {
+	strcpy(Fila_0, (Cuadro & 1) ? "Menu principal >" : "   Cargando");
+	strcpy(Fila_1, (Cuadro & 1) ? "1.Config 2.Info" : "");
+}
+
+/*******************************************************************************
+* @brief  Envía los cuadros de una escena de una manera y mide el bus
+* @param  Nombre, escena, manera y modelo de costo (para el plan)
+* @retval Tiempo en el modelo, en us
+*/
+static uint32_t medir(const char * Nombre, Escena Escena, Manera Manera, const LCDplanCost * Costo) {
+	uint32_t Tipos[4] = {0}, Estimado_us = 0, Distintas = 0;
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	if (Escena == marquesina) {
+		// El texto entero en DDRAM, como lo dejaría quien lo muestra
+		LCD_setCursor(0, 0);
+		LCD_printn(Texto, 40);
+	}
+	LCD_simZero();
+
+	uint64_t Inicio = Sim.cycles;
+	for (uint32_t i=0; i<CUADROS; i++) {
+		Escena(i);
+		if (Manera == TODO) {
+			char Completa_0[ANCHO + 1], Completa_1[ANCHO + 1];
+			const char * const Completas[2] = {Completa_0, Completa_1};
+			snprintf(Completa_0, sizeof(Completa_0), "%-*.*s", ANCHO, ANCHO, Fila_0);
+			snprintf(Completa_1, sizeof(Completa_1), "%-*.*s", ANCHO, ANCHO, Fila_1);
+			LCD_printScreen(Completas);
+		} else if (Manera == DISTINTO) {
+			enviar_distinto();
+		} else {
+			LCDplan Plan;
+			LCD_planMake(Pantalla, Costo, &Plan);
+			Tipos[Plan.kind]++;
+			Estimado_us += Plan.cost_ns / 1000;
+			LCD_planRun(Pantalla, &Plan);
+		}
+		Distintas += comparar();
+	}
+	LCD_readyIn();
+	uint32_t us = (uint32_t) ((Sim.cycles - Inicio) / LCD_CYCLES_PER_US);
+
+	printf("  %-10s %-8s %7lu us, %5lu transferencias", Nombre,
+		(Manera == TODO) ? "todo" : (Manera == DISTINTO) ? "distinto" : "plan", (unsigned long) us,
+		(unsigned long) (Sim.display[0].commands + Sim.display[0].data));
+	if (Manera == PLAN) {
+		printf(", estimado %lu us (distinto %lu, scroll %lu, home %lu, clear %lu)", (unsigned long) Estimado_us,
+			(unsigned long) Tipos[LCD_PLAN_DIFF], (unsigned long) Tipos[LCD_PLAN_SCROLL],
+			(unsigned long) Tipos[LCD_PLAN_HOME], (unsigned long) Tipos[LCD_PLAN_CLEAR]);
+	}
+	printf("\n");
+	if (Distintas != 0) {
+		printf("plan: %s, %lu celdas mal\n", Nombre, (unsigned long) Distintas);
+		Fallas++;
+	}
+	return us;
+}
+
+/*******************************************************************************
+* @brief  Envía sólo las celdas distintas a la sombra, con una dirección por tramo
+* @param  None
+* @retval None
+*/
+static void enviar_distinto(void) {
+	for (uint8_t row=0; row<2; row++) {
+		bool Fin = false;
+		for (uint8_t col=0; col<ANCHO; col++) {
+			char Caracter = Fin ? ' ' : Pantalla[row][col];
+			if (Caracter == '\0') {
+				Fin = true;
+				Caracter = ' ';
+			}
+			if (LCD_cellVisible(col, row) == (uint8_t) Caracter) continue;
+			if (!LCD_cursorAt(col, row)) LCD_setCursor(col, row);
+			LCD_write((uint8_t) Caracter);
+		}
+	}
+}
+
+/*******************************************************************************
+* @brief  Compara lo que muestra el modelo con la pantalla pedida
+* @param  None
+* @retval Celdas distintas
+*/
+static uint32_t comparar(void) {
+	uint32_t Distintas = 0;
+	for (uint8_t row=0; row<2; row++) {
+		bool Fin = false;
+		for (uint8_t col=0; col<ANCHO; col++) {
+			char Caracter = Fin ? ' ' : Pantalla[row][col];
+			if (Caracter == '\0') {
+				Fin = true;
+				Caracter = ' ';
+			}
+			if (LCD_simCell(0, col, row) != (uint8_t) Caracter) Distintas++;
+		}
+	}
+	return Distintas;
+}
+
+/***************************************************************END OF FILE****/
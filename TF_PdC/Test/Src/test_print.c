@@ -0,0 +1,123 @@
+/*******************************************************************************
+* @file    test_print.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_print(), LCD_printn() y LCD_printSpan() contra el modelo del
+*          HD44780:
+*          - LCD_printSpan() con cada posición (también más allá del tamaño)
+*            y cada cantidad (también más que el tamaño) de un buffer
+*            circular sin '\0', rodeado de guardas: llegan exactamente los
+*            caracteres esperados, en orden, sin leer fuera del buffer y sin
+*            reenviar la dirección al dar la vuelta;
+*          - LCD_printn() con partes de un texto y con el código 0 (el glifo
+*            0 de CGRAM);
+*          - LCD_print() no pasa de LCD_PRINT_MAX caracteres.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define TAMANIO		13
+#define GUARDA		'#'
+
+/* Private variables ---------------------------------------------------------*/
+
+static char Arena[TAMANIO + 2];		// Guarda, buffer circular y guarda
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void enviados(const char * Esperados, size_t n, const char * Caso);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	char * Buffer = &Arena[1];
+	char Esperados[TAMANIO + 1];
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	// Un buffer circular lleno, sin '\0' y con guardas a los costados
+	Arena[0] = Arena[TAMANIO + 1] = GUARDA;
+	for (uint8_t i=0; i<TAMANIO; i++) Buffer[i] = (char) ('a' + i);
+
+	// Cada posición y cada cantidad
+	uint32_t Casos = 0;
+	for (size_t Inicio=0; Inicio<3*TAMANIO; Inicio++) {
+		for (size_t Largo=0; Largo<=TAMANIO+3; Largo++) {
+			size_t n = (Largo > TAMANIO) ? TAMANIO : Largo;
+			for (size_t i=0; i<n; i++) Esperados[i] = Buffer[(Inicio + i) % TAMANIO];
+
+			char Caso[48];
+			snprintf(Caso, sizeof(Caso), "LCD_printSpan(%u, %u)", (unsigned) Inicio, (unsigned) Largo);
+			LCD_setCursor(0, 0);
+			LCD_simZero();
+			LCD_printSpan(Buffer, TAMANIO, Inicio, Largo);
+			enviados(Esperados, n, Caso);
+			Casos++;
+		}
+	}
+	LCD_simZero();
+	LCD_printSpan(Buffer, 0, 0, 5);
+	revisar(Sim.display[0].pulses == 0, "LCD_printSpan() con un buffer de tamaño 0 no envía nada");
+
+	// LCD_printn(): parte de un texto, y el código 0
+	static const uint8_t Glifo[8] = {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00};
+	LCD_createChar(0, Glifo);
+	LCD_setCursor(0, 0);
+	LCD_simZero();
+	LCD_printn("Temperatura", 0);
+	LCD_printn("Temperatura" + 3, 3);
+	enviados("per", 3, "LCD_printn(), parte de un texto");
+	LCD_setCursor(0, 0);
+	LCD_simZero();
+	LCD_printn("\0A\0", 3);
+	enviados("\0A\0", 3, "LCD_printn() con el código 0");
+	revisar(memcmp(Sim.display[0].cgram, Glifo, 8) == 0, "el glifo 0 sigue en la CGRAM");
+
+	// LCD_print() no pasa de LCD_PRINT_MAX
+	char Largo[LCD_PRINT_MAX + 40];
+	memset(Largo, 'x', sizeof(Largo) - 1);
+	Largo[sizeof(Largo) - 1] = '\0';
+	LCD_home();
+	LCD_simZero();
+	LCD_print(Largo);
+	revisar(Sim.display[0].data == LCD_PRINT_MAX, "LCD_print() envía a lo sumo LCD_PRINT_MAX caracteres");
+
+	printf("print %s: %lu casos de LCD_printSpan(), %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits",
+		(unsigned long) Casos, (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Revisa lo que llegó al display desde el comienzo de la fila 0: sólo
+*         esos datos, sin comandos, y en la DDRAM del modelo
+* @param  Caracteres esperados, cuántos y caso (para el reporte)
+* @retval None
+*/
+static void enviados(const char * Esperados, size_t n, const char * Caso) {
+	bool Bien = (Sim.display[0].data == n) && (Sim.display[0].commands == 0) && (Sim.display[0].ac == n);
+	for (size_t i=0; Bien && i<n; i++) Bien = (Sim.display[0].ddram[i] == (uint8_t) Esperados[i]);
+	if (Bien) return;
+	printf("print: %s: %lu datos, %lu comandos, AC %u; DDRAM \"", Caso, (unsigned long) Sim.display[0].data,
+		(unsigned long) Sim.display[0].commands, Sim.display[0].ac);
+	for (size_t i=0; i<n; i++) printf("%c", Sim.display[0].ddram[i] ? Sim.display[0].ddram[i] : '0');
+	printf("\"\n");
+	Fallas++;
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("print: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
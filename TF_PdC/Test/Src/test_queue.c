@@ -0,0 +1,112 @@
+/*******************************************************************************
+* @file    test_queue.c
+* @author  Guillermo Caporaletti
+* @brief   Varios productores (hilos) contra LCD_queueService().
+*          Cada productor encola textos en su propia posición, sin parar y
+*          sin esperar; otro escribe en el cuadro compartido (en la última
+*          fila). El hilo principal hace de tarea del display. Al final,
+*          toda operación aceptada se ejecutó una vez, aceptadas más
+*          descartadas suman lo intentado, la pantalla muestra lo último de
+*          cada productor y la sombra del driver coincide con el modelo.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <LCD_sim.h>
+#include <LCD_queue.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define PRODUCTORES		3		// Por la cola (más uno por el cuadro)
+#define OPERACIONES		20000	// Por productor
+#define LARGO			4		// Caracteres de cada texto
+
+/* Private variables ---------------------------------------------------------*/
+
+static atomic_int Terminados;
+static atomic_uint Aceptadas;
+static char Ultimo[PRODUCTORES + 1][LARGO + 1];
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void * productor(void * Argumento);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	pthread_t Hilos[PRODUCTORES + 1];
+	unsigned long Ejecutadas = 0;
+	bool Bien = true;
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	if (!LCD_queueInit()) {
+		printf("queue: el cuadro no entra en %ux%u\n", LCD_columns(), LCD_lines());
+		return 1;
+	}
+
+	for (long i=0; i<=PRODUCTORES; i++) pthread_create(&Hilos[i], NULL, productor, (void *) i);
+	while (atomic_load(&Terminados) <= PRODUCTORES) Ejecutadas += LCD_queueService(0);
+	for (int i=0; i<=PRODUCTORES; i++) pthread_join(Hilos[i], NULL);
+	Ejecutadas += LCD_queueService(0);
+
+	// Cada aceptada, ejecutada una vez; ninguna perdida sin contar
+	unsigned int Aceptadas_total = atomic_load(&Aceptadas);
+	if (Ejecutadas != Aceptadas_total || Aceptadas_total + LCD_queueDropped() != PRODUCTORES * OPERACIONES) {
+		printf("queue: %lu ejecutadas, %u aceptadas, %lu descartadas\n", Ejecutadas, Aceptadas_total, (unsigned long) LCD_queueDropped());
+		Bien = false;
+	}
+
+	// Lo último de cada uno quedó en su lugar
+	for (uint8_t i=0; i<=PRODUCTORES; i++) {
+		uint8_t Fila = (i == 0) ? (uint8_t) (LCD_lines() - 1) : 0;
+		uint8_t Columna = (i == 0) ? (uint8_t) (LCD_columns() - LARGO) : (uint8_t) ((i - 1) * LARGO);
+		for (uint8_t c=0; c<LARGO; c++) {
+			if (LCD_simCell(0, Columna + c, Fila) != (uint8_t) Ultimo[i][c]) {
+				printf("queue: productor %u, esperaba \"%s\"\n", i, Ultimo[i]);
+				Bien = false;
+				break;
+			}
+		}
+	}
+	if (LCD_simShadowMismatches(0) != 0) {
+		printf("queue: la sombra difiere del display\n");
+		Bien = false;
+	}
+
+	printf("queue %ux%u: %d productores, %u aceptadas, %lu descartadas, %s\n", LCD_columns(), LCD_lines(),
+		PRODUCTORES + 1, Aceptadas_total, (unsigned long) LCD_queueDropped(), Bien ? "bien" : "MAL");
+	return Bien ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Productor: el 0 escribe en el cuadro, los demás encolan textos
+* @param  Número de productor
+* @retval None
+*/
+static void * productor(void * Argumento) {
+	uint8_t Yo = (uint8_t) (long) Argumento;
+	char Texto[LARGO + 1];
+
+	for (unsigned int i=0; i<OPERACIONES; i++) {
+		snprintf(Texto, sizeof(Texto), "%c%03u", 'A' + Yo, i % 1000);
+		if (Yo == 0) {
+			LCD_framePrint((uint8_t) (LCD_columns() - LARGO), (uint8_t) (LCD_lines() - 1), Texto);
+			memcpy(Ultimo[Yo], Texto, sizeof(Texto));
+		} else if (LCD_queuePrint((uint8_t) ((Yo - 1) * LARGO), 0, Texto)) {
+			atomic_fetch_add(&Aceptadas, 1);
+			memcpy(Ultimo[Yo], Texto, sizeof(Texto));
+		}
+		if (i % 64 == 0) sched_yield();
+	}
+	atomic_fetch_add(&Terminados, 1);
+	return NULL;
+}
+
+/***************************************************************END OF FILE****/
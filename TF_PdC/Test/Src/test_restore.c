@@ -0,0 +1,94 @@
+/*******************************************************************************
+* @file    test_restore.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_restore() contra el modelo del HD44780, con la aplicación en
+*          autoscroll (S=1), un glifo y el display desplazado:
+*          - sin corte: el display conserva S=1 (clear no lo cambia), y la
+*            pantalla, la DDRAM y el AC tienen que quedar como estaban;
+*          - con un corte de alimentación y LCD_recover(): lo mismo.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint8_t Flecha[8] = {0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00};
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void comparar(const char * Caso, char Antes[][48], uint8_t Ac, int16_t Desplazamiento);
+static void foto(char Filas[][48]);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	char Antes[LCD_MAX_LINES][48];
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	LCD_createChar(1, (uint8_t *) Flecha);
+	LCD_setCursor(0, 0);
+	LCD_print("Hola terricolas");
+	LCD_setCursor(0, 1);
+	LCD_write(1);
+	LCD_print(" contando");
+	LCD_autoscroll();
+	LCD_print("123");		// <-- Cada dato desplaza el display
+	LCD_readyIn();
+	foto(Antes);
+	uint8_t Ac = Sim.display[0].ac;
+	int16_t Desplazamiento = Sim.display[0].shift;
+
+	LCD_restore();
+	comparar("sin corte", Antes, Ac, Desplazamiento);
+
+	LCD_simPowerCycle(0);
+	if (!LCD_recover()) {
+		printf("restore: LCD_recover() no vio el corte\n");
+		Fallas++;
+	}
+	comparar("con corte", Antes, Ac, Desplazamiento);
+
+	printf("restore %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+static void foto(char Filas[][48]) {
+	for (uint8_t row=0; row<LCD_lines(); row++) LCD_simRow(0, row, Filas[row]);
+}
+
+/*******************************************************************************
+* @brief  Compara el modelo, luego de reponerlo, con lo que mostraba antes
+* @param  Caso, filas, AC y desplazamiento de antes
+* @retval None
+*/
+static void comparar(const char * Caso, char Antes[][48], uint8_t Ac, int16_t Desplazamiento) {
+	char Despues[LCD_MAX_LINES][48];
+	LCDsimDisplay * d = &Sim.display[0];
+
+	foto(Despues);
+	for (uint8_t row=0; row<LCD_lines(); row++) {
+		if (strcmp(Antes[row], Despues[row]) == 0) continue;
+		printf("restore %s: fila %u \"%s\", era \"%s\"\n", Caso, row, Despues[row], Antes[row]);
+		Fallas++;
+	}
+	if (LCD_simShadowMismatches(0) != 0 || memcmp(d->cgram + 8, Flecha, 8) != 0) {
+		printf("restore %s: la DDRAM o la CGRAM no son las de la sombra\n", Caso);
+		Fallas++;
+	}
+	if (d->ac != Ac || d->shift != Desplazamiento || !d->display_shift || !d->increment) {
+		printf("restore %s: AC %u, desplazamiento %d, S=%u, I/D=%u (esperaba %u, %d, 1, 1)\n", Caso,
+			d->ac, d->shift, d->display_shift, d->increment, Ac, Desplazamiento);
+		Fallas++;
+	}
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,137 @@
+/*******************************************************************************
+* @file    test_scrub.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_scrub() contra el modelo del HD44780, con cada perfil de
+*          tiempos y celdas corrompidas en la DDRAM del modelo:
+*          - ninguna llamada tarda más que su presupuesto, contando lo que
+*            faltaba de la instrucción anterior, aunque haya que corregir
+*            cada celda;
+*          - con un presupuesto que no alcanza no envía nada;
+*          - las celdas corrompidas se corrigen todas, y las estadísticas
+*            lo cuentan;
+*          - el AC de la aplicación queda donde estaba.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_scrub.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define LLAMADAS	400
+
+/* Private variables ---------------------------------------------------------*/
+
+static const struct {
+	const char * nombre;
+	const LCDtiming * perfil;
+} Perfiles[] = {
+	{"HD44780", &LCD_timing_HD44780},
+	{"KS0066", &LCD_timing_KS0066},
+	{"ST7066U", &LCD_timing_ST7066U},
+	{"SPLC780", &LCD_timing_SPLC780},
+};
+
+static const uint32_t Presupuestos[] = {100, 150, 200, 250, 300, 500, 1000};
+
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t corromper(uint8_t Cada);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	// Una pantalla con todas las celdas escritas
+	for (uint8_t row=0; row<LCD_lines(); row++) {
+		LCD_setCursor(0, row);
+		for (uint8_t col=0; col<LCD_columns(); col++) LCD_write((uint8_t) ('A' + (col + row * 7) % 26));
+	}
+
+	uint32_t Peor_exceso = 0;
+	for (size_t p=0; p<sizeof(Perfiles)/sizeof(Perfiles[0]); p++) {
+		LCD_setTiming(Perfiles[p].perfil);
+		for (size_t b=0; b<sizeof(Presupuestos)/sizeof(Presupuestos[0]); b++) {
+			uint32_t Presupuesto = Presupuestos[b];
+			for (uint8_t Cada=1; Cada<=3; Cada++) {
+				uint32_t Corruptas = corromper(Cada);
+				LCD_setCursor(3, 1);
+				uint8_t AC = LCD_address();
+				LCD_scrubStatsReset();
+
+				uint32_t Verificadas = 0, Mas_larga = 0;
+				for (uint32_t n=0; n<LLAMADAS; n++) {
+					uint64_t Inicio = Sim.cycles;
+					Verificadas += LCD_scrub(Presupuesto);
+					uint32_t Tardo = (uint32_t) ((Sim.cycles - Inicio) / LCD_CYCLES_PER_US);
+					if (Tardo > Mas_larga) Mas_larga = Tardo;
+					LCD_simAdvance((n % 2) ? LCD_SIM_CLEAR_CYCLES : 0);	// <-- Una de cada dos, seguidas
+				}
+
+				const LCDscrubStats * Estadisticas = LCD_scrubStats();
+				bool Corrigio = (Verificadas == 0) || (Estadisticas->errors == Corruptas
+					&& Estadisticas->repaired == Corruptas && LCD_simShadowMismatches(0) == 0);
+				if (Mas_larga > Presupuesto || !Corrigio || LCD_address() != AC) {
+					printf("scrub: %s, %lu us, una de cada %u celdas: la más larga %lu us, %lu de %lu corregidas, AC %u (antes %u)\n",
+						Perfiles[p].nombre, (unsigned long) Presupuesto, Cada, (unsigned long) Mas_larga,
+						(unsigned long) Estadisticas->repaired, (unsigned long) Corruptas, LCD_address(), AC);
+					Fallas++;
+				}
+				if (Mas_larga > Presupuesto && Mas_larga - Presupuesto > Peor_exceso) Peor_exceso = Mas_larga - Presupuesto;
+				if (Presupuesto >= 500) revisar(Verificadas > 0, "un presupuesto de 500 us alcanza para una celda");
+				if (Verificadas == 0) corromper(0);		// <-- Dejo la DDRAM como la sombra para el siguiente
+			}
+		}
+		printf("scrub: %s (%u us por instrucción), 4 bits %s: bien\n", Perfiles[p].nombre, Perfiles[p].perfil->exec_us,
+			LCD_SIM_FOUR_WIRES ? "sí" : "no");
+	}
+	LCD_setTiming(&LCD_timing_HD44780);
+
+	// Sin presupuesto para una celda y su corrección, nada
+	LCD_simAdvance(LCD_SIM_CLEAR_CYCLES);
+	LCD_simZero();
+	revisar(LCD_scrub(50) == 0 && Sim.display[0].pulses == 0, "con 50 us LCD_scrub() no envía nada");
+
+	if (Peor_exceso != 0) printf("scrub: se pasó hasta %lu us del presupuesto\n", (unsigned long) Peor_exceso);
+	printf("scrub %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Corrompe celdas de la DDRAM del modelo (sin que el driver lo sepa)
+* @param  Una de cada cuántas celdas en pantalla (0: devuelve todas a la sombra)
+* @retval Celdas corrompidas
+*/
+static uint32_t corromper(uint8_t Cada) {
+	uint32_t Corruptas = 0, i = 0;
+	for (uint8_t row=0; row<LCD_lines(); row++) {
+		for (uint8_t col=0; col<LCD_columns(); col++, i++) {
+			uint8_t Direccion = LCD_cellAddress(col, row);
+			if (Cada == 0) {
+				Sim.display[0].ddram[Direccion] = LCD_shadow(Direccion);
+			} else if (i % Cada == 0) {
+				Sim.display[0].ddram[Direccion] = LCD_shadow(Direccion) ^ 0x20;
+				Corruptas++;
+			}
+		}
+	}
+	return Corruptas;
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("scrub: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* @file    test_selftest.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_selftest() en la PC, contra el modelo del HD44780 (LCD_sim).
+*          Corre muchas semillas seguidas; además de lo que compara la propia
+*          prueba, al final de cada semilla compara la sombra del driver con
+*          la DDRAM del modelo. Uso: test_selftest [semillas [pasos [semilla]]]
+*          (sin semilla inicial, una fija; con 0, una al azar).
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <time.h>
+#include <LCD_sim.h>
+#include <LCD_selftest.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define SEMILLAS		20
+#define PASOS			3000
+#define SEMILLA			2654435761UL
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(int argc, char * argv[]) {
+	uint32_t Semillas = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : SEMILLAS;
+	uint32_t Pasos = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 0) : PASOS;
+	uint32_t Semilla = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 0) : SEMILLA;
+	if (Semilla == 0) Semilla = (uint32_t) time(NULL);
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	uint32_t Fallas = 0, Operaciones = 0;
+	for (uint32_t i=0; i<Semillas; i++) {
+		LCDselftestReport Reporte;
+		uint32_t s = Semilla + i * 2654435761UL;
+		if (s == 0) s = 1;
+
+		bool Bien = LCD_selftest(s, Pasos, &Reporte);
+		uint32_t Distintas = LCD_simShadowMismatches(0);
+		if (!Bien || Distintas != 0) {
+			printf("FALLA semilla=%lu paso=%lu op=%d celdas distintas=%lu\n", (unsigned long) s,
+				(unsigned long) Reporte.failed_step, (int) Reporte.failed_op, (unsigned long) Distintas);
+			Fallas++;
+		}
+		Operaciones += Reporte.steps;
+	}
+
+	printf("selftest %ux%u %s: %lu semillas desde %lu, %lu operaciones, %lu fallas\n",
+		LCD_columns(), LCD_lines(), LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits",
+		(unsigned long) Semillas, (unsigned long) Semilla, (unsigned long) Operaciones, (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/***************************************************************END OF FILE****/
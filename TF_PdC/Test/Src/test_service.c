@@ -0,0 +1,162 @@
+/*******************************************************************************
+* @file    test_service.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_service() contra el modelo del HD44780, con el presupuesto de
+*          "main.c" (200 us por vuelta):
+*          - un cambio de pantalla completo se reparte en varias vueltas, y
+*            ninguna se pasa del presupuesto;
+*          - el lazo de "main.c" (cuenta regresiva anotada, ruedita con
+*            LCD_animUpdateBudget() y revisión con LCD_recover() en su propia
+*            vuelta) durante 3 s: ninguna vuelta le da al display más que el
+*            presupuesto, y la pantalla termina como se anotó;
+*          - toda la pantalla del display se puede anotar (20x4 incluido), y
+*            lo que cae fuera se descarta.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_service.h>
+#include <LCD_anim.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define PRESUPUESTO_US		200		// Como PRESUPUESTO_LCD_US de "main.c"
+#define DURACION_MS			3000
+#define VUELTA_US			20		// Lo que tarda el resto del lazo
+#define CUENTA_MS			10		// Como INTERVALO_FINAL_COUNTDOWN
+#define REVISION_MS			500		// Como INTERVALO_REVISION_LCD
+
+/* Private variables ---------------------------------------------------------*/
+
+static const LCDanimRow Ruedita_barra[] = {
+	{0x08, 0x00}, {0x09, 0x04}, {0x0A, 0x04}, {0x0B, 0x04},
+	{0x0C, 0x04}, {0x0D, 0x04}, {0x0E, 0x00}, {0x0F, 0x00}
+};
+static const LCDanimCell Ruedita_lugar[] = {{14, 1, 1}};
+static const LCDanimRow Ruedita_a_diagonal[] = {
+	{0x09, 0x01}, {0x0A, 0x02}, {0x0C, 0x08}, {0x0D, 0x10}
+};
+static const LCDanimFrame Ruedita_cuadros[] = {
+	{150, Ruedita_barra, LCD_ANIM_COUNT(Ruedita_barra), Ruedita_lugar, LCD_ANIM_COUNT(Ruedita_lugar)},
+	{150, Ruedita_a_diagonal, LCD_ANIM_COUNT(Ruedita_a_diagonal), NULL, 0},
+};
+static const LCDanimation Ruedita = {Ruedita_cuadros, 2, 0};
+
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint32_t microsegundos(uint64_t Inicio);
+static void fila(uint8_t row, const char * Esperada);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	uint32_t Vueltas = 0, Peor = 0, Peor_revision = 0;
+	char Texto[24];
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	LCD_deferControl(true);
+
+	// Cambio de pantalla completo, de a poco
+	LCD_setCursor(0, 0);
+	LCD_print("Hola terricolas");
+	LCD_servicePrint(0, 0, "Vamos en camino!");
+	LCD_servicePrint(0, 1, "4294967295");
+	while (LCD_servicePending() != 0 && Vueltas < 100) {
+		uint64_t Inicio = Sim.cycles;
+		LCD_service(PRESUPUESTO_US);
+		uint32_t us = microsegundos(Inicio);
+		if (us > Peor) Peor = us;
+		Vueltas++;
+		LCD_simAdvance(VUELTA_US * LCD_CYCLES_PER_US);
+	}
+	fila(0, "Vamos en camino!");
+	fila(1, "4294967295");
+	printf("service: cambio de pantalla en %lu vueltas, la más larga %lu us\n", (unsigned long) Vueltas, (unsigned long) Peor);
+	if (Vueltas >= 100 || Peor > PRESUPUESTO_US) Fallas++;
+
+	// El lazo de "main.c"
+	LCDanimPlayer ruedita;
+	uint32_t Cuenta = 4294967295UL, Proxima_cuenta = 0, Proxima_revision = REVISION_MS;
+	LCD_setCursor(15, 1);
+	LCD_write('*');
+	LCD_animStart(&ruedita, &Ruedita);
+	Peor = 0;
+	Vueltas = 0;
+	while (HAL_GetTick() < DURACION_MS) {
+		uint64_t Inicio = Sim.cycles;
+		if (HAL_GetTick() >= Proxima_cuenta) {
+			Proxima_cuenta += CUENTA_MS;
+			Cuenta -= 5;
+			snprintf(Texto, sizeof(Texto), "%lu", (unsigned long) Cuenta);
+			LCD_servicePrint(0, 1, Texto);
+		}
+
+		if (HAL_GetTick() >= Proxima_revision) {
+			Proxima_revision += REVISION_MS;
+			LCD_recover();
+			uint32_t us = microsegundos(Inicio);
+			if (us > Peor_revision) Peor_revision = us;
+		} else {
+			uint32_t Inicio_LCD = LCD_cycles();
+			LCD_animUpdateBudget(&ruedita, PRESUPUESTO_US);
+			uint32_t Gastado = (LCD_cycles() - Inicio_LCD) / LCD_CYCLES_PER_US;
+			if (Gastado < PRESUPUESTO_US) LCD_service(PRESUPUESTO_US - Gastado);
+			uint32_t us = microsegundos(Inicio);
+			if (us > Peor) Peor = us;
+		}
+		Vueltas++;
+		LCD_simAdvance(VUELTA_US * LCD_CYCLES_PER_US);
+	}
+	while (LCD_servicePending() != 0) LCD_service(PRESUPUESTO_US);
+	snprintf(Texto, sizeof(Texto), "%-*lu", 14, (unsigned long) Cuenta);
+	if (LCD_simCell(0, 14, 1) != 1) Fallas++;
+	fila(1, strncat(Texto, "\001*", sizeof(Texto) - strlen(Texto) - 1));
+	printf("service: lazo de main.c, %lu vueltas en %u ms, la más larga %lu us, revisión %lu us\n",
+		(unsigned long) Vueltas, DURACION_MS, (unsigned long) Peor, (unsigned long) Peor_revision);
+	if (Peor > PRESUPUESTO_US || Peor_revision > PRESUPUESTO_US) Fallas++;
+
+	// Toda la pantalla del display, y nada fuera
+	uint8_t Ultima = (uint8_t) (LCD_lines() - 1), Derecha = (uint8_t) (LCD_columns() - 1);
+	LCD_serviceClear();
+	LCD_serviceWrite(Derecha, Ultima, 'Z');
+	LCD_serviceWrite(LCD_columns(), 0, 'X');
+	LCD_serviceWrite(0, LCD_lines(), 'X');
+	while (LCD_servicePending() != 0) LCD_service(PRESUPUESTO_US);
+	if (LCD_simCell(0, Derecha, Ultima) != 'Z' || LCD_simShadowMismatches(0) != 0) {
+		printf("service: no llegó a (%u,%u)\n", Derecha, Ultima);
+		Fallas++;
+	}
+
+	printf("service %ux%u %s: %lu fallas\n", LCD_columns(), LCD_lines(),
+		LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+static uint32_t microsegundos(uint64_t Inicio) {
+	return (uint32_t) ((Sim.cycles - Inicio) / LCD_CYCLES_PER_US);
+}
+
+/*******************************************************************************
+* @brief  Compara una fila del modelo con lo esperado (el resto, espacios)
+* @param  Fila y texto esperado
+* @retval None
+*/
+static void fila(uint8_t row, const char * Esperada) {
+	char Vista[48], Completa[48];
+	snprintf(Completa, sizeof(Completa), "%-*s", LCD_columns(), Esperada);
+	LCD_simRow(0, row, Vista);
+	if (strcmp(Vista, Completa) != 0) {
+		printf("service: fila %u \"%s\", esperaba \"%s\"\n", row, Vista, Completa);
+		Fallas++;
+	}
+}
+
+/***************************************************************END OF FILE****/
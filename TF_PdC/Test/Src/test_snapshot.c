@@ -0,0 +1,198 @@
+/*******************************************************************************
+* @file    test_snapshot.c
+* @author  Guillermo Caporaletti
+* @brief   Pantallas del programa de demostración ("main.c") contra hashes de
+*          referencia. Cada pantalla se dibuja dos veces: desde la sombra del
+*          driver y desde el modelo del HD44780 (DDRAM, CGRAM y cursor del
+*          simulador); las dos tienen que dar el hash de referencia. Si
+*          alguna no coincide, muestra su dibujo en texto. Con "-w" guarda
+*          además cada pantalla como build/snapshot-<n>.pgm, para revisarla
+*          y actualizar las referencias.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <LCD_sim.h>
+#include <LCD_snapshot.h>
+#include <LCD_bank.h>
+#include <LCD_anim.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define PANTALLAS		5
+
+/* Private variables ---------------------------------------------------------*/
+
+// Imágenes de referencia (revisadas a ojo con "-w"), para un 16x2
+static const struct {
+	const char * nombre;
+	uint32_t hash;
+} Referencias[PANTALLAS] = {
+	{"inicio, cursor y parpadeo",	0x6F04FEC8UL},
+	{"Hola terricolas",				0x03406EA8UL},
+	{"Como estan?",					0xA56594E8UL},
+	{"cuenta, Alf y ruedita |",		0x5CDF88E8UL},
+	{"ruedita /",					0x7C81CC68UL},
+};
+
+// Lo mismo que dibuja "main.c"
+static const LCDglyph Glifos[] = {
+	LCD_GLYPH(0b10001, 0b10001, 0b01110, 0b10101, 0b11111, 0b11111, 0b01110, 0b11011)
+};
+static const LCDglyphBank Banco = {Glifos, 0, 1};
+
+static const LCDanimRow Ruedita_barra[] = {
+	{0x08, 0x00}, {0x09, 0x04}, {0x0A, 0x04}, {0x0B, 0x04},
+	{0x0C, 0x04}, {0x0D, 0x04}, {0x0E, 0x00}, {0x0F, 0x00}
+};
+static const LCDanimCell Ruedita_lugar[] = {{14, 1, 1}};
+static const LCDanimRow Ruedita_a_diagonal[] = {
+	{0x09, 0x01}, {0x0A, 0x02}, {0x0C, 0x08}, {0x0D, 0x10}
+};
+static const LCDanimFrame Ruedita_cuadros[] = {
+	{150, Ruedita_barra, LCD_ANIM_COUNT(Ruedita_barra), Ruedita_lugar, LCD_ANIM_COUNT(Ruedita_lugar)},
+	{150, Ruedita_a_diagonal, LCD_ANIM_COUNT(Ruedita_a_diagonal), NULL, 0},
+};
+static const LCDanimation Ruedita = {Ruedita_cuadros, 2, 0};
+static LCDanimPlayer ruedita;
+
+static bool Guardar = false;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static uint8_t sim_address(uint8_t col, uint8_t row);
+static uint8_t sim_cell(uint8_t col, uint8_t row);
+static uint8_t sim_cgram(uint8_t address);
+static bool sim_cursor(uint8_t col, uint8_t row);
+static bool comparar(uint8_t Pantalla);
+static void animar(void);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(int argc, char * argv[]) {
+	uint8_t Fallas = 0;
+	Guardar = (argc > 1 && strcmp(argv[1], "-w") == 0);
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	if (LCD_columns() != 16 || LCD_lines() != 2) {
+		printf("snapshot: las referencias son de un 16x2\n");
+		return 1;
+	}
+	LCD_deferControl(true);
+	LCD_bankLoad(&Banco);
+
+	LCD_home();
+	LCD_cursor();
+	LCD_blink();
+	LCD_flush();
+	Fallas += !comparar(0);
+
+	LCD_setCursor(0, 0);
+	LCD_print("Hola terricolas");
+	LCD_flush();
+	Fallas += !comparar(1);
+
+	LCD_setCursor(0, 1);
+	LCD_print("Como estan?");
+	LCD_flush();
+	Fallas += !comparar(2);
+
+	LCD_clear();
+	LCD_print("Vamos en camino!");
+	LCD_setCursor(0, 1);
+	LCD_noCursor();
+	LCD_noBlink();
+	LCD_print("4294967295");
+	LCD_setCursor(15, 1);
+	LCD_write(0);
+	LCD_animStart(&ruedita, &Ruedita);
+	animar();
+	Fallas += !comparar(3);
+
+	LCD_simAdvance(150UL * 1000UL * LCD_CYCLES_PER_US);
+	animar();
+	Fallas += !comparar(4);
+
+	printf("snapshot %s: %u pantallas, %u fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", PANTALLAS, Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Compara una pantalla, desde la sombra y desde el modelo, con su hash
+* @param  Número de pantalla
+* @retval true si las dos coinciden con la referencia
+*/
+static bool comparar(uint8_t Pantalla) {
+	static char Texto[LCD_SNAPSHOT_TEXT_SIZE(16, 2)];
+	const LCDsnapshotSource Modelo = {LCD_columns(), LCD_lines(), sim_cell, sim_cgram, sim_cursor};
+	uint32_t Sombra = LCD_snapshotHash(NULL);
+	uint32_t Display = LCD_snapshotHash(&Modelo);
+	bool Bien = (Sombra == Referencias[Pantalla].hash && Display == Referencias[Pantalla].hash);
+
+	if (Guardar) {
+		static uint8_t Imagen[LCD_SNAPSHOT_PGM_SIZE(16, 2)];
+		char Archivo[32];
+		size_t Largo = LCD_snapshotPGM(&Modelo, Imagen, sizeof(Imagen));
+		snprintf(Archivo, sizeof(Archivo), "build/snapshot-%u.pgm", Pantalla);
+		FILE * f = fopen(Archivo, "wb");
+		if (f != NULL) {
+			fwrite(Imagen, 1, Largo, f);
+			fclose(f);
+		}
+	}
+	if (!Bien) {
+		printf("pantalla %u (%s): referencia 0x%08lX, sombra 0x%08lX, display 0x%08lX\n", Pantalla,
+			Referencias[Pantalla].nombre, (unsigned long) Referencias[Pantalla].hash,
+			(unsigned long) Sombra, (unsigned long) Display);
+		LCD_snapshotText(&Modelo, Texto, sizeof(Texto));
+		printf("%s", Texto);
+	}
+	return Bien;
+}
+
+/*******************************************************************************
+* @brief  Envía el cuadro actual de la ruedita entero
+* @param  None
+* @retval None
+*/
+static void animar(void) {
+	LCD_animUpdate(&ruedita);
+	for (uint8_t i=0; i<8 && ruedita.sending; i++) LCD_animUpdate(&ruedita);
+	if (!ruedita.sending) return;
+	printf("snapshot: la ruedita no terminó el cuadro\n");
+	exit(1);
+}
+
+/*******************************************************************************
+* @brief  Dirección de DDRAM que se ve en una posición del display 0
+* @param  Columna y fila
+* @retval Dirección
+*/
+static uint8_t sim_address(uint8_t col, uint8_t row) {
+	const LCDsimDisplay * d = &Sim.display[0];
+	int32_t Largo = d->two_lines ? 40 : 80;
+	int32_t Posicion = ((int32_t) col + ((row >= 2) ? LCD_columns() : 0) + d->shift) % Largo;
+	if (Posicion < 0) Posicion += Largo;
+	return (uint8_t) (((d->two_lines && (row & 1)) ? 0x40 : 0x00) + Posicion);
+}
+
+static uint8_t sim_cell(uint8_t col, uint8_t row) {
+	return LCD_simCell(0, col, row);
+}
+
+static uint8_t sim_cgram(uint8_t address) {
+	return Sim.display[0].cgram[address & 0x3F];
+}
+
+static bool sim_cursor(uint8_t col, uint8_t row) {
+	const LCDsimDisplay * d = &Sim.display[0];
+	if ((d->control & (LCD_DISPLAYON | LCD_CURSORON)) != (LCD_DISPLAYON | LCD_CURSORON)) return false;
+	return !d->cgram_selected && d->ac == sim_address(col, row);
+}
+
+/***************************************************************END OF FILE****/
@@ -0,0 +1,152 @@
+/*******************************************************************************
+* @file    test_spark.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_spark contra el modelo del HD44780, con un gráfico de 8
+*          caracteres, con puntos y con barras:
+*          - luego de cada muestra, lo que se ve (los códigos en pantalla y
+*            sus glifos en la CGRAM del modelo) es el gráfico de las últimas
+*            40 muestras;
+*          - cada muestra envía a lo sumo las 8 filas de un caracter, y en
+*            promedio unas pocas transferencias, no las 72 de recargar los 8
+*            glifos con LCD_createChar();
+*          - LCD_sparkDraw() repone sólo el lugar que otro módulo pisó.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_spark.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define COLUMNA			4
+#define ANCHO			LCD_SPARK_MAX_WIDTH
+#define MUESTRAS		400
+#define MINIMO			0
+#define MAXIMO			100
+#define RECARGAR		(ANCHO * (LCD_SPARK_GLYPH_ROWS + 1))	// LCD_createChar() de cada lugar
+
+/* Private variables ---------------------------------------------------------*/
+
+static int16_t Historia[MUESTRAS];
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static int16_t senal(uint32_t n);
+static void grafico(const LCDspark * Grafico, uint32_t n, const char * Caso);
+static uint32_t escrituras(void);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	for (uint8_t b=0; b<2; b++) {
+		bool Barras = (b == 1);
+		const char * Caso = Barras ? "barras" : "puntos";
+		LCDspark Grafico;
+
+		LCD_clear();
+		LCD_sparkInit(&Grafico, COLUMNA, 1, 0, ANCHO, MINIMO, MAXIMO, Barras);
+		uint32_t Total = 0, Peor = 0, PeorFilas = 0;
+		for (uint32_t n=0; n<MUESTRAS; n++) {
+			Historia[n] = senal(n);
+			uint32_t Filas = Grafico.rows_sent;
+			LCD_simZero();
+			LCD_sparkAdd(&Grafico, Historia[n]);
+			Total += escrituras();
+			if (escrituras() > Peor) Peor = escrituras();
+			if (Grafico.rows_sent - Filas > PeorFilas) PeorFilas = Grafico.rows_sent - Filas;
+			grafico(&Grafico, n + 1, Caso);
+		}
+		printf("spark: %s, %.1f transferencias por muestra (la peor %lu, a lo sumo %lu filas de CGRAM; recargar: %u)\n",
+			Caso, (double) Total / MUESTRAS, (unsigned long) Peor, (unsigned long) PeorFilas, RECARGAR);
+		revisar(PeorFilas <= LCD_SPARK_GLYPH_ROWS, "una muestra envía a lo sumo las filas de un caracter");
+		revisar(Total < MUESTRAS * 10, "una muestra cuesta unas pocas transferencias");
+		revisar(Peor < RECARGAR / 3, "ni siquiera al rotar se acerca a recargar los glifos");
+
+		// Otro módulo pisa un lugar: LCD_sparkDraw() repone sólo ese
+		static const uint8_t Ajeno[8] = {0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F, 0x00};
+		LCD_createChar(2, Ajeno);
+		LCD_simZero();
+		LCD_sparkDraw(&Grafico);
+		revisar(Sim.display[0].data <= LCD_SPARK_GLYPH_ROWS && Sim.display[0].commands <= 2,
+			"LCD_sparkDraw() repone sólo el lugar pisado");
+		grafico(&Grafico, MUESTRAS, Caso);
+		LCD_simZero();
+		LCD_sparkDraw(&Grafico);
+		revisar(escrituras() == 0, "LCD_sparkDraw() sin cambios no envía nada");
+	}
+
+	revisar(LCD_simShadowMismatches(0) == 0, "la sombra coincide con la DDRAM");
+	printf("spark %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Valor de un sensor: un triángulo lento con escalones y tramos quietos
+* @param  Número de muestra
+* @retval Valor
+*/
+static int16_t senal(uint32_t n) {
+	uint32_t Fase = n % 60;
+	if (Fase >= 50) return 50;
+	int16_t Valor = (int16_t) ((Fase < 25) ? Fase * 4 : (50 - Fase) * 4);
+	return (int16_t) (Valor + ((n % 7 == 0) ? 10 : 0) - 5);
+}
+
+/*******************************************************************************
+* @brief  Compara lo que se ve (códigos en pantalla y sus glifos en la CGRAM
+*         del modelo) con el gráfico de las últimas muestras
+* @param  Gráfico, muestras agregadas y caso (para el reporte)
+* @retval None
+* @note   La muestra más nueva está en la columna fill del caracter de la
+*         derecha; a su derecha, vacío.
+*/
+static void grafico(const LCDspark * Grafico, uint32_t n, const char * Caso) {
+	int32_t Ultima = (ANCHO - 1) * LCD_SPARK_GLYPH_COLS + Grafico->fill - 1;
+	for (uint8_t i=0; i<ANCHO; i++) {
+		uint8_t Codigo = LCD_simCell(0, COLUMNA + i, 1);
+		for (uint8_t Fila=0; Fila<LCD_SPARK_GLYPH_ROWS; Fila++) {
+			uint8_t Esperada = 0;
+			for (uint8_t x=0; x<LCD_SPARK_GLYPH_COLS; x++) {
+				int32_t Muestra = (int32_t) n - 1 - (Ultima - (i * LCD_SPARK_GLYPH_COLS + x));
+				uint8_t Punto = 0;
+				if (Muestra >= 0 && Muestra < (int32_t) n && Ultima >= i * LCD_SPARK_GLYPH_COLS + x) {
+					int16_t Valor = Historia[Muestra];
+					if (Valor < MINIMO) Valor = MINIMO;
+					if (Valor > MAXIMO) Valor = MAXIMO;
+					int32_t Nivel = ((Valor - MINIMO) * (LCD_SPARK_GLYPH_ROWS - 1) + (MAXIMO - MINIMO) / 2) / (MAXIMO - MINIMO);
+					int32_t Arriba = LCD_SPARK_GLYPH_ROWS - 1 - Fila;	// Nivel de esta fila
+					Punto = Grafico->bars ? (Nivel >= Arriba) : (Nivel == Arriba);
+				}
+				Esperada = (uint8_t) ((Esperada << 1) | Punto);
+			}
+			uint8_t Vista = (Codigo < 8) ? (Sim.display[0].cgram[Codigo * 8 + Fila] & 0x1F) : 0xFF;
+			if (Vista == Esperada) continue;
+			printf("spark: %s, muestra %lu, caracter %u (código %u), fila %u: 0x%02X, esperaba 0x%02X\n",
+				Caso, (unsigned long) n, i, Codigo, Fila, Vista, Esperada);
+			Fallas++;
+			return;
+		}
+	}
+}
+
+static uint32_t escrituras(void) {
+	return Sim.display[0].commands + Sim.display[0].data;
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("spark: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
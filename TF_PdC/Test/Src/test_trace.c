@@ -0,0 +1,195 @@
+/*******************************************************************************
+* @file    test_trace.c
+* @author  Guillermo Caporaletti
+* @brief   LCD_trace (compilando con LCD_TRACE) contra el modelo del HD44780:
+*          - una secuencia común (comandos, texto, un glifo y lecturas)
+*            queda registrada y LCD_traceCheck() no encuentra violaciones,
+*            habiendo medido cada uno de los tiempos;
+*          - con un perfil acortado a propósito, LCD_traceCheck() marca
+*            cada pulso de E como corto;
+*          - LCD_traceDumpVCD() entrega un encabezado y cambios de valor que
+*            se pueden leer: tiempos crecientes, señales declaradas y tantos
+*            flancos de subida de E como pulsos (escrituras y lecturas) vio
+*            el modelo.
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <LCD_sim.h>
+#include <LCD_trace.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define VCD_MAX		(64 * 1024)
+
+/* Private variables ---------------------------------------------------------*/
+
+static const char * const Controles[LCD_TRACE_CHECKS] = {"tAS", "PWEH", "tDSW", "tH", "tcycE"};
+static const uint8_t Flecha[8] = {0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00};
+
+static char Vcd[VCD_MAX];
+static size_t Vcd_largo = 0;
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void secuencia(void);
+static void salida(const char * Texto, size_t Largo);
+static void vcd(void);
+static void revisar(bool Bien, const char * Que);
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCDtraceReport Reporte;
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+
+	// Una secuencia común, con el perfil de la hoja de datos
+	LCD_traceClear();
+	LCD_simZero();
+	secuencia();
+	revisar(LCD_traceCount() > 0 && LCD_traceCount() < LCD_TRACE_SIZE, "la secuencia entra en el registro");
+	revisar(LCD_traceCheck(&Reporte) == 0, "una secuencia común no tiene violaciones");
+	for (uint8_t c=0; c<LCD_TRACE_CHECKS; c++) {
+		printf("trace: %-5s el menor %lu ns\n", Controles[c], (unsigned long) Reporte.worst_ns[c]);
+		if (Reporte.worst_ns[c] != UINT32_MAX) continue;
+		printf("trace: %s no se midió\n", Controles[c]);
+		Fallas++;
+	}
+
+	// El registro, como VCD
+	Vcd_largo = 0;
+	LCD_traceDumpVCD(salida);
+	vcd();
+
+	// Un perfil acortado a propósito: el pulso de E queda corto
+	LCDtiming Original = *LCD_getTiming();
+	LCDtiming Corto = Original;
+	Corto.pweh_ns = 20;
+	LCD_setTiming(&Corto);
+	LCD_traceClear();
+	LCD_simZero();
+	LCD_setCursor(0, 1);
+	LCD_print("corto");
+	uint32_t Violaciones = LCD_traceCheck(&Reporte);
+	printf("trace: perfil acortado, %lu violaciones (PWEH %lu, el menor %lu ns)\n", (unsigned long) Violaciones,
+		(unsigned long) Reporte.violations[LCD_TRACE_PULSE], (unsigned long) Reporte.worst_ns[LCD_TRACE_PULSE]);
+	revisar(Violaciones == Reporte.violations[LCD_TRACE_PULSE] && Violaciones == Sim.display[0].pulses
+		&& Reporte.worst_ns[LCD_TRACE_PULSE] < LCD_T_PWEH_NS, "con el perfil acortado se marca cada pulso de E");
+
+	// De vuelta al perfil de la hoja de datos, sin violaciones
+	LCD_setTiming(&Original);
+	LCD_traceClear();
+	LCD_setCursor(0, 1);
+	LCD_print("normal");
+	revisar(LCD_traceCheck(NULL) == 0, "con el perfil original vuelve a no haber violaciones");
+
+	printf("trace %s: %lu fallas\n", LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Clear, texto y un glifo; luego, registrando, el glifo en pantalla,
+*         lecturas de DDRAM y del AC, y más texto
+* @param  None
+* @retval None
+*/
+static void secuencia(void) {
+	LCD_clear();
+	LCD_print("Hola");
+	LCD_createChar(1, Flecha);
+	LCD_traceClear();		// <-- Lo anterior no entra en el registro
+	LCD_simZero();
+	LCD_setCursor(0, 1);
+	LCD_write(1);
+	LCD_setCursor(0, 0);
+	revisar(LCD_data_read() == 'H', "LCD_data_read() lee la DDRAM");
+	revisar(LCD_address_read() == 1, "LCD_address_read() lee el AC");
+	LCD_print("ola!");
+}
+
+/*******************************************************************************
+* @brief  Salida de texto del volcado: lo junta en memoria
+* @param  Texto y largo
+* @retval None
+*/
+static void salida(const char * Texto, size_t Largo) {
+	if (Vcd_largo + Largo >= VCD_MAX) {
+		Fallas++;
+		return;
+	}
+	memcpy(&Vcd[Vcd_largo], Texto, Largo);
+	Vcd_largo += Largo;
+	Vcd[Vcd_largo] = '\0';
+}
+
+/*******************************************************************************
+* @brief  Lee el VCD juntado: encabezado, y luego tiempos y cambios de valor
+* @param  None
+* @retval None
+* @note   En el encabezado, cada $var declara una señal de 1 bit con un
+*         caracter de identificador. Después, "#t" con t creciente y "vX"
+*         con v 0 o 1 y X una señal declarada.
+*/
+static void vcd(void) {
+	char Declaradas[128] = {0};
+	char Id_E = 0;
+	bool Escala = false, Fin_encabezado = false;
+	uint32_t Variables = 0, Cambios = 0, Subidas_E = 0, Tiempos = 0, Malas = 0;
+	unsigned long Anterior = 0;
+	char Valor_E = '0';
+
+	for (char * Linea = strtok(Vcd, "\n"); Linea != NULL; Linea = strtok(NULL, "\n")) {
+		char Id, Nombre[16];
+		if (!Fin_encabezado) {
+			if (strcmp(Linea, "$timescale 1ns $end") == 0) Escala = true;
+			else if (sscanf(Linea, "$var wire 1 %c %15s $end", &Id, Nombre) == 2 && Id > ' ' && Id < 127) {
+				Declaradas[(uint8_t) Id] = 1;
+				if (strcmp(Nombre, "E") == 0) Id_E = Id;
+				Variables++;
+			} else if (strcmp(Linea, "$enddefinitions $end") == 0) Fin_encabezado = true;
+			else if (strncmp(Linea, "$scope", 6) != 0 && strncmp(Linea, "$upscope", 8) != 0) Malas++;
+			continue;
+		}
+
+		if (Linea[0] == '#') {
+			char * Resto;
+			unsigned long t = strtoul(Linea + 1, &Resto, 10);
+			if (*Resto != '\0' || Resto == Linea + 1 || (Tiempos > 0 && t <= Anterior) || (Tiempos == 0 && t != 0)) Malas++;
+			Anterior = t;
+			Tiempos++;
+		} else if ((Linea[0] == '0' || Linea[0] == '1') && strlen(Linea) == 2 && Declaradas[(uint8_t) Linea[1]]) {
+			if (Linea[1] == Id_E) {
+				if (Linea[0] == '1' && Valor_E == '0') Subidas_E++;
+				Valor_E = Linea[0];
+			}
+			Cambios++;
+		} else {
+			Malas++;
+		}
+	}
+
+	printf("trace: VCD de %lu bytes, %lu señales, %lu tiempos, %lu cambios (%lu subidas de E)\n",
+		(unsigned long) Vcd_largo, (unsigned long) Variables, (unsigned long) Tiempos,
+		(unsigned long) Cambios, (unsigned long) Subidas_E);
+	revisar(Escala && Fin_encabezado && Variables == 12 && Id_E != 0, "el VCD tiene encabezado");
+	revisar(Malas == 0, "cada línea del VCD se puede leer");
+	revisar(Cambios == LCD_traceCount() && Tiempos > 0, "un cambio de valor por evento registrado");
+	uint32_t Pulsos = Sim.display[0].pulses + Sim.display[0].reads * (LCD_SIM_FOUR_WIRES ? 2 : 1);
+	revisar(Subidas_E == Pulsos, "una subida de E por cada pulso de escritura y de lectura del modelo");
+}
+
+static void revisar(bool Bien, const char * Que) {
+	if (Bien) return;
+	printf("trace: falla: %s\n", Que);
+	Fallas++;
+}
+
+/***************************************************************END OF FILE****/
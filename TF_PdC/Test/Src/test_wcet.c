@@ -0,0 +1,427 @@
+/*******************************************************************************
+* @file    test_wcet.c
+* @author  Guillermo Caporaletti
+* @brief   Cotas de LCD_wcetTable() contra el modelo del HD44780, con el busy
+*          flag real. Cada función pública se mide sola, en el peor caso que
+*          se puede armar para ella (textos largos, la pantalla y la CGRAM
+*          llenas, el display desplazado), y en cuatro situaciones:
+*          - con el display listo;
+*          - justo después de un home, con comandos diferidos pendientes;
+*          - lo mismo, esperando el home por interrupción (LCD_busyEvent);
+*          - lo mismo, con el display trabado en busy.
+*          Las de displaycontrol y el modo de escritura se miden sin diferir
+*          (LCD_deferControl(false) manda antes lo pendiente).
+*          Lo medido no puede pasar la cota de su fila (tiempo, y
+*          escrituras al display más cargado), y LCD_printn tampoco la
+*          de LCD_wcetPrint().
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <LCD_sim.h>
+#include <LCD_wcet.h>
+#include <LCD_service.h>
+#include <LCD_console.h>
+#include <LCD_mirror.h>
+#include <LCD_charset.h>
+#include <LCD_field.h>
+#include <LCD_scrub.h>
+#include <LCD_spark.h>
+#include <LCD_bank.h>
+#include <LCD_anim.h>
+#include <LCD_plan.h>
+#include <LCD_queue.h>
+
+/* Private macros ------------------------------------------------------------*/
+
+#define SITUACIONES		4
+#define LARGO			120		// Más que LCD_PRINT_MAX
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct {
+	const char * nombre;
+	LCDwcetApi fila;
+	void (*preparar)(void);		// Estado de peor caso, antes de medir
+	void (*medir)(void);
+} Caso;
+
+/* Private variables ---------------------------------------------------------*/
+
+static const uint8_t Lleno[8] = {0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00};
+static const uint8_t Pisado[8] = {0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A};
+static const LCDglyph Rayado[8] = {
+	LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15), LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15),
+	LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15), LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15),
+	LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15), LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15),
+	LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15), LCD_GLYPH(0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15),
+};
+static const LCDglyphBank Banco = {Rayado, 0, 8};
+// Un cuadro con LCD_ANIM_BUDGET cambios, ninguno donde quedó el anterior
+static const LCDanimRow Filas_anim[] = {{0x00, 0x1F}, {0x09, 0x1F}, {0x12, 0x1F}, {0x1B, 0x1F}};
+static const LCDanimCell Celdas_anim[] = {{0, 0, '0'}, {2, 1, '1'}, {4, 0, '2'}, {6, 1, '3'}};
+static const LCDanimFrame Cuadro_anim[] = {
+	{100, Filas_anim, LCD_ANIM_COUNT(Filas_anim), Celdas_anim, LCD_ANIM_COUNT(Celdas_anim)},
+};
+static const LCDanimation Animacion = {Cuadro_anim, 1, LCD_ANIM_ONCE};
+static const char * const Situacion[SITUACIONES] = {"listo", "home", "interrupción", "trabado"};
+static char Texto[LARGO + 1];
+static char Utf8[2 * LARGO];		// Glifos para todos los lugares, y más texto
+static LCDspark Grafico;
+static LCDanimPlayer Jugador;
+static uint32_t Fallas = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+
+static void nada(void);
+static void llenar(void);
+static void consola(void);
+static void anotar(void);
+static void otro_display(void);
+static void cortar(void);
+static void glifos(void);
+static void campos(void);
+static void corromper(void);
+static void grafico(void);
+static void grafico_pisado(void);
+static void pisar_cgram(void);
+static void animar(void);
+static void encolar(void);
+static void medir_write(void) { LCD_write('x'); }
+static void medir_command(void) { LCD_command(LCD_SETDDRAMADDR | 0x27); }
+static void medir_setCursor(void) { LCD_setCursor(LCD_columns() - 1, LCD_lines() - 1); }
+static void medir_scrollLeft(void) { LCD_scrollDisplayLeft(); }
+static void medir_scrollRight(void) { LCD_scrollDisplayRight(); }
+static void medir_data_read(void) { LCD_data_read(); }
+static void medir_address_read(void) { LCD_address_read(); }
+static void medir_busy_flag(void) { LCD_busy_flag(); }
+static void medir_print(void) { LCD_print(Texto); }
+static void medir_clear(void) { LCD_clear(); }
+static void medir_home(void) { LCD_home(); }
+static void medir_display(void) { LCD_deferControl(false); LCD_display(); }
+static void medir_cursor(void) { LCD_deferControl(false); LCD_cursor(); }
+static void medir_noBlink(void) { LCD_deferControl(false); LCD_noBlink(); }
+static void medir_leftToRight(void) { LCD_deferControl(false); LCD_leftToRight(); }
+static void medir_autoscroll(void) { LCD_deferControl(false); LCD_autoscroll(); }
+static void medir_flush(void) { LCD_flush(); }
+static void medir_createChar(void) { LCD_createChar(7, Lleno); }
+static void medir_glyphRow(void) { LCD_glyphRow(LCD_CGRAM_SIZE - 1, 0x15); }
+static void medir_printScreen(void);
+static void medir_restore(void) { LCD_restore(); }
+static void medir_lost(void) { LCD_lost(); }
+static void medir_autotune(void) { LCD_autotune(NULL); }
+static void medir_service(void) { LCD_service(LCD_WCET_BUDGET_US); }
+static void medir_consolePrint(void) { LCD_consolePrint(Texto); }
+static void medir_consoleFlush(void) { LCD_consoleFlush(); }
+static void medir_mirrorWrite(void) { LCD_mirrorWrite(LCD_MIRROR_ALL, 0, 0, 'x'); }
+static void medir_mirrorPrint(void) { LCD_mirrorPrint(LCD_MIRROR_ALL, 0, 0, Texto); }
+static void medir_mirrorCopy(void) { LCD_mirrorCopy(1 % LCD_displays(), LCD_MIRROR_ALL); }
+static void medir_recover(void) { LCD_recover(); }
+static void medir_resync(void) { LCD_resync(); }
+static void medir_printUTF8(void) { LCD_printUTF8(Utf8); }
+static void medir_translate(void) { LCD_translate(0x00E1); }
+static void medir_fieldUpdate(void) { LCD_fieldUpdate(); }
+static void medir_scrub(void) { LCD_scrub(LCD_WCET_SCRUB_US); }
+static void medir_sparkAdd(void) { LCD_sparkAdd(&Grafico, 0); }
+static void medir_sparkDraw(void) { LCD_sparkDraw(&Grafico); }
+static void medir_bankLoad(void) { LCD_bankLoad(&Banco); }
+static void medir_animUpdate(void) { LCD_animUpdate(&Jugador); }
+static void medir_animUpdateBudget(void) { LCD_animUpdateBudget(&Jugador, LCD_WCET_BUDGET_US); }
+static void medir_planRun(void);
+static void medir_planUpdate(void);
+static void medir_queueService(void) { LCD_queueService(LCD_WCET_QUEUE_OPS); }
+static void correr(const Caso * c, uint8_t s, uint32_t * us, uint32_t * k);
+
+/* Private variables ---------------------------------------------------------*/
+
+static const Caso Casos[] = {
+	{"LCD_write", LCD_WCET_WRITE, nada, medir_write},
+	{"LCD_command", LCD_WCET_WRITE, nada, medir_command},
+	{"LCD_setCursor", LCD_WCET_WRITE, nada, medir_setCursor},
+	{"LCD_scrollDisplayLeft", LCD_WCET_WRITE, nada, medir_scrollLeft},
+	{"LCD_scrollDisplayRight", LCD_WCET_WRITE, nada, medir_scrollRight},
+	{"LCD_data_read", LCD_WCET_READ, llenar, medir_data_read},
+	{"LCD_address_read", LCD_WCET_READ, nada, medir_address_read},
+	{"LCD_busy_flag", LCD_WCET_READ, nada, medir_busy_flag},
+	{"LCD_print", LCD_WCET_PRINT, nada, medir_print},
+	{"LCD_clear", LCD_WCET_CLEAR, llenar, medir_clear},
+	{"LCD_home", LCD_WCET_CLEAR, llenar, medir_home},
+	{"LCD_display", LCD_WCET_CONTROL, nada, medir_display},
+	{"LCD_cursor", LCD_WCET_CONTROL, nada, medir_cursor},
+	{"LCD_noBlink", LCD_WCET_CONTROL, nada, medir_noBlink},
+	{"LCD_leftToRight", LCD_WCET_MODE, nada, medir_leftToRight},
+	{"LCD_autoscroll", LCD_WCET_MODE, nada, medir_autoscroll},
+	{"LCD_flush", LCD_WCET_MODE, nada, medir_flush},
+	{"LCD_createChar", LCD_WCET_CREATECHAR, nada, medir_createChar},
+	{"LCD_glyphRow", LCD_WCET_GLYPHROW, nada, medir_glyphRow},
+	{"LCD_printScreen", LCD_WCET_PRINTSCREEN, llenar, medir_printScreen},
+	{"LCD_restore", LCD_WCET_RESTORE, llenar, medir_restore},
+	{"LCD_lost", LCD_WCET_LOST, llenar, medir_lost},
+	{"LCD_autotune", LCD_WCET_AUTOTUNE, llenar, medir_autotune},
+	{"LCD_service", LCD_WCET_SERVICE, anotar, medir_service},
+	{"LCD_consolePrint", LCD_WCET_CONSOLE, consola, medir_consolePrint},
+	{"LCD_consoleFlush", LCD_WCET_CONSOLE, consola, medir_consoleFlush},
+	{"LCD_mirrorWrite", LCD_WCET_MIRROR_WRITE, nada, medir_mirrorWrite},
+	{"LCD_mirrorPrint", LCD_WCET_MIRROR_PRINT, nada, medir_mirrorPrint},
+	{"LCD_mirrorCopy", LCD_WCET_MIRROR_COPY, otro_display, medir_mirrorCopy},
+	{"LCD_recover", LCD_WCET_RECOVER, cortar, medir_recover},
+	{"LCD_resync", LCD_WCET_RESYNC, nada, medir_resync},
+	{"LCD_printUTF8", LCD_WCET_UTF8, glifos, medir_printUTF8},
+	{"LCD_translate", LCD_WCET_TRANSLATE, glifos, medir_translate},
+	{"LCD_fieldUpdate", LCD_WCET_FIELD, campos, medir_fieldUpdate},
+	{"LCD_scrub", LCD_WCET_SCRUB, corromper, medir_scrub},
+	{"LCD_sparkAdd", LCD_WCET_SPARK_ADD, grafico, medir_sparkAdd},
+	{"LCD_sparkDraw", LCD_WCET_SPARK_DRAW, grafico_pisado, medir_sparkDraw},
+	{"LCD_bankLoad", LCD_WCET_BANK, pisar_cgram, medir_bankLoad},
+	{"LCD_animUpdate", LCD_WCET_ANIM, animar, medir_animUpdate},
+	{"LCD_animUpdateBudget", LCD_WCET_ANIM, animar, medir_animUpdateBudget},
+	{"LCD_planRun", LCD_WCET_PLAN, llenar, medir_planRun},
+	{"LCD_planUpdate", LCD_WCET_PLAN, llenar, medir_planUpdate},
+	{"LCD_queueService", LCD_WCET_QUEUE, encolar, medir_queueService},
+};
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+	LCDwcetRow Tabla[LCD_WCET_ROWS];
+	uint32_t Peor_us[LCD_WCET_ROWS] = {0}, Peor_k[LCD_WCET_ROWS] = {0};
+
+	for (uint8_t i=0; i<LARGO; i++) Texto[i] = (char) ('A' + i % 26);
+	Texto[LARGO] = '\0';
+	snprintf(Utf8, sizeof(Utf8), "ÁÉÍÓÚ¿¡ñ%s", Texto);
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	LCD_wcetTable(LCD_getTiming(), LCD_SIM_FOUR_WIRES, Tabla);
+
+	// Cada función, en cada situación
+	for (size_t i=0; i<sizeof(Casos)/sizeof(Casos[0]); i++) {
+		const Caso * c = &Casos[i];
+		for (uint8_t s=0; s<SITUACIONES; s++) {
+			uint32_t us, k;
+			correr(c, s, &us, &k);
+			if (us > Peor_us[c->fila]) Peor_us[c->fila] = us;
+			if (k > Peor_k[c->fila]) Peor_k[c->fila] = k;
+			if (us <= Tabla[c->fila].bound_us && k <= Tabla[c->fila].transfers) continue;
+			printf("wcet: %s (%s): %lu us y %lu transferencias, la cota es %lu us y %u\n", c->nombre, Situacion[s],
+				(unsigned long) us, (unsigned long) k, (unsigned long) Tabla[c->fila].bound_us, Tabla[c->fila].transfers);
+			Fallas++;
+		}
+	}
+
+	// LCD_printn no tiene tope: su cota es la de LCD_wcetPrint()
+	for (uint8_t s=0; s<SITUACIONES; s++) {
+		static const Caso Printn = {"LCD_printn", LCD_WCET_PRINT, nada, NULL};
+		uint32_t us, k;
+		correr(&Printn, s, &us, &k);
+		uint32_t Cota = LCD_wcetPrint(LCD_getTiming(), LCD_SIM_FOUR_WIRES, LARGO);
+		if (us > Cota) {
+			printf("wcet: LCD_printn(%u) (%s): %lu us, la cota es %lu us\n", LARGO, Situacion[s], (unsigned long) us, (unsigned long) Cota);
+			Fallas++;
+		}
+	}
+
+	for (uint8_t i=0; i<LCD_WCET_ROWS; i++) {
+		printf("wcet: %-58s %5u/%5lu transf. %6lu/%6lu us\n", Tabla[i].name, Tabla[i].transfers, (unsigned long) Peor_k[i],
+			(unsigned long) Tabla[i].bound_us, (unsigned long) Peor_us[i]);
+	}
+	printf("wcet %ux%u %s, %u display%s: %lu fallas\n", LCD_columns(), LCD_lines(), LCD_SIM_FOUR_WIRES ? "4 bits" : "8 bits",
+		LCD_displays(), LCD_displays() > 1 ? "s" : "", (unsigned long) Fallas);
+	return (Fallas == 0) ? 0 : 1;
+}
+
+/* Funciones privadas --------------------------------------------------------*/
+
+/*******************************************************************************
+* @brief  Mide una función en una situación, desde un display recién iniciado
+* @param  Caso, situación, y dónde dejar los us y las transferencias del
+*         escritas al display que más recibió
+* @retval None
+* @note   LCD_printn, si el caso no tiene función para medir.
+*/
+static void correr(const Caso * c, uint8_t s, uint32_t * us, uint32_t * k) {
+	uint32_t Antes[LCD_MAX_DISPLAYS];
+
+	LCD_simReset(LCD_SIM_FOUR_WIRES);
+	LCD_init();
+	Sim.busy_model = true;
+	c->preparar();
+
+	// Comandos diferidos: displaycontrol en los dos grupos y el modo de escritura
+	LCD_autoscroll();
+	LCD_deferControl(true);
+	LCD_noDisplay();
+	LCD_blink();
+	LCD_noAutoscroll();
+	if (s >= 2) LCD_busyEvent(true);
+	if (s >= 1) LCD_home();
+	if (s >= 3) {
+		for (uint8_t d=0; d<LCD_displays(); d++) Sim.display[d].busy_until = Sim.cycles + 1000000UL * LCD_CYCLES_PER_US;
+	}
+
+	for (uint8_t d=0; d<LCD_displays(); d++) {
+		Antes[d] = Sim.display[d].commands + Sim.display[d].data;
+	}
+	uint64_t Inicio = Sim.cycles;
+	if (c->medir != NULL) c->medir();
+	else LCD_printn(Texto, LARGO);
+	*us = (uint32_t) ((Sim.cycles - Inicio) / LCD_CYCLES_PER_US);
+
+	*k = 0;
+	for (uint8_t d=0; d<LCD_displays(); d++) {
+		uint32_t n = Sim.display[d].commands + Sim.display[d].data - Antes[d];
+		if (n > *k) *k = n;
+	}
+	LCD_busyEvent(false);
+}
+
+static void nada(void) {
+}
+
+/*******************************************************************************
+* @brief  Peor caso para reponer: toda la DDRAM y la CGRAM con datos que no se
+*         pueden encadenar, y el display desplazado a la mitad
+* @param  None
+* @retval None
+*/
+static void llenar(void) {
+	for (uint8_t d=0; d<LCD_displays(); d++) {
+		LCD_select(1U << d);
+		for (uint8_t g=0; g<LCD_CGRAM_SIZE / LCD_GLYPH_ROWS; g++) LCD_createChar(g, Lleno);
+		LCD_command(LCD_SETDDRAMADDR);
+		for (uint8_t i=0; i<LCD_DDRAM_CELLS; i++) LCD_write((uint8_t) ('a' + (i + d) % 26));
+		for (uint8_t i=0; i<LCD_DDRAM_CELLS / 4; i++) LCD_scrollDisplayLeft();
+	}
+	LCD_select(1);
+}
+
+static void consola(void) {
+	LCD_consoleInit(0, 0);
+	LCD_consolePrint("Hola\nterricolas");
+	for (uint8_t i=0; i<LCD_lines() * 4; i++) LCD_consolePut('\n');
+	LCD_consolePrint(Texto);
+	for (uint8_t i=0; i<LCD_lines(); i++) LCD_consolePut('\n');
+}
+
+static void anotar(void) {
+	for (uint8_t row=0; row<LCD_lines(); row++) LCD_servicePrint(0, row, Texto + row);
+}
+
+static void otro_display(void) {
+	if (LCD_displays() > 1) {
+		LCD_select(0x02);
+		LCD_command(LCD_SETDDRAMADDR);
+		for (uint8_t i=0; i<LCD_DDRAM_CELLS; i++) LCD_write((uint8_t) ('A' + i % 26));
+		LCD_select(1);
+	}
+}
+
+/*******************************************************************************
+* @brief  Peor caso de LCD_recover: el último display se reinició
+* @param  None
+* @retval None
+*/
+static void cortar(void) {
+	llenar();
+	LCD_simPowerCycle(LCD_displays() - 1);
+}
+
+/*******************************************************************************
+* @brief  Ningún glifo de la traducción cargado (la caché sobrevive a LCD_init)
+* @param  None
+* @retval None
+*/
+static void glifos(void) {
+	LCD_charset(LCD_ROM_A00);
+}
+
+/*******************************************************************************
+* @brief  Peor caso de LCD_fieldUpdate: todos los campos, del ancho máximo,
+*         con todo por enviar y cada uno en una fila distinta del anterior
+* @param  None
+* @retval None
+*/
+static void campos(void) {
+	LCD_fieldReset();
+	for (uint8_t i=0; i<LCD_FIELD_MAX; i++) {
+		LCD_field id = LCD_fieldAdd(0, i % LCD_lines(), LCD_FIELD_WIDTH, LCD_ALIGN_LEFT, NULL);
+		LCD_fieldText(id, Texto + i);
+	}
+}
+
+/*******************************************************************************
+* @brief  Peor caso de LCD_scrub: toda la DDRAM distinta de la sombra
+* @param  None
+* @retval None
+*/
+static void corromper(void) {
+	llenar();
+	uint8_t a = 0;
+	for (uint8_t n=0; n<LCD_DDRAM_CELLS; n++, a=LCD_nextAddress(a)) Sim.display[0].ddram[a] ^= 0x20;
+}
+
+/*******************************************************************************
+* @brief  Peor caso de LCD_sparkAdd: todos los caracteres llenos con barras,
+*         así la muestra siguiente rota y borra las 8 filas del más viejo
+* @param  None
+* @retval None
+*/
+static void grafico(void) {
+	LCD_sparkInit(&Grafico, 0, 0, 0, LCD_SPARK_MAX_WIDTH, 0, 7, true);
+	for (uint8_t i=0; i<LCD_SPARK_MAX_WIDTH * LCD_SPARK_GLYPH_COLS; i++) LCD_sparkAdd(&Grafico, 7);
+}
+
+/*******************************************************************************
+* @brief  Peor caso de LCD_sparkDraw: otro pisó la CGRAM y las celdas
+* @param  None
+* @retval None
+*/
+static void grafico_pisado(void) {
+	grafico();
+	pisar_cgram();
+	LCD_setCursor(0, 0);
+	for (uint8_t i=0; i<LCD_SPARK_MAX_WIDTH; i++) LCD_write('x');
+}
+
+static void pisar_cgram(void) {
+	for (uint8_t g=0; g<LCD_CGRAM_SIZE / LCD_GLYPH_ROWS; g++) LCD_createChar(g, Pisado);
+}
+
+static void animar(void) {
+	LCD_animStart(&Jugador, &Animacion);
+}
+
+/*******************************************************************************
+* @brief  Peor caso de LCD_queueService: un clear y textos largos encolados,
+*         y el cuadro completo distinto de lo que dejan
+* @param  None
+* @retval None
+*/
+static void encolar(void) {
+	LCD_queueInit();
+	LCD_queueCommand(LCD_CLEARDISPLAY);
+	for (uint8_t i=1; i<LCD_WCET_QUEUE_OPS; i++) LCD_queuePrint(0, i % LCD_lines(), Texto + i);
+	for (uint8_t row=0; row<LCD_lines(); row++) LCD_framePrint(0, row, Texto + LCD_WCET_QUEUE_OPS + row);
+}
+
+static void medir_printScreen(void) {
+	const char * Filas[LCD_MAX_LINES];
+	for (uint8_t row=0; row<LCD_MAX_LINES; row++) Filas[row] = Texto + LCD_MAX_LINES - row;
+	LCD_printScreen(Filas);
+}
+
+static void medir_planRun(void) {
+	const char * Filas[LCD_MAX_LINES];
+	LCDplan Plan = {.kind = LCD_PLAN_SCROLL, .scroll = LCD_PLAN_MAX_SCROLL};
+	for (uint8_t row=0; row<LCD_MAX_LINES; row++) Filas[row] = Texto + LCD_MAX_LINES - row;
+	LCD_planRun(Filas, &Plan);
+}
+
+static void medir_planUpdate(void) {
+	const char * Filas[LCD_MAX_LINES];
+	for (uint8_t row=0; row<LCD_MAX_LINES; row++) Filas[row] = Texto + LCD_MAX_LINES - row;
+	LCD_planUpdate(Filas, &LCD_plan_4bit);
+}
+
+/***************************************************************END OF FILE****/